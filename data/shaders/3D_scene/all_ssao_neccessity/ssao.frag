@@ -5,8 +5,8 @@ out float FragColor;
 
 in vec2 TexCoords;
 
-uniform sampler2D gPosition;
-uniform sampler2D gNormal;
+// depth of the forward pass, there is no g-buffer
+uniform sampler2D gDepth;
 uniform sampler2D texNoise;
 
 uniform vec3 samples[64];
@@ -16,16 +16,43 @@ int kernelSize = 64;
 float radius = 0.5;
 float bias = 0.025;
 
-// tile noise texture over screen based on screen dimensions divided by noise size
-const vec2 noiseScale = vec2(800.0/4.0, 600.0/4.0);
-
 uniform mat4 projection;
+uniform mat4 inverseProjection;
+
+// view space position of the depth under uv
+vec3 ViewPosition(vec2 uv)
+{
+    vec4 clip = vec4(vec3(uv, texture(gDepth, uv).r) * 2.0 - 1.0, 1.0);
+    vec4 view = inverseProjection * clip;
+    return view.xyz / view.w;
+}
+
+// face normal from the neighbours, on each axis the closest one so the silhouettes don't bend it
+vec3 ViewNormal(vec3 fragPos, vec2 texelSize)
+{
+    vec3 right = ViewPosition(TexCoords + vec2(texelSize.x, 0.0)) - fragPos;
+    vec3 left = fragPos - ViewPosition(TexCoords - vec2(texelSize.x, 0.0));
+    vec3 up = ViewPosition(TexCoords + vec2(0.0, texelSize.y)) - fragPos;
+    vec3 down = fragPos - ViewPosition(TexCoords - vec2(0.0, texelSize.y));
+    vec3 dx = abs(right.z) < abs(left.z) ? right : left;
+    vec3 dy = abs(up.z) < abs(down.z) ? up : down;
+    return normalize(cross(dx, dy));
+}
 
 void main()
 {
+    // nothing drawn there yet, the sky comes after
+    if (texture(gDepth, TexCoords).r >= 1.0)
+    {
+        FragColor = 1.0;
+        return;
+    }
     // get input for SSAO algorithm
-    vec3 fragPos = texture(gPosition, TexCoords).xyz;
-    vec3 normal = normalize(texture(gNormal, TexCoords).rgb);
+    vec2 texelSize = 1.0 / vec2(textureSize(gDepth, 0));
+    vec3 fragPos = ViewPosition(TexCoords);
+    vec3 normal = ViewNormal(fragPos, texelSize);
+    // tile noise texture over screen based on screen dimensions divided by noise size (follows the window size)
+    vec2 noiseScale = vec2(textureSize(gDepth, 0)) / vec2(textureSize(texNoise, 0));
     vec3 randomVec = normalize(texture(texNoise, TexCoords * noiseScale).xyz);
     // create TBN change-of-basis matrix: from tangent-space to view-space
     vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
@@ -46,7 +73,7 @@ void main()
         offset.xyz = offset.xyz * 0.5 + 0.5; // transform to range 0.0 - 1.0
 
         // get sample depth
-        float sampleDepth = texture(gPosition, offset.xy).z; // get depth value of kernel sample
+        float sampleDepth = ViewPosition(offset.xy).z; // get depth value of kernel sample
 
         // range check & accumulate
         float rangeCheck = smoothstep(0.0, 1.0, radius / abs(fragPos.z - sampleDepth));
@@ -1,5 +1,4 @@
-﻿#version 300 es
-precision highp float;
+﻿#version 450 core
 
 struct Material {
     vec3 ambient;
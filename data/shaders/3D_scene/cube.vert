@@ -1,12 +1,13 @@
-﻿#version 300 es
-precision highp float;
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
 
 //out vec3 ourColor;
 out vec2 texCoord;
 out vec3 normal;
 out vec3 FragPos;
 
-uniform mat4 model;
+#include "draw_instance.glsl"
+
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -143,6 +144,7 @@ vec3(0.0f,  1.0f,  0.0f)
 );
 
 void main() {
+    mat4 model = instances[instanceOffset + uint(gl_InstanceID)].model;
     gl_Position = projection * view * model * vec4(vertices[gl_VertexID], 1.0);
     //ourColor = colors[gl_VertexID];
     texCoord = position_of_the_texture[gl_VertexID];
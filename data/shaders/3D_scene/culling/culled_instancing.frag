@@ -0,0 +1,14 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+
+void main()
+{
+    FragColor = texture(texture_diffuse1, TexCoords);
+    Bright = vec4(0.0, 0.0, 0.0, 0.0);
+}
\ No newline at end of file
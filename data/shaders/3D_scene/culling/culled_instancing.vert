@@ -0,0 +1,29 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoords;
+
+#include "packed_instance.glsl"
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+layout (std430, binding = 1) readonly buffer VisibleInstances {
+    uint visibleInstances[];
+};
+
+out vec2 TexCoords;
+//the depth pre-pass uses the same shader, the color pass tests GL_EQUAL against its depth
+invariant gl_Position;
+
+uniform mat4 projection;
+uniform mat4 view;
+//start of the visible list of the view being drawn
+uniform uint visibleOffset;
+
+void main()
+{
+    mat4 model = InstanceMatrix(instances[visibleInstances[visibleOffset + uint(gl_InstanceID)]]);
+    TexCoords = aTexCoords;
+    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (location = 0) in vec3 aPos;
+
+#include "packed_instance.glsl"
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+layout (std430, binding = 1) readonly buffer VisibleInstances {
+    uint visibleInstances[];
+};
+
+uniform mat4 lightSpaceMatrix;
+uniform uint visibleOffset;
+
+void main()
+{
+    mat4 model = InstanceMatrix(instances[visibleInstances[visibleOffset + uint(gl_InstanceID)]]);
+    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+in vec2 TexCoords;
+
+#include "../material.glsl"
+
+//material of the mesh (or meshlet group) being drawn, set per indirect draw
+uniform uint material;
+
+void main()
+{
+    GpuMaterial gpuMaterial = materials[material];
+    // unlit : all of the color is ambient, alpha 1 lets the SSAO resolve occlude all of it
+    FragColor = vec4((gpuMaterial.baseColor * SampleMaterial(gpuMaterial.diffuse, TexCoords, vec4(1.0))).rgb, 1.0);
+    Bright = vec4(0.0, 0.0, 0.0, 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+﻿//IsOccluded of the compute shaders culling against the Hi-Z pyramid of gpr::HiZPyramid,
+//pulled in by #include "hi_z_occlusion.glsl" (resolved by gpr::LoadShader)
+
+uniform mat4 viewProjection;
+uniform sampler2D hiZ;
+uniform vec2 hiZSize;
+uniform int hiZLevels;
+
+//true when the box around the sphere is behind the depth stored in the pyramid
+bool IsOccluded(vec3 center, float radius)
+{
+    vec3 ndcMin = vec3(1.0);
+    vec3 ndcMax = vec3(-1.0);
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = center + radius * vec3((i & 1) == 0 ? -1.0 : 1.0,
+                                             (i & 2) == 0 ? -1.0 : 1.0,
+                                             (i & 4) == 0 ? -1.0 : 1.0);
+        vec4 clip = viewProjection * vec4(corner, 1.0);
+        //crosses the camera plane -> can't be projected, keep it
+        if (clip.w <= 0.0) {
+            return false;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
+
+    vec2 uvMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uvMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0);
+
+    //pixels of level 0 touched by the box
+    ivec2 pixelMin = min(ivec2(uvMin * hiZSize), ivec2(hiZSize) - 1);
+    ivec2 pixelMax = min(ivec2(uvMax * hiZSize), ivec2(hiZSize) - 1);
+
+    //the levels are not powers of two : the texel of level L above pixel p is min(p >> L, size - 1)
+    //(odd borders fold in the last texel), normalized coordinates would not land on it.
+    //n pixels span at most 2 texels of the level 2^L >= n, the 4 fetches then cover the box entirely
+    ivec2 pixelCount = pixelMax - pixelMin + 1;
+    int level = int(ceil(log2(float(max(pixelCount.x, pixelCount.y)))));
+    level = clamp(level, 0, hiZLevels - 1);
+    ivec2 lastTexel = textureSize(hiZ, level) - 1;
+    ivec2 texelMin = min(pixelMin >> level, lastTexel);
+    ivec2 texelMax = min(pixelMax >> level, lastTexel);
+
+    float farthest = max(max(texelFetch(hiZ, texelMin, level).r, texelFetch(hiZ, ivec2(texelMax.x, texelMin.y), level).r),
+                         max(texelFetch(hiZ, ivec2(texelMin.x, texelMax.y), level).r, texelFetch(hiZ, texelMax, level).r));
+    float nearest = ndcMin.z * 0.5 + 0.5;
+    return nearest > farthest;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+//one instance per visible meshlet, gl_VertexID is the corner inside the meshlet
+
+struct Meshlet {
+    vec4 sphere;
+    vec4 cone;
+    uint firstIndex;
+    uint triangleCount;
+    uint groupFirstMeshlet;
+    uint group;
+};
+
+//uv in the w components
+struct MeshletVertex {
+    vec4 positionU;
+    vec4 normalV;
+};
+
+#include "packed_instance.glsl"
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+layout (std430, binding = 8) readonly buffer Meshlets {
+    Meshlet meshlets[];
+};
+layout (std430, binding = 9) readonly buffer MeshletIndices {
+    uint meshletIndices[];
+};
+layout (std430, binding = 10) readonly buffer MeshletVertices {
+    MeshletVertex meshletVertices[];
+};
+layout (std430, binding = 11) readonly buffer VisiblePairs {
+    uvec2 visiblePairs[];
+};
+
+out vec2 TexCoords;
+//the depth pre-pass uses the same shader, the color pass tests GL_EQUAL against its depth
+invariant gl_Position;
+
+uniform mat4 projection;
+uniform mat4 view;
+//start of the list of the group being drawn
+uniform uint pairOffset;
+
+void main()
+{
+    uvec2 pair = visiblePairs[pairOffset + uint(gl_InstanceID)];
+    Meshlet meshlet = meshlets[pair.y];
+    uint corner = uint(gl_VertexID);
+    //the 3 corners of a missing triangle land on the same point, nothing is rasterized
+    if (corner >= meshlet.triangleCount * 3u) {
+        TexCoords = vec2(0.0);
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    MeshletVertex vertex = meshletVertices[meshletIndices[meshlet.firstIndex + corner]];
+    mat4 model = InstanceMatrix(instances[pair.x]);
+    TexCoords = vec2(vertex.positionU.w, vertex.normalV.w);
+    gl_Position = projection * view * model * vec4(vertex.positionU.xyz, 1.0);
+}
@@ -0,0 +1,24 @@
+﻿//Instance and InstanceMatrix of the shaders reading the instances of GpuInstanceCuller,
+//pulled in by #include "packed_instance.glsl" (resolved by gpr::LoadShader)
+
+//PackedInstance : position + uniform scale, rotation quaternion in 4 snorm16, material, LOD of last frame
+//std430, 32 bytes like sizeof(gpr::PackedInstance)
+struct Instance {
+    vec4 positionScale;
+    uvec4 packedData;
+};
+
+//translation * rotation * scale, same as gpr::UnpackInstance
+mat4 InstanceMatrix(Instance instance)
+{
+    vec4 q = normalize(vec4(unpackSnorm2x16(instance.packedData.x), unpackSnorm2x16(instance.packedData.y)));
+    vec3 q2 = q.xyz * 2.0;
+    vec3 diagonal = q.xyz * q2;
+    float xy = q.x * q2.y, xz = q.x * q2.z, yz = q.y * q2.z;
+    float wx = q.w * q2.x, wy = q.w * q2.y, wz = q.w * q2.z;
+    mat3 rotation = mat3(1.0 - diagonal.y - diagonal.z, xy + wz, xz - wy,
+                         xy - wz, 1.0 - diagonal.x - diagonal.z, yz + wx,
+                         xz + wy, yz - wx, 1.0 - diagonal.x - diagonal.y) * instance.positionScale.w;
+    return mat4(vec4(rotation[0], 0.0), vec4(rotation[1], 0.0), vec4(rotation[2], 0.0),
+                vec4(instance.positionScale.xyz, 1.0));
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+﻿//DrawInstances of the programs instanced by the render queue,
+//pulled in by #include "draw_instance.glsl" (resolved by gpr::LoadShader)
+
+//same layout as gpr::DrawInstance (std430)
+struct DrawInstance {
+    mat4 model;
+    vec4 data;
+    //x : material of the packet
+    uvec4 ids;
+};
+layout (std430, binding = 14) readonly buffer DrawInstances {
+    DrawInstance instances[];
+};
+
+//first instance of the draw in DrawInstances
+uniform uint instanceOffset;
\ No newline at end of file
@@ -0,0 +1,13 @@
+﻿#version 300 es
+precision highp float;
+
+//one triangle covering the screen, drawn with 3 vertices and no vertex buffer (gpr::Primitive::kFullScreenTriangle)
+//vertices (-1, -1) (3, -1) (-1, 3), the part outside the screen is clipped
+out vec2 TexCoords;
+
+void main()
+{
+    vec2 uv = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    TexCoords = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+in vec2 TexCoords;
+flat in vec4 AtlasRect;
+
+uniform sampler2D atlas;
+
+void main()
+{
+    //repeat inside the tile, the gradients of the unwrapped coordinates keep the mip selection continuous
+    vec2 coords = AtlasRect.xy + fract(TexCoords) * AtlasRect.zw;
+    vec4 color = textureGrad(atlas, coords, dFdx(TexCoords) * AtlasRect.zw, dFdy(TexCoords) * AtlasRect.zw);
+    if (color.a < 0.5) {
+        discard;
+    }
+    //unlit like the trees it replaces (culled_instancing.frag)
+    FragColor = vec4(color.rgb, 1.0);
+    Bright = vec4(0.0, 0.0, 0.0, 0.0);
+}
@@ -0,0 +1,20 @@
+﻿#version 450 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec4 aAtlasRect;
+
+out vec2 TexCoords;
+flat out vec4 AtlasRect;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+void main()
+{
+    //proxies are merged in world space, no model matrix
+    TexCoords = aTexCoords;
+    AtlasRect = aAtlasRect;
+    gl_Position = projection * view * vec4(aPos, 1.0);
+}
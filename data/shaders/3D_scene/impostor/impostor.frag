@@ -0,0 +1,26 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+in vec2 AtlasCoords;
+in vec4 ClipPosition;
+flat in vec4 ClipDepthAxis;
+
+uniform sampler2D albedoAtlas;
+uniform sampler2D depthAtlas;
+
+void main()
+{
+    vec4 albedo = texture(albedoAtlas, AtlasCoords);
+    if (albedo.a < 0.5) {
+        discard;
+    }
+    //put the fragment back on the baked surface so the card intersects the ground like the mesh
+    vec4 clip = ClipPosition + ClipDepthAxis * texture(depthAtlas, AtlasCoords).r;
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+
+    //unlit like the mesh levels (culled_instancing.frag)
+    FragColor = vec4(albedo.rgb, 1.0);
+    Bright = vec4(0.0, 0.0, 0.0, 0.0);
+}
@@ -0,0 +1,70 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+//corner of the card in [-1, 1]²
+layout (location = 0) in vec2 aCorner;
+
+#include "../culling/packed_instance.glsl"
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+layout (std430, binding = 1) readonly buffer VisibleInstances {
+    uint visibleInstances[];
+};
+
+out vec2 AtlasCoords;
+out vec4 ClipPosition;
+//clip space offset of one radius along the frame direction, the fragment moves along it by the baked depth
+flat out vec4 ClipDepthAxis;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec3 eye;
+//bounding sphere of the model (xyz center, w radius)
+uniform vec4 sphere;
+uniform int framesPerSide;
+//start of the impostor list of the view being drawn
+uniform uint visibleOffset;
+
+vec2 OctahedronEncode(vec3 direction)
+{
+    direction /= abs(direction.x) + abs(direction.y) + abs(direction.z);
+    vec2 point = direction.xy;
+    if (direction.z < 0.0) {
+        point = (1.0 - abs(direction.yx)) * vec2(direction.x >= 0.0 ? 1.0 : -1.0, direction.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return point;
+}
+
+//same as OctahedronDecode in octahedral_impostor.cpp
+vec3 OctahedronDecode(vec2 point)
+{
+    vec3 direction = vec3(point, 1.0 - abs(point.x) - abs(point.y));
+    if (direction.z < 0.0) {
+        direction.xy = (1.0 - abs(direction.yx)) * vec2(direction.x >= 0.0 ? 1.0 : -1.0, direction.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(direction);
+}
+
+void main()
+{
+    mat4 model = InstanceMatrix(instances[visibleInstances[visibleOffset + uint(gl_InstanceID)]]);
+
+    //frame baked the closest to the direction of the eye, in model space
+    vec3 localEye = vec3(inverse(model) * vec4(eye, 1.0));
+    vec2 point = OctahedronEncode(normalize(localEye - sphere.xyz));
+    ivec2 frame = clamp(ivec2((point * 0.5 + 0.5) * float(framesPerSide)), ivec2(0), ivec2(framesPerSide - 1));
+    vec3 frameDirection = OctahedronDecode((vec2(frame) + 0.5) / float(framesPerSide) * 2.0 - 1.0);
+
+    //basis of the lookAt used by the bake
+    vec3 upHint = abs(frameDirection.z) > 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(0.0, 0.0, 1.0);
+    vec3 right = normalize(cross(-frameDirection, upHint));
+    vec3 up = cross(right, -frameDirection);
+    vec3 localPosition = sphere.xyz + (right * aCorner.x + up * aCorner.y) * sphere.w;
+
+    AtlasCoords = (vec2(frame) + aCorner * 0.5 + 0.5) / float(framesPerSide);
+    mat4 modelViewProjection = projection * view * model;
+    ClipPosition = modelViewProjection * vec4(localPosition, 1.0);
+    ClipDepthAxis = modelViewProjection * vec4(frameDirection * sphere.w, 0.0);
+    gl_Position = ClipPosition;
+}
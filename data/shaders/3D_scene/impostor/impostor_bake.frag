@@ -0,0 +1,28 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 Albedo;
+layout (location = 1) out vec4 EncodedNormal;
+layout (location = 2) out float Depth;
+
+in vec3 LocalPosition;
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+//bounding sphere of the model (xyz center, w radius)
+uniform vec4 sphere;
+//direction the frame is seen from
+uniform vec3 frameDirection;
+
+void main()
+{
+    vec4 color = texture(texture_diffuse1, TexCoords);
+    if (color.a < 0.5) {
+        discard;
+    }
+    Albedo = vec4(color.rgb, 1.0);
+    vec3 normal = normalize(gl_FrontFacing ? Normal : -Normal);
+    EncodedNormal = vec4(normal * 0.5 + 0.5, 1.0);
+    //distance from the card plane toward the viewer, in radius units -> [-1, 1]
+    Depth = dot(LocalPosition - sphere.xyz, frameDirection) / sphere.w;
+}
@@ -0,0 +1,16 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 BrightColor;
+
+flat in vec3 LightColor;
+
+void main()
+{
+    FragColor = vec4(LightColor, 1.0);
+    float brightness = dot(FragColor.rgb, vec3(0.2126, 0.7152, 0.0722));
+    if(brightness > 1.0)
+    BrightColor = vec4(FragColor.rgb, 1.0);
+    else
+    BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+﻿#version 450 core
+
+layout (location = 0) in vec3 aPos;
+
+//one instance per light, same buffer as the clustered lighting (gpr::PointLight, color.w = scale of the cube)
+struct PointLight {
+    vec4 positionRadius;
+    vec4 color;
+};
+layout (std430, binding = 16) readonly buffer Lights {
+    PointLight lights[];
+};
+
+flat out vec3 LightColor;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+void main()
+{
+    PointLight light = lights[gl_InstanceID];
+    LightColor = light.color.rgb;
+    vec3 worldPos = light.positionRadius.xyz + aPos * light.color.w;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+﻿//material table and texture arrays of gpr::MaterialSystem, pulled in by #include "material.glsl"
+
+//same layout as gpr::GpuMaterial, the textures are array << 16 | layer
+struct GpuMaterial {
+    vec4 baseColor;
+    uint diffuse;
+    uint normal;
+    uint specular;
+    float shininess;
+};
+layout (std430, binding = 15) readonly buffer Materials {
+    GpuMaterial materials[];
+};
+//one array per format and size (MaterialSystem::kMaxTextureArrays)
+layout (binding = 8) uniform sampler2DArray materialArrays[8];
+
+const uint kNoTexture = 0xFFFFFFFFu;
+
+//the index of a sampler array has to be constant, the material can change in the draw
+vec4 SampleMaterial(uint ref, vec2 uv, vec4 fallback)
+{
+    if (ref == kNoTexture) {
+        return fallback;
+    }
+    vec3 coords = vec3(uv, float(ref & 0xFFFFu));
+    switch (ref >> 16) {
+        case 0u: return texture(materialArrays[0], coords);
+        case 1u: return texture(materialArrays[1], coords);
+        case 2u: return texture(materialArrays[2], coords);
+        case 3u: return texture(materialArrays[3], coords);
+        case 4u: return texture(materialArrays[4], coords);
+        case 5u: return texture(materialArrays[5], coords);
+        case 6u: return texture(materialArrays[6], coords);
+        default: return texture(materialArrays[7], coords);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+in vec2 TexCoords;
+flat in uint Material;
+
+#include "material.glsl"
+
+void main()
+{
+    GpuMaterial material = materials[Material];
+    // unlit : all of the color is ambient, alpha 1 lets the SSAO resolve occlude all of it
+    FragColor = vec4((material.baseColor * SampleMaterial(material.diffuse, TexCoords, vec4(1.0))).rgb, 1.0);
+    Bright = vec4(0.0);
+}
\ No newline at end of file
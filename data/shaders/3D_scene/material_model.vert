@@ -0,0 +1,21 @@
+﻿#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoords;
+
+#include "draw_instance.glsl"
+
+out vec2 TexCoords;
+flat out uint Material;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    DrawInstance instance = instances[instanceOffset + uint(gl_InstanceID)];
+    TexCoords = aTexCoords;
+    Material = instance.ids.x;
+    gl_Position = projection * view * instance.model * vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+﻿#version 450 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Bright;
+
+//all in
+in vec3 FragPos;
+in vec2 TexCoords;
+in mat3 TBN;
+in float ViewDepth;
+
+//same layout as gpr::PointLight
+struct PointLight {
+    vec4 positionRadius;
+    vec4 color;
+};
+layout (std430, binding = 16) readonly buffer Lights {
+    PointLight lights[];
+};
+layout (std430, binding = 17) readonly buffer ClusterCounts {
+    uint clusterCounts[];
+};
+layout (std430, binding = 18) readonly buffer ClusterLights {
+    uint clusterLights[];
+};
+
+//all uniforms
+uniform sampler2D diffuseMap;
+uniform sampler2D normalMap;
+uniform vec3 viewPos;
+uniform float lightLinear;
+uniform float lightQuadratic;
+
+//grid of gpr::LightClusters
+uniform uvec3 clusterGrid;
+uniform uint maxClusterLights;
+uniform vec2 clusterTileSize;
+uniform vec2 clusterSliceScaleBias;
+
+//same indexing as light_cluster_cull.comp
+uint ClusterIndex(vec2 fragCoord, float viewDepth)
+{
+    uvec2 tile = min(uvec2(fragCoord / clusterTileSize), clusterGrid.xy - 1u);
+    float slice = log(viewDepth) * clusterSliceScaleBias.x + clusterSliceScaleBias.y;
+    uint z = uint(clamp(slice, 0.0, float(clusterGrid.z - 1u)));
+    return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * z);
+}
+
+void main()
+{
+    // obtain normal from normal map in range [0,1], transform it to [-1,1] then to world space
+    vec3 normal = texture(normalMap, TexCoords).rgb;
+    normal = normalize(TBN * normalize(normal * 2.0 - 1.0));
+
+    // get diffuse color
+    vec3 color = texture(diffuseMap, TexCoords).rgb;
+    // ambient
+    vec3 ambient = 0.1 * color;
+    vec3 lighting = ambient;
+    vec3 viewDir = normalize(viewPos - FragPos);
+
+    // only the lights of the cluster of the fragment
+    uint cluster = ClusterIndex(gl_FragCoord.xy, ViewDepth);
+    uint count = clusterCounts[cluster];
+    for (uint i = 0u; i < count; i++) {
+        PointLight light = lights[clusterLights[cluster * maxClusterLights + i]];
+        vec3 toLight = light.positionRadius.xyz - FragPos;
+        float distance = length(toLight);
+        vec3 lightDir = toLight / max(distance, 0.0001);
+        // attenuation, windowed so the light really ends at its radius (the clusters it was culled from)
+        float window = clamp(1.0 - pow(distance / light.positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (1.0 + lightLinear * distance + lightQuadratic * distance * distance);
+        // diffuse
+        float diff = max(dot(lightDir, normal), 0.0);
+        // specular
+        vec3 halfwayDir = normalize(lightDir + viewDir);
+        float spec = pow(max(dot(normal, halfwayDir), 0.0), 32.0);
+        lighting += (diff * color + vec3(0.2) * spec) * light.color.rgb * attenuation;
+    }
+
+    // Apply gamma correction
+    float gamma = 2.2;
+    vec3 finalColor = pow(lighting, vec3(1.0 / gamma));
+    vec3 directColor = pow(lighting - ambient, vec3(1.0 / gamma));
+    float ambientShare = 1.0 - dot(directColor, vec3(1.0)) / max(dot(finalColor, vec3(1.0)), 0.0001);
+
+    // alpha : share of the ambient in the color, the SSAO resolve only occludes that share
+    FragColor = vec4(finalColor, clamp(ambientShare, 0.0, 1.0));
+    Bright = vec4(0.0);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_BENCHMARK_TOOLS_H
+#define SAMPLES_OPENGL_BENCHMARK_TOOLS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+
+//timing and printing of the console benchmarks (main/*_benchmark.cpp)
+namespace tools
+{
+    //best time of the repetitions in milliseconds, result is what run returned (to check the methods agree)
+    inline double Measure(int repetitions, const std::function<std::size_t()> &run, std::size_t &result)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < repetitions; i++) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            result = run();
+            const auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    //one line of the table, with the objects per second when count is given and a label after the result
+    inline void PrintResult(std::string_view name, double milliseconds, std::size_t result, std::size_t count = 0,
+                            std::string_view label = {})
+    {
+        std::cout << std::setw(28) << std::left << name
+                  << std::setw(12) << std::right << std::fixed << std::setprecision(3) << milliseconds << " ms";
+        if (count > 0) {
+            const double objects_per_second = static_cast<double>(count) / (milliseconds / 1000.0);
+            std::cout << std::setw(12) << std::setprecision(1) << objects_per_second / 1'000'000.0 << " M/s";
+        }
+        std::cout << std::setw(12) << result;
+        if (!label.empty()) {
+            std::cout << " " << label;
+        }
+        std::cout << "\n";
+    }
+}
+
+#endif //SAMPLES_OPENGL_BENCHMARK_TOOLS_H
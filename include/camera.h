@@ -8,6 +8,8 @@
 #include <glm/glm.hpp>
 
 #include <array>
+#include <cmath>
+#include <initializer_list>
 
 #include "volumes.h"
 
@@ -102,53 +104,81 @@ public:
         bottomFace = {cam.position_, glm::cross(frontMultFar + cam.camera_up_ * halfVSide, cam.right_axis_)};
     }
 
+    /**
+     * Extract the 6 planes from a (projection * view) matrix (Gribb/Hartmann), works for perspective and ortho
+     * @param viewProjection -> projection * view of the camera or of the light
+     */
+    void CreateFrustumFromMatrix(const glm::mat4 &viewProjection) {
+        const auto row = [&viewProjection](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+        const auto toPlane = [](const glm::vec4 &equation) {
+            const float length = glm::length(glm::vec3(equation));
+            Plane plane;
+            plane.normal = glm::vec3(equation) / length;
+            plane.distance = -equation.w / length;
+            return plane;
+        };
 
-    [[nodiscard]] bool IsSphereInFrustum(const Sphere &sphere) const {
-        //for each plan
-        std::array<Plane, 6> allPlanes = {topFace, bottomFace, rightFace, leftFace, nearFace, farFace};
+        leftFace = toPlane(row(3) + row(0));
+        rightFace = toPlane(row(3) - row(0));
+        bottomFace = toPlane(row(3) + row(1));
+        topFace = toPlane(row(3) - row(1));
+        nearFace = toPlane(row(3) + row(2));
+        farFace = toPlane(row(3) - row(2));
+    }
+
+    //planes packed as (normal, distance), same order as the culling shaders expect
+    [[nodiscard]] std::array<glm::vec4, 6> PackedPlanes() const {
+        return {glm::vec4(topFace.normal, topFace.distance), glm::vec4(bottomFace.normal, bottomFace.distance),
+                glm::vec4(rightFace.normal, rightFace.distance), glm::vec4(leftFace.normal, leftFace.distance),
+                glm::vec4(nearFace.normal, nearFace.distance), glm::vec4(farFace.normal, farFace.distance)};
+    }
 
 
-        for (const auto &plane: allPlanes) {
+    [[nodiscard]] bool IsSphereInFrustum(const Sphere &sphere) const {
+        //for each plan (pointers -> the planes are not copied for every test)
+        for (const Plane *plane: {&topFace, &bottomFace, &rightFace, &leftFace, &nearFace, &farFace}) {
             //calculation of the distance between center of the circle and plane
-            float distance = plane.GetSignedDistanceToPlaneFromACircle(sphere);
+            float distance = plane->GetSignedDistanceToPlaneFromACircle(sphere);
 
             //if the sphere is outside a plan, she is out
-
             if (distance < -sphere.radius()) {
                 return false;
             }
         }
         return true;
     }
-    [[nodiscard]] bool IsCubeInFrustum(const glm::vec3 &center, float halfSize) const {
-        //these are the vertices equivalent to the halfSize of each part of the cube using its center and a half size
-        glm::vec3 vertices[8] = {
-                center + glm::vec3(-halfSize, -halfSize, -halfSize),
-                center + glm::vec3(-halfSize, -halfSize,  halfSize),
-                center + glm::vec3(-halfSize,  halfSize, -halfSize),
-                center + glm::vec3(-halfSize,  halfSize,  halfSize),
-                center + glm::vec3( halfSize, -halfSize, -halfSize),
-                center + glm::vec3( halfSize, -halfSize,  halfSize),
-                center + glm::vec3( halfSize,  halfSize, -halfSize),
-                center + glm::vec3( halfSize,  halfSize,  halfSize)
-        };
 
-        // Parcourir les 6 plans du frustum
-        const Plane planes[] = {topFace, bottomFace, rightFace, leftFace, nearFace, farFace};
-        for (const auto &plane : planes) {
-            bool allOutside = true;
-
-            // Vérifier si tous les sommets du cube sont derrière ce plan
-            for (const auto &vertex : vertices) {
-                float distance = glm::dot(plane.normal, vertex) - plane.distance;
-                if (distance >= 0) {
-                    allOutside = false;
-                    break; // Au moins un sommet est devant ce plan
-                }
+    //p-vertex test with the real extents of the box
+    [[nodiscard]] bool IsAabbInFrustum(const AABB &box) const {
+        const glm::vec3 center = box.center();
+        const glm::vec3 extents = box.extents();
+        for (const Plane *plane: {&topFace, &bottomFace, &rightFace, &leftFace, &nearFace, &farFace}) {
+            const float reach = glm::dot(extents, glm::abs(plane->normal));
+            if (glm::dot(plane->normal, center) - plane->distance < -reach) {
+                return false;
             }
+        }
+        return true;
+    }
 
-            // Si tous les sommets sont derrière ce plan, le cube est hors du frustum
-            if (allOutside) {
+    [[nodiscard]] bool IsObbInFrustum(const OBB &box) const {
+        for (const Plane *plane: {&topFace, &bottomFace, &rightFace, &leftFace, &nearFace, &farFace}) {
+            if (glm::dot(plane->normal, box.center) - plane->distance < -box.ProjectedRadius(plane->normal)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool IsCubeInFrustum(const glm::vec3 &center, float halfSize) const {
+        //p-vertex test : the corner the farthest along the normal is halfSize * (|nx| + |ny| + |nz|) above the center,
+        //if even this one is behind a plane, the whole cube is out (same result as testing the 8 corners)
+        for (const Plane *plane: {&topFace, &bottomFace, &rightFace, &leftFace, &nearFace, &farFace}) {
+            const float reach = halfSize * (std::abs(plane->normal.x) + std::abs(plane->normal.y) +
+                                            std::abs(plane->normal.z));
+            if (glm::dot(plane->normal, center) - plane->distance < -reach) {
                 return false;
             }
         }
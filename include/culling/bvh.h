@@ -0,0 +1,81 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_BVH_H
+#define SAMPLES_OPENGL_BVH_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "camera.h"
+#include "volumes.h"
+
+namespace gpr {
+
+    struct Ray {
+        glm::vec3 origin{0.f, 0.f, 0.f};
+        glm::vec3 direction{0.f, 0.f, -1.f};
+    };
+
+    /**
+     * Bounding volume hierarchy over static boxes (trees, rocks...), built once with the surface area heuristic.
+     * Nodes are flattened depth first in one array : the left child follows its parent, the right child index is stored,
+     * and every subtree covers a contiguous range of the sorted indices so a subtree fully inside the frustum
+     * is accepted without visiting its children.
+     */
+    class Bvh {
+    public:
+        static constexpr std::uint32_t kMaxLeafSize = 4;
+        static constexpr int kBinCount = 12;
+
+        //32 bytes, two nodes per cache line
+        struct Node {
+            glm::vec3 min{};
+            std::uint32_t first_or_right = 0; //leaf : first sorted index, interior : right child
+            glm::vec3 max{};
+            std::uint32_t count = 0;          //primitives under the node, high bit set on leaves
+
+            [[nodiscard]] bool is_leaf() const { return (count & kLeafFlag) != 0; }
+            [[nodiscard]] std::uint32_t primitive_count() const { return count & ~kLeafFlag; }
+        };
+
+        void Build(std::span<const AABB> boxes);
+
+        //indices of the boxes touching the frustum, appended to visible
+        void CullFrustum(const Frustum &frustum, std::vector<std::uint32_t> &visible) const;
+
+        //closest box hit by the ray before max_distance, false if none
+        bool Raycast(const Ray &ray, float max_distance, std::uint32_t &hit_index, float &hit_distance) const;
+
+        //indices of the boxes overlapping the box, appended to result
+        void QueryBox(const AABB &box, std::vector<std::uint32_t> &result) const;
+
+        [[nodiscard]] bool empty() const { return nodes_.empty(); }
+        [[nodiscard]] std::size_t node_count() const { return nodes_.size(); }
+        [[nodiscard]] const AABB &box(std::uint32_t index) const { return boxes_[index]; }
+        //nodes touched by the last query, to compare with the brute force count
+        [[nodiscard]] std::size_t nodes_visited() const { return nodes_visited_; }
+
+    private:
+        static constexpr std::uint32_t kLeafFlag = 0x80000000u;
+        static constexpr int kStackSize = 64;
+
+        std::uint32_t BuildNode(std::uint32_t first, std::uint32_t count, int depth);
+        //sorted index range of a subtree, starts at its leftmost leaf
+        [[nodiscard]] std::uint32_t FirstIndex(std::uint32_t node) const;
+
+        std::vector<Node> nodes_{};
+        std::vector<std::uint32_t> indices_{};
+        std::vector<AABB> boxes_{};
+        std::vector<glm::vec3> centroids_{};
+        //statistic only, the queries stay const
+        mutable std::size_t nodes_visited_ = 0;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_BVH_H
@@ -0,0 +1,73 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_FRUSTUM_BATCH_H
+#define SAMPLES_OPENGL_FRUSTUM_BATCH_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "camera.h"
+
+namespace gpr {
+
+    enum class SimdLevel {
+        kScalar,
+        kSse,
+        kAvx2
+    };
+
+    //best instruction set supported by the CPU running the program (detected once)
+    [[nodiscard]] SimdLevel BestSimdLevel();
+
+    [[nodiscard]] const char *SimdLevelName(SimdLevel level);
+
+    //bounding spheres as structure of arrays, every span has the same size
+    struct SphereBatch {
+        std::span<const float> center_x, center_y, center_z, radius;
+
+        [[nodiscard]] std::size_t size() const { return radius.size(); }
+    };
+
+    //axis aligned boxes as structure of arrays, every span has the same size
+    struct AabbBatch {
+        std::span<const float> center_x, center_y, center_z;
+        std::span<const float> extent_x, extent_y, extent_z;
+
+        [[nodiscard]] std::size_t size() const { return center_x.size(); }
+    };
+
+    /**
+     * Frustum test of many objects at once (SSE -> 4, AVX2 -> 8 objects per instruction).
+     * The result is a bitmask : bit (i % 64) of word (i / 64) is set when object i is at least partially inside.
+     * Boxes use the p-vertex test : only the corner farthest along the plane normal is checked.
+     * Big batches are split by words of 64 objects across the WorkerPool.
+     */
+    class FrustumBatchCuller {
+    public:
+        static constexpr std::size_t kParallelThreshold = 32768;
+
+        explicit FrustumBatchCuller(SimdLevel level = BestSimdLevel());
+
+        void CullSpheres(const Frustum &frustum, const SphereBatch &spheres, std::vector<std::uint64_t> &mask) const;
+
+        void CullAabbs(const Frustum &frustum, const AabbBatch &boxes, std::vector<std::uint64_t> &mask) const;
+
+        //index of every set bit of the mask, returns the number of visible objects
+        static std::size_t CompactVisible(std::span<const std::uint64_t> mask, std::size_t count,
+                                          std::vector<std::uint32_t> &indices);
+
+        void set_multithreaded(bool multithreaded) { multithreaded_ = multithreaded; }
+
+        [[nodiscard]] SimdLevel level() const { return level_; }
+
+    private:
+        SimdLevel level_;
+        bool multithreaded_ = true;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_FRUSTUM_BATCH_H
@@ -0,0 +1,183 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_GPU_CULLING_H
+#define SAMPLES_OPENGL_GPU_CULLING_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "camera.h"
+#include "culling/hi_z_pyramid.h"
+#include "culling/packed_instance.h"
+#include "load3D/octahedral_impostor.h"
+#include "load3D/texture_loader.h"
+#include "open_gl_data_structure/compute_program.h"
+#include "open_gl_data_structure/readback_buffer.h"
+#include "open_gl_data_structure/streaming_buffer.h"
+
+namespace gpr {
+
+    //layout imposed by glDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint count = 0;
+        GLuint instanceCount = 0;
+        GLuint firstIndex = 0;
+        GLint baseVertex = 0;
+        GLuint baseInstance = 0;
+    };
+
+    /**
+     * Per-instance frustum culling done on the GPU.
+     * A compute pass tests the bounding sphere of every instance against the frustum of a view,
+     * writes the index of the survivors in a compacted list and the instance count of the indirect draw commands.
+     * Each view (camera, shadow...) has its own visible list and its own commands so they can all be culled in the same frame.
+     *
+     * Occlusion is done in two phases so nothing pops when it is uncovered :
+     * 1. CullPreviouslyVisible -> draw what was visible last frame (and passes the frustum), this fills the depth.
+     * 2. the depth is reduced in a HiZPyramid, CullOcclusion tests every instance against it,
+     *    remembers the result for the next frame and lists the instances that were missed by the first phase.
+     * Only the sphere of the whole instance is tested : the meshes of a level share its visible list, which the
+     * MeshletCuller expands for LOD 0 and tests at a finer grain (meshlets, Hi-Z included) than the submeshes would.
+     *
+     * When the model has LOD (Model::CreateLods) every instance also picks a level from its projected size,
+     * with the hysteresis of gpr::SelectLod kept in the instance (PackedInstance::lod), and is appended to the list of that level :
+     * each level has its own commands and visible list, so the levels are separate indirect draws.
+     * With an OctahedralImpostor the level after the last mesh LOD is the impostor card (one command of 6 indices),
+     * Draw only covers the mesh levels and DrawImpostors the last one.
+     *
+     * The matrices are uploaded as PackedInstance (32 bytes), the shaders expand them with InstanceMatrix.
+     *
+     * Binding points used by the shaders :
+     * 0 -> instances, 1 -> visible instances, 2 -> indirect commands, 3 -> last visibility, 4 -> stats,
+     * 5 -> cluster of each instance, 6 -> clusters drawn by their HLOD proxy
+     */
+    class GpuInstanceCuller {
+    public:
+        static constexpr GLuint kInstancesBinding = 0;
+        static constexpr GLuint kVisibleBinding = 1;
+        static constexpr GLuint kCommandsBinding = 2;
+        static constexpr GLuint kVisibilityBinding = 3;
+        static constexpr GLuint kStatsBinding = 4;
+        static constexpr GLuint kInstanceClustersBinding = 5;
+        static constexpr GLuint kProxiedClustersBinding = 6;
+
+        //mesh levels + the impostor
+        static constexpr std::size_t kMaxLevelCount = kMaxLodCount + 1;
+
+        //pack and upload the matrices (uniform scale only),
+        //build one command per mesh of each LOD per view (+ one for the impostor)
+        void Create(const std::vector<glm::mat4> &instance_matrices, const Model &model, GLuint view_count,
+                    const OctahedralImpostor *impostor = nullptr);
+
+        //point the LOD selection is made from, every view uses it so the shadows match what the camera draws
+        void SetLodCamera(const glm::vec3 &eye, const glm::mat4 &projection);
+
+        //run the compute pass for one view
+        void Cull(const Frustum &frustum, GLuint view);
+
+        //first occlusion phase : only the instances that were visible at the end of the last frame
+        void CullPreviouslyVisible(const Frustum &frustum, GLuint view);
+
+        //second occlusion phase : test against the pyramid, view receives the instances newly visible
+        void CullOcclusion(const Frustum &frustum, const glm::mat4 &view_projection, const HiZPyramid &hi_z,
+                           GLuint view);
+
+        //cluster of each instance (HlodClusters::instance_clusters), needed before UploadProxiedClusters
+        void SetInstanceClusters(std::span<const GLuint> instance_clusters, GLuint cluster_count);
+
+        //1 for the clusters replaced by their proxy, their instances are skipped by every view
+        void UploadProxiedClusters(std::span<const GLuint> proxied);
+
+        //replace the visibility used by CullPreviouslyVisible (e.g. computed by the SoftwareOcclusionCuller), 1 = visible
+        //written in the frame partition of stream then copied GPU-side, between its BeginFrame and EndFrame
+        void UploadVisibility(std::span<const GLuint> visibility, StreamingBuffer &stream);
+
+        //draw every mesh of every LOD with only the visible instances of the view, program must already be in use
+        //(its uniform material, if any, gets Mesh::material_)
+        //first_lod = 1 leaves LOD 0 to the MeshletCuller
+        void Draw(const Model &model, GLuint program, GLuint view, GLuint first_lod = 0) const;
+
+        //draw the cards of the instances past the last mesh LOD, nothing if Create had no impostor
+        void DrawImpostors(const OctahedralImpostor &impostor, const glm::mat4 &view_matrix,
+                           const glm::mat4 &projection, const glm::vec3 &eye, GLuint view) const;
+
+        void Delete();
+
+        [[nodiscard]] GLuint instance_count() const { return instance_count_; }
+
+        //buffers and offsets read by the passes working on the culling result (MeshletCuller)
+        [[nodiscard]] GLuint instances_buffer() const { return instances_ssbo_; }
+        [[nodiscard]] GLuint visible_buffer() const { return visible_ssbo_; }
+        [[nodiscard]] GLuint commands_buffer() const { return commands_buffer_; }
+        //first element of the visible list of a level
+        [[nodiscard]] GLuint visible_offset(GLuint view, GLuint lod) const {
+            return (view * lod_count_ + lod) * instance_count_;
+        }
+        //first command of a level, its instanceCount is the size of the visible list
+        [[nodiscard]] GLuint command_index(GLuint view, GLuint lod) const {
+            return view * commands_per_view_ + lod_first_command_[lod];
+        }
+
+        //percentage of the instances inside the frustum rejected by the Hi-Z test (a few frames late, no stall)
+        [[nodiscard]] float occlusion_culled_percent() const { return occlusion_culled_percent_; }
+
+    private:
+        enum class CullPhase : GLint {
+            kFrustum = 0,
+            kPreviouslyVisible = 1,
+            kOcclusion = 2
+        };
+
+        //counters written by the occlusion phase
+        struct CullStats {
+            GLuint frustum_visible = 0;
+            GLuint occluded = 0;
+        };
+
+        ComputeProgram cull_program_{};
+        GLuint instances_ssbo_ = 0;
+        GLuint visible_ssbo_ = 0;
+        GLuint commands_buffer_ = 0;
+        GLuint visibility_ssbo_ = 0;
+        ReadbackBuffer stats_{};
+        GLuint instance_clusters_ssbo_ = 0;
+        GLuint proxied_clusters_ssbo_ = 0;
+        //0 -> no HLOD, every instance is culled
+        GLuint cluster_count_ = 0;
+        float occlusion_culled_percent_ = 0.0f;
+
+        GLuint instance_count_ = 0;
+        GLuint view_count_ = 0;
+
+        //commands of a view : the meshes of LOD 0, then the meshes of LOD 1... then the impostor
+        GLuint commands_per_view_ = 0;
+        //every level, the impostor included
+        GLuint lod_count_ = 1;
+        GLuint mesh_lod_count_ = 1;
+        bool has_impostor_ = false;
+        std::array<GLuint, kMaxLevelCount> lod_first_command_{};
+        std::array<GLuint, kMaxLevelCount> lod_mesh_count_{};
+        std::array<float, kMaxLevelCount - 1> lod_screen_sizes_{};
+        glm::vec3 lod_eye_{0.0f};
+        //0 until SetLodCamera, the shader then keeps LOD 0
+        float lod_projection_scale_ = 0.0f;
+
+        //bounding sphere of the model in its local space (xyz center, w radius)
+        glm::vec4 local_sphere_{0.0f};
+
+        //commands with instanceCount = 0, uploaded before each cull to reset the counters
+        std::vector<DrawElementsIndirectCommand> reset_commands_{};
+
+        //reset the commands of the view, set the shared uniforms and launch the pass
+        void Dispatch(const Frustum &frustum, GLuint view, CullPhase phase);
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_GPU_CULLING_H
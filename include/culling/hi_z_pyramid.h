@@ -0,0 +1,45 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_HI_Z_PYRAMID_H
+#define SAMPLES_OPENGL_HI_Z_PYRAMID_H
+
+#include <GL/glew.h>
+
+#include "open_gl_data_structure/compute_program.h"
+
+namespace gpr {
+
+    /**
+     * Hierarchical depth buffer : mip chain of a depth texture where each texel keeps the farthest depth of the 2x2
+     * (or 3x3 on odd borders) texels below it. A box whose nearest depth is behind the stored value is hidden.
+     */
+    class HiZPyramid {
+    public:
+        void Create(GLsizei width, GLsizei height);
+
+        //new texture for a depth buffer of another size, the content is lost until the next Build
+        void Resize(GLsizei width, GLsizei height);
+
+        //copy the depth texture in level 0 then reduce every level, depth must not be written during the build
+        void Build(GLuint depth_texture);
+
+        void Delete();
+
+        [[nodiscard]] GLuint texture() const { return texture_; }
+        [[nodiscard]] GLsizei width() const { return width_; }
+        [[nodiscard]] GLsizei height() const { return height_; }
+        [[nodiscard]] GLint level_count() const { return level_count_; }
+
+    private:
+        ComputeProgram downsample_program_{};
+        GLuint texture_ = 0;
+        GLsizei width_ = 0;
+        GLsizei height_ = 0;
+        GLint level_count_ = 0;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_HI_Z_PYRAMID_H
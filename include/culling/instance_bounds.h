@@ -0,0 +1,45 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_INSTANCE_BOUNDS_H
+#define SAMPLES_OPENGL_INSTANCE_BOUNDS_H
+
+#include <glm/glm.hpp>
+
+#include <span>
+#include <vector>
+
+#include "culling/frustum_batch.h"
+#include "volumes.h"
+
+namespace gpr {
+
+    /**
+     * World boxes of every instance of a model, as structure of arrays so they go straight to the batch kernels.
+     * Refit transforms the local box of the model by each instance matrix (Arvo), 4 instances at a time with SSE.
+     */
+    class InstanceBounds {
+    public:
+        //recompute every box, call again when the matrices change
+        void Refit(const AABB &local, std::span<const glm::mat4> matrices);
+
+        [[nodiscard]] std::size_t size() const { return center_x_.size(); }
+
+        [[nodiscard]] AABB box(std::size_t index) const {
+            return AABB::FromCenterExtents(glm::vec3(center_x_[index], center_y_[index], center_z_[index]),
+                                           glm::vec3(extent_x_[index], extent_y_[index], extent_z_[index]));
+        }
+
+        [[nodiscard]] AabbBatch batch() const {
+            return {center_x_, center_y_, center_z_, extent_x_, extent_y_, extent_z_};
+        }
+
+    private:
+        std::vector<float> center_x_{}, center_y_{}, center_z_{};
+        std::vector<float> extent_x_{}, extent_y_{}, extent_z_{};
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_INSTANCE_BOUNDS_H
@@ -0,0 +1,98 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_LIGHT_CLUSTERS_H
+#define SAMPLES_OPENGL_LIGHT_CLUSTERS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <span>
+
+#include "open_gl_data_structure/compute_program.h"
+#include "open_gl_data_structure/readback_buffer.h"
+
+namespace gpr {
+
+    //same layout as PointLight in the shaders (std430)
+    struct PointLight {
+        //world position, the light reaches 0 at the radius
+        glm::vec4 position_radius{};
+        //w : scale of the light cube drawn at the light (the emissive proxy)
+        glm::vec4 color{};
+    };
+
+    /**
+     * Clustered light culling : the view frustum is cut in kClustersX x kClustersY screen tiles
+     * and kClustersZ depth slices (exponential, so the clusters stay close to cubes), every frame a compute pass
+     * tests the spheres of the lights against the box of each cluster and writes the list of the lights touching it.
+     * A shaded fragment finds its cluster from gl_FragCoord and its view depth (ClusterIndex in the shaders)
+     * and only loops over that list : the cost follows the lights per pixel, not the lights of the scene.
+     *
+     * A cluster keeps at most kMaxLightsPerCluster lights, the others are counted as overflow in the stats.
+     * Binding points (for the shaders shading with the lights) :
+     * 16 -> lights (also read by the instanced light cubes), 17 -> light count of each cluster, 18 -> light lists,
+     * 19 -> stats
+     */
+    class LightClusters {
+    public:
+        static constexpr GLuint kLightsBinding = 16;
+        static constexpr GLuint kClusterCountsBinding = 17;
+        static constexpr GLuint kClusterLightsBinding = 18;
+        static constexpr GLuint kStatsBinding = 19;
+
+        static constexpr GLuint kClustersX = 16;
+        static constexpr GLuint kClustersY = 9;
+        static constexpr GLuint kClustersZ = 24;
+        static constexpr GLuint kClusterCount = kClustersX * kClustersY * kClustersZ;
+        static constexpr GLuint kMaxLightsPerCluster = 64;
+
+        void Create(GLuint max_lights);
+
+        //replace the lights (at most the max_lights of Create), only needed when they change
+        void UploadLights(std::span<const PointLight> lights);
+
+        //build the light lists for this camera, projection must be a symmetric perspective
+        void Cull(const glm::mat4 &view, const glm::mat4 &projection, float z_near, float z_far, GLsizei width,
+                  GLsizei height);
+
+        //bind the lists and give the program the grid used by ClusterIndex, after Cull
+        void Bind(GLuint program) const;
+
+        void Delete();
+
+        [[nodiscard]] GLuint light_count() const { return light_count_; }
+        [[nodiscard]] GLuint lights_buffer() const { return lights_ssbo_; }
+
+        //a few frames late (no stall) : average lights in the clusters touched, the most in one, clusters full
+        [[nodiscard]] float average_cluster_lights() const;
+        [[nodiscard]] GLuint max_cluster_lights() const { return stats_.max_lights; }
+        [[nodiscard]] GLuint overflowed_clusters() const { return stats_.overflowed; }
+
+    private:
+        //counters written by the cull pass, reset each frame
+        struct ClusterStats {
+            GLuint assigned = 0;
+            GLuint lit_clusters = 0;
+            GLuint max_lights = 0;
+            GLuint overflowed = 0;
+        };
+
+        ComputeProgram cull_program_{};
+        GLuint lights_ssbo_ = 0;
+        GLuint counts_ssbo_ = 0;
+        GLuint cluster_lights_ssbo_ = 0;
+        ReadbackBuffer stats_buffer_{};
+        ClusterStats stats_{};
+        GLuint max_lights_ = 0;
+        GLuint light_count_ = 0;
+
+        //lookup of the last Cull : pixels per tile, slice = log(view depth) * scale + bias
+        glm::vec2 tile_size_{1.0f};
+        glm::vec2 slice_scale_bias_{0.0f};
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_LIGHT_CLUSTERS_H
@@ -0,0 +1,132 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_MESHLET_CULLING_H
+#define SAMPLES_OPENGL_MESHLET_CULLING_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "camera.h"
+#include "culling/gpu_culling.h"
+#include "culling/hi_z_pyramid.h"
+#include "load3D/meshlet.h"
+#include "load3D/texture_loader.h"
+#include "open_gl_data_structure/compute_program.h"
+#include "open_gl_data_structure/readback_buffer.h"
+#include "open_gl_data_structure/shader_program.h"
+#include "open_gl_data_structure/vao.h"
+
+namespace gpr {
+
+    //layout imposed by glDrawArraysIndirect
+    struct DrawArraysIndirectCommand {
+        GLuint count = 0;
+        GLuint instanceCount = 0;
+        GLuint first = 0;
+        GLuint baseInstance = 0;
+    };
+
+    /**
+     * Meshlet culling of the LOD 0 instances of a GpuInstanceCuller.
+     * At load time the meshes of LOD 0 are merged by texture and split in meshlets (gpr::BuildMeshlets).
+     * Every frame a compute pass takes each (visible LOD 0 instance, meshlet) pair and rejects it against the frustum,
+     * the normal cone (the whole meshlet faces away from the eye) and optionally the Hi-Z pyramid.
+     * The survivors are compacted per texture group and drawn by one instanced draw per group :
+     * an instance is a meshlet, gl_VertexID fetches its indices and vertices from SSBOs (vertex pulling),
+     * the corners past its triangle count collapse to a point.
+     *
+     * The dispatch size comes from the LOD 0 instance count written by the instance culling (indirect dispatch),
+     * so nothing is read back. Binding points (on top of 0 and 1 of GpuInstanceCuller) :
+     * 8 -> meshlets, 9 -> meshlet indices, 10 -> vertices, 11 -> visible pairs, 12 -> draw commands, 13 -> stats
+     */
+    class MeshletCuller {
+    public:
+        static constexpr GLuint kMeshletsBinding = 8;
+        static constexpr GLuint kMeshletIndicesBinding = 9;
+        static constexpr GLuint kVerticesBinding = 10;
+        static constexpr GLuint kPairsBinding = 11;
+        static constexpr GLuint kCommandsBinding = 12;
+        static constexpr GLuint kStatsBinding = 13;
+
+        //build the meshlets of LOD 0 and the buffers for every view of the instance culler,
+        //after MaterialSystem::AddModel so the groups know their material
+        void Create(const Model &model, const GpuInstanceCuller &instances, GLuint view_count, bool front_face_ccw);
+
+        //cull the meshlets of the LOD 0 instances of the view, the instance culling of the view must be done
+        void Cull(const GpuInstanceCuller &instances, const Frustum &frustum, const glm::vec3 &eye, GLuint view);
+
+        //same with the occlusion test against the pyramid
+        void CullOcclusion(const GpuInstanceCuller &instances, const Frustum &frustum, const glm::vec3 &eye,
+                           const glm::mat4 &view_projection, const HiZPyramid &hi_z, GLuint view);
+
+        //draw the visible meshlets of the view with their material, the MaterialSystem must be bound
+        void Draw(const GpuInstanceCuller &instances, const glm::mat4 &view_matrix, const glm::mat4 &projection,
+                  GLuint view) const;
+
+        //same meshlets with a depth only program, for a depth pre-pass
+        void DrawDepth(const GpuInstanceCuller &instances, const glm::mat4 &view_matrix, const glm::mat4 &projection,
+                       GLuint view) const;
+
+        void Delete();
+
+        [[nodiscard]] std::size_t meshlet_count() const { return meshlets_.size(); }
+
+        //triangles of the LOD 0 instances before and after the meshlet culling (a few frames late, no stall)
+        [[nodiscard]] GLuint tested_triangles() const { return tested_triangles_; }
+        [[nodiscard]] GLuint drawn_triangles() const { return drawn_triangles_; }
+
+    private:
+        //counters written by the cull pass, reset each frame
+        struct MeshletStats {
+            GLuint tested_triangles = 0;
+            GLuint drawn_triangles = 0;
+        };
+
+        //vertex pulled by meshlet_instancing.vert, uv in the w components
+        struct MeshletVertex {
+            glm::vec4 position_u;
+            glm::vec4 normal_v;
+        };
+
+        ComputeProgram cull_program_{};
+        ShaderProgram draw_program_{};
+        ShaderProgram depth_program_{};
+        //no attribute, the vertex shader reads everything from the SSBOs
+        VAO empty_vao_{};
+
+        std::vector<Meshlet> meshlets_{};
+        //meshlets are sorted by texture group, each group has its output list and its draw
+        std::vector<GLuint> group_first_meshlet_{};
+        //Mesh::material_ of the meshes of each group
+        std::vector<GLuint> group_materials_{};
+        GLuint view_count_ = 0;
+        GLuint instance_count_ = 0;
+
+        GLuint meshlets_ssbo_ = 0;
+        GLuint indices_ssbo_ = 0;
+        GLuint vertices_ssbo_ = 0;
+        GLuint pairs_ssbo_ = 0;
+        GLuint commands_buffer_ = 0;
+        GLuint dispatch_buffer_ = 0;
+        ReadbackBuffer stats_{};
+        GLuint tested_triangles_ = 0;
+        GLuint drawn_triangles_ = 0;
+
+        //commands with instanceCount = 0, one per group per view
+        std::vector<DrawArraysIndirectCommand> reset_commands_{};
+
+        void Dispatch(const GpuInstanceCuller &instances, const Frustum &frustum, const glm::vec3 &eye, GLuint view,
+                      bool occlusion);
+
+        //the indirect draws of every group, program must already be in use
+        void DrawGroups(const ShaderProgram &program, const GpuInstanceCuller &instances, const glm::mat4 &view_matrix,
+                        const glm::mat4 &projection, GLuint view) const;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_MESHLET_CULLING_H
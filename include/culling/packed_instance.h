@@ -0,0 +1,62 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_PACKED_INSTANCE_H
+#define SAMPLES_OPENGL_PACKED_INSTANCE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+
+namespace gpr {
+
+    /**
+     * Instance as stored on the GPU : 32 bytes instead of the 64 of a mat4.
+     * Position and uniform scale, the rotation as a quaternion in 4 snorm16, a material index and the LOD the
+     * culling picked last frame (written by instance_frustum_cull.comp for the hysteresis).
+     * The shaders rebuild the matrix with InstanceMatrix, the layout is the std430 Instance struct
+     * (both in culling/packed_instance.glsl, included by every shader reading the instances).
+     */
+    struct PackedInstance {
+        glm::vec3 position{0.0f};
+        float scale = 1.0f;
+        //packSnorm2x16(x, y), packSnorm2x16(z, w)
+        std::uint32_t rotation_xy = 0;
+        std::uint32_t rotation_zw = 0;
+        std::uint32_t material = 0;
+        std::uint32_t lod = 0;
+    };
+    static_assert(sizeof(PackedInstance) == 32, "PackedInstance must match the std430 Instance of the shaders");
+
+    //translation * rotation * uniform scale, the scale is the longest axis so the bounds stay conservative
+    inline PackedInstance PackInstance(const glm::mat4 &matrix, std::uint32_t material = 0) {
+        PackedInstance instance;
+        instance.position = glm::vec3(matrix[3]);
+        instance.scale = glm::max(glm::length(glm::vec3(matrix[0])),
+                                  glm::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+        const glm::mat3 rotation(glm::vec3(matrix[0]) / glm::length(glm::vec3(matrix[0])),
+                                 glm::vec3(matrix[1]) / glm::length(glm::vec3(matrix[1])),
+                                 glm::vec3(matrix[2]) / glm::length(glm::vec3(matrix[2])));
+        const glm::quat q = glm::normalize(glm::quat_cast(rotation));
+        instance.rotation_xy = glm::packSnorm2x16(glm::vec2(q.x, q.y));
+        instance.rotation_zw = glm::packSnorm2x16(glm::vec2(q.z, q.w));
+        instance.material = material;
+        return instance;
+    }
+
+    //CPU version of InstanceMatrix in the shaders
+    inline glm::mat4 UnpackInstance(const PackedInstance &instance) {
+        const glm::vec2 xy = glm::unpackSnorm2x16(instance.rotation_xy);
+        const glm::vec2 zw = glm::unpackSnorm2x16(instance.rotation_zw);
+        const glm::quat q = glm::normalize(glm::quat(zw.y, xy.x, xy.y, zw.x));
+        glm::mat4 matrix(glm::mat3_cast(q) * instance.scale);
+        matrix[3] = glm::vec4(instance.position, 1.0f);
+        return matrix;
+    }
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_PACKED_INSTANCE_H
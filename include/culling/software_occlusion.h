@@ -0,0 +1,78 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_SOFTWARE_OCCLUSION_H
+#define SAMPLES_OPENGL_SOFTWARE_OCCLUSION_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "culling/frustum_batch.h"
+
+namespace gpr {
+
+    /**
+     * Occlusion culling done on the CPU, does not need the GPU so it also works on software drivers (llvmpipe)
+     * and can be used for CPU side decisions before anything is submitted.
+     *
+     * A few low-poly occluders are rasterized in a small depth buffer (SSE, or AVX2 when compiled with it),
+     * the screen is split in bands of tiles rasterized by the WorkerPool. Each tile then keeps its farthest depth
+     * and a box is hidden when its nearest depth is behind the farthest depth of every tile it covers.
+     *
+     * Occluders must stay inside the real geometry (shrunk proxies), otherwise visible objects get culled.
+     */
+    class SoftwareOcclusionCuller {
+    public:
+        static constexpr int kWidth = 320, kHeight = 192;
+        static constexpr int kTileWidth = 8, kTileHeight = 8;
+        static constexpr int kTilesX = kWidth / kTileWidth, kTilesY = kHeight / kTileHeight;
+
+        SoftwareOcclusionCuller();
+
+        //clear the depth and the occluders, every test of the frame uses this matrix
+        void BeginFrame(const glm::mat4 &view_projection);
+
+        //triangles in the space of model, clipped against the near plane
+        void AddOccluder(std::span<const glm::vec3> vertices, std::span<const std::uint32_t> indices,
+                         const glm::mat4 &model);
+
+        //box proxy (12 triangles), min/max are in the space of model
+        void AddBoxOccluder(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model);
+
+        //rasterize every occluder then reduce the tiles, must be called before the tests
+        void Rasterize();
+
+        //world space box, false when hidden behind the occluders or outside the screen
+        [[nodiscard]] bool IsAabbVisible(const glm::vec3 &min, const glm::vec3 &max) const;
+
+        //test many boxes across threads, visibility[i] = 1 when visible (same layout as the GPU visibility buffer)
+        void TestAabbs(const AabbBatch &boxes, std::vector<std::uint32_t> &visibility);
+
+        [[nodiscard]] std::size_t occluder_triangle_count() const { return triangles_.size(); }
+        [[nodiscard]] std::size_t hidden_count() const { return hidden_count_; }
+
+    private:
+        //screen space triangle (x, y in pixels, z depth in [0, 1]) with its pixel bounds
+        struct ScreenTriangle {
+            glm::vec3 v0, v1, v2;
+            int min_x, min_y, max_x, max_y;
+        };
+
+        glm::mat4 view_projection_{1.0f};
+        std::vector<float> depth_{};
+        std::vector<float> tile_max_depth_{};
+        std::vector<ScreenTriangle> triangles_{};
+        std::size_t hidden_count_ = 0;
+
+        void AddClipTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c);
+
+        void RasterizeBand(int band);
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_SOFTWARE_OCCLUSION_H
@@ -0,0 +1,96 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_SPATIAL_GRID_H
+#define SAMPLES_OPENGL_SPATIAL_GRID_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "camera.h"
+#include "volumes.h"
+
+namespace gpr {
+
+    /**
+     * Hashed uniform grid for things that move (lights, camera, props), the counterpart of the static Bvh.
+     * Loose cells : an object only lives in the cell of its center, the queries grow their range by one cell,
+     * so insert, move and remove are O(1) (swap and pop inside the cell) and nothing is ever rebuilt.
+     * An object bigger than a cell (radius > cell size) would widen every query, it goes in a list tested by all of them
+     * instead and goes back to the cells if it shrinks : keep the cell size above the radius of most objects.
+     * Each object has a layer bit so one grid can hold several kinds of objects and a query picks the ones it wants.
+     */
+    class SpatialGrid {
+    public:
+        using Handle = std::uint32_t;
+        static constexpr Handle kInvalidHandle = 0xFFFFFFFFu;
+        static constexpr std::uint32_t kAllLayers = 0xFFFFFFFFu;
+
+        explicit SpatialGrid(float cell_size = 8.0f) : cell_size_{cell_size}, inverse_cell_size_{1.0f / cell_size} {}
+
+        Handle Insert(const Sphere &bounds, std::uint32_t user_data, std::uint32_t layer = 1);
+
+        //only touches the cells when the center crosses a border
+        void Move(Handle handle, const glm::vec3 &center);
+
+        void Update(Handle handle, const Sphere &bounds);
+
+        void Remove(Handle handle);
+
+        void Clear();
+
+        //handles of the objects touching the sphere / frustum, appended to result
+        void QuerySphere(const Sphere &sphere, std::vector<Handle> &result, std::uint32_t layers = kAllLayers) const;
+
+        void QueryFrustum(const Frustum &frustum, std::vector<Handle> &result, std::uint32_t layers = kAllLayers) const;
+
+        //object with the closest surface to the point, searched ring by ring around its cell
+        [[nodiscard]] Handle Nearest(const glm::vec3 &point, float max_distance,
+                                     std::uint32_t layers = kAllLayers) const;
+
+        [[nodiscard]] const Sphere &bounds(Handle handle) const { return objects_[handle].bounds; }
+        [[nodiscard]] std::uint32_t user_data(Handle handle) const { return objects_[handle].user_data; }
+        [[nodiscard]] std::size_t size() const { return objects_.size() - free_handles_.size(); }
+        [[nodiscard]] std::size_t cell_count() const { return cells_.size(); }
+
+    private:
+        struct Object {
+            Sphere bounds{};
+            std::uint32_t user_data = 0;
+            std::uint32_t layer = 0; //0 once removed
+            std::uint64_t cell = 0;
+            std::uint32_t slot = 0;  //position in the cell, to remove without searching
+        };
+
+        struct Cell {
+            glm::ivec3 coordinates{};
+            std::vector<Handle> handles{};
+        };
+
+        [[nodiscard]] glm::ivec3 CellCoordinates(const glm::vec3 &point) const;
+        [[nodiscard]] static std::uint64_t CellKey(const glm::ivec3 &coordinates);
+        //key of the cell of the center, or of the large list
+        [[nodiscard]] std::uint64_t PlacementKey(const Sphere &bounds) const;
+        void AddToCell(Handle handle);
+        void RemoveFromCell(Handle handle);
+        //calls visit on every object of the cells overlapping the box
+        template<typename Visitor>
+        void ForEachInBox(const glm::vec3 &min, const glm::vec3 &max, std::uint32_t layers, Visitor &&visit) const;
+
+        float cell_size_;
+        float inverse_cell_size_;
+        std::vector<Object> objects_{};
+        //objects with a radius over the cell size, in no cell
+        std::vector<Handle> large_{};
+        std::vector<Handle> free_handles_{};
+        //empty cells are kept, the moving objects come back to them without allocating
+        std::unordered_map<std::uint64_t, Cell> cells_{};
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_SPATIAL_GRID_H
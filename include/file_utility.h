@@ -1,8 +1,13 @@
 #pragma once
 
+#include <string>
 #include <string_view>
 
 namespace gpr
 {
     std::string LoadFile(std::string_view path);
+
+    //GLSL source with its #include "file" lines replaced by the file (path relative to the shader),
+    //the #extension GL_GOOGLE_include_directive line is only there for glslangValidator and is dropped
+    std::string LoadShader(std::string_view path);
 } // namespace gpr
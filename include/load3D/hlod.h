@@ -0,0 +1,108 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_HLOD_H
+#define SAMPLES_OPENGL_HLOD_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "camera.h"
+#include "load3D/texture_loader.h"
+#include "open_gl_data_structure/ebo.h"
+#include "open_gl_data_structure/shader_program.h"
+#include "open_gl_data_structure/vao.h"
+#include "open_gl_data_structure/vbo.h"
+
+namespace gpr {
+    //side of the square cells the instances are grouped by (xz plane)
+    static constexpr float kHlodCellSize = 40.0f;
+    //distance between the eye and the box of a cluster past which its proxy replaces the instances
+    static constexpr float kHlodDistance = 70.0f;
+    //the switch happens 10% past the distance each way so a cluster at the limit doesn't flicker
+    static constexpr float kHlodHysteresis = 0.1f;
+    //triangles of a proxy, whatever the number of instances in the cluster
+    static constexpr std::size_t kHlodProxyTriangleBudget = 8192;
+    //size of each texture once copied in the atlas
+    static constexpr GLsizei kHlodTileSize = 512;
+
+    /**
+     * Hierarchical LOD of static instances : the instances are grouped in clusters on a grid,
+     * the coarsest LOD of every member of a cluster is merged in world space and simplified into a single proxy mesh.
+     * The diffuse textures of the model are copied side by side in an atlas and each proxy vertex keeps the rectangle
+     * of its texture, so a proxy is one draw whatever the materials of the model.
+     *
+     * Select picks the clusters far enough to use their proxy, proxied() is then given to
+     * GpuInstanceCuller::UploadProxiedClusters so their members are skipped by the culling.
+     * Past the distance the far field costs one draw and at most kHlodProxyTriangleBudget triangles per cluster.
+     */
+    class HlodClusters {
+    public:
+        //group the instances and bake the proxies, needs the GL context (done at load time)
+        void Build(const Model &model, std::span<const glm::mat4> instance_matrices, float cell_size = kHlodCellSize);
+
+        //update the clusters drawn as a proxy, true when the selection changed
+        bool Select(const glm::vec3 &eye, float distance = kHlodDistance);
+
+        //draw the proxies of the selected clusters inside the frustum
+        void Draw(const glm::mat4 &view, const glm::mat4 &projection, const Frustum &frustum) const;
+
+        //same with a depth program already in use, "model" is set to identity (proxies are in world space)
+        void DrawDepth(GLuint program, const Frustum &frustum) const;
+
+        void Delete();
+
+        //cluster of each instance, in the order of the matrices given to Build
+        [[nodiscard]] std::span<const GLuint> instance_clusters() const { return instance_clusters_; }
+
+        //1 for the clusters drawn as a proxy
+        [[nodiscard]] std::span<const GLuint> proxied() const { return proxied_; }
+
+        [[nodiscard]] std::size_t cluster_count() const { return clusters_.size(); }
+        [[nodiscard]] std::size_t proxied_count() const { return proxied_count_; }
+
+        //draws and triangles of the proxies at the last Draw
+        [[nodiscard]] std::size_t drawn_proxies() const { return drawn_proxies_; }
+        [[nodiscard]] std::size_t drawn_triangles() const { return drawn_triangles_; }
+
+    private:
+        struct ProxyVertex {
+            glm::vec3 position;
+            glm::vec3 normal;
+            glm::vec2 tex_coords;
+            //part of the atlas the texture coordinates repeat in (xy offset, zw size)
+            glm::vec4 atlas_rect;
+        };
+
+        struct Cluster {
+            AABB bounds{};
+            std::vector<std::uint32_t> members{};
+            VAO vao{};
+            VBO vbo{};
+            EBO ebo{};
+            GLsizei index_count = 0;
+        };
+
+        ShaderProgram program_{};
+        GLuint atlas_ = 0;
+        std::vector<Cluster> clusters_{};
+        std::vector<GLuint> instance_clusters_{};
+        std::vector<GLuint> proxied_{};
+        std::size_t proxied_count_ = 0;
+        mutable std::size_t drawn_proxies_ = 0;
+        mutable std::size_t drawn_triangles_ = 0;
+
+        //copy the first diffuse texture of each mesh in the atlas, returns the texture of each tile
+        std::vector<GLuint> BuildAtlas(const std::vector<Mesh> &meshes);
+
+        void DrawProxies(const Frustum &frustum) const;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_HLOD_H
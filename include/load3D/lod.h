@@ -0,0 +1,52 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_LOD_H
+#define SAMPLES_OPENGL_LOD_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace gpr {
+    //LOD 0 (full detail) + 3 coarser levels, the culling shader has room for this many
+    static constexpr std::size_t kMaxLodCount = 4;
+    //a level changes only when the size is 15% past its threshold, so an instance at the limit doesn't flicker
+    static constexpr float kLodHysteresis = 0.15f;
+    //part of the triangles a generated level keeps from the previous one
+    static constexpr float kLodReduction = 0.4f;
+    //screen size under which LOD i + 1 is used
+    static constexpr std::array<float, kMaxLodCount - 1> kDefaultLodScreenSizes = {0.25f, 0.1f, 0.04f};
+    //screen size under which the last mesh level is replaced by its OctahedralImpostor
+    static constexpr float kImpostorScreenSize = 0.015f;
+
+    //part of the screen height covered by a sphere, projection_scale is projection[1][1] (1 / tan(fov / 2))
+    inline float ProjectedScreenSize(float radius, float distance, float projection_scale) {
+        if (distance <= radius) {
+            return 1.0f;
+        }
+        return radius * projection_scale / distance;
+    }
+
+    //first level whose threshold the size reaches
+    inline std::size_t SelectLod(std::span<const float> screen_sizes, float screen_size) {
+        std::size_t lod = 0;
+        while (lod < screen_sizes.size() && screen_size < screen_sizes[lod]) {
+            lod++;
+        }
+        return lod;
+    }
+
+    //same with hysteresis, current is the level used last frame (mirrored in instance_frustum_cull.comp)
+    inline std::size_t SelectLod(std::span<const float> screen_sizes, float screen_size, std::size_t current) {
+        const std::size_t coarser = SelectLod(screen_sizes, screen_size / (1.0f - kLodHysteresis));
+        if (coarser > current) {
+            return coarser;
+        }
+        const std::size_t finer = SelectLod(screen_sizes, screen_size / (1.0f + kLodHysteresis));
+        return finer < current ? finer : current;
+    }
+}
+
+#endif //SAMPLES_OPENGL_LOD_H
@@ -13,7 +13,9 @@
 #include "open_gl_data_structure/vao.h"
 #include "open_gl_data_structure/vbo.h"
 #include "open_gl_data_structure/ebo.h"
+#include "volumes.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -50,6 +52,11 @@ public:
     std::vector<unsigned int> indices_;
     std::vector<Texture>      textures_;
     VAO vao_{};
+    //bounds in the space of the mesh, filled by Model::ProcessMesh
+    AABB bounds_{};
+    Sphere bounding_sphere_{};
+    //id in the gpr::MaterialSystem table, 0 (default material) until MaterialSystem::AddModel
+    std::uint16_t material_ = 0;
 
     //contructor
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures)
@@ -111,36 +118,30 @@ private:
     // initializes all the buffer objects/arrays
     void setupMesh()
     {
-        vao_.Bind();
-        // load data into vertex buffers
-        vbo_.Bind();
-        vbo_.BindData(vertices_.size() * sizeof(Vertex), &vertices_[0], GL_STATIC_DRAW);
+        // a storage of 0 bytes is an error, an empty mesh keeps a VAO without buffers (it draws 0 indices)
+        if (vertices_.empty() || indices_.empty())
+            return;
 
-        ebo_.Bind();
-        ebo_.BindData(indices_.size() * sizeof(unsigned int), &indices_[0], GL_STATIC_DRAW);
+        // immutable storage, filled once
+        vbo_.Storage(static_cast<GLsizeiptr>(vertices_.size() * sizeof(Vertex)), vertices_.data());
+        ebo_.Storage(static_cast<GLsizeiptr>(indices_.size() * sizeof(unsigned int)), indices_.data());
+        vao_.SetVertexBuffer(0, vbo_, 0, sizeof(Vertex));
+        vao_.SetElementBuffer(ebo_);
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)nullptr);
+        vao_.SetAttribute(0, 3, GL_FLOAT, offsetof(Vertex, Position));
         // vertex normals
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+        vao_.SetAttribute(1, 3, GL_FLOAT, offsetof(Vertex, Normal));
         // vertex texture coords
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+        vao_.SetAttribute(2, 2, GL_FLOAT, offsetof(Vertex, TexCoords));
         // vertex tangent
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+        vao_.SetAttribute(3, 3, GL_FLOAT, offsetof(Vertex, Tangent));
         // vertex bitangent
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+        vao_.SetAttribute(4, 3, GL_FLOAT, offsetof(Vertex, Bitangent));
         // ids
-        glEnableVertexAttribArray(5);
-        glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
+        vao_.SetIntegerAttribute(5, 4, GL_INT, offsetof(Vertex, m_BoneIDs));
 
         // weights
-        glEnableVertexAttribArray(6);
-        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
-        glBindVertexArray(0);
+        vao_.SetAttribute(6, 4, GL_FLOAT, offsetof(Vertex, m_Weights));
     };
 };
 
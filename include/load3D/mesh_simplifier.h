@@ -0,0 +1,34 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_MESH_SIMPLIFIER_H
+#define SAMPLES_OPENGL_MESH_SIMPLIFIER_H
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "load3D/mesh.h"
+
+namespace gpr {
+
+    /**
+     * Quadric error simplification (Garland & Heckbert) used to generate the LOD of a mesh at load time.
+     * Vertices are welded by position so the UV seams don't stop the collapses, an edge always collapses
+     * onto one of its existing vertices so the attributes are kept (the wedge with the closest UV is picked).
+     * Open borders get extra perpendicular planes in their quadrics so the silhouette of the cards survives longer.
+     *
+     * Returns the indices of the remaining triangles, they still reference the input vertices,
+     * so the result can be simplified again for the next level.
+     */
+    std::vector<unsigned int> SimplifyMesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices,
+                                           std::size_t target_index_count,
+                                           float max_error = std::numeric_limits<float>::max());
+
+    //keeps only the vertices used by the indices, indices are remapped in place
+    std::vector<Vertex> CompactVertices(std::span<const Vertex> vertices, std::vector<unsigned int> &indices);
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_MESH_SIMPLIFIER_H
@@ -0,0 +1,46 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_MESHLET_H
+#define SAMPLES_OPENGL_MESHLET_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "load3D/mesh.h"
+
+namespace gpr {
+    //same limits as the mesh shader path of most GPUs, 124 keeps the primitive indices of a meshlet under 512 bytes
+    static constexpr std::size_t kMeshletMaxVertices = 64;
+    static constexpr std::size_t kMeshletMaxTriangles = 124;
+
+    //layout shared with the std430 Meshlet of meshlet_cull.comp and meshlet_instancing.vert
+    struct Meshlet {
+        //bounding sphere in model space (xyz center, w radius)
+        glm::vec4 sphere{0.0f};
+        //axis of the normals (xyz) and sine of their spread (w), w = 1 -> the cone can't cull anything
+        glm::vec4 cone{0.0f, 0.0f, 1.0f, 1.0f};
+        std::uint32_t first_index = 0;
+        std::uint32_t triangle_count = 0;
+        //first meshlet of the texture group this one belongs to, locates the output list of the group
+        std::uint32_t group_first_meshlet = 0;
+        std::uint32_t group = 0;
+    };
+
+    /**
+     * Splits the triangles in small clusters (meshlets) of at most kMeshletMaxVertices unique vertices and
+     * kMeshletMaxTriangles triangles, in the order of the index buffer so the clusters stay compact.
+     * The indices of each meshlet are appended to meshlet_indices (still referencing the input vertices),
+     * each meshlet gets its bounding sphere and the cone of its face normals for the backface test.
+     * front_face_ccw is the winding drawn as front face (the normals of the cone are computed from it).
+     */
+    void BuildMeshlets(std::span<const Vertex> vertices, std::span<const unsigned int> indices, bool front_face_ccw,
+                       std::vector<Meshlet> &meshlets, std::vector<unsigned int> &meshlet_indices);
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_MESHLET_H
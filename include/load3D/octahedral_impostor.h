@@ -0,0 +1,65 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_OCTAHEDRAL_IMPOSTOR_H
+#define SAMPLES_OPENGL_OCTAHEDRAL_IMPOSTOR_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "load3D/texture_loader.h"
+#include "open_gl_data_structure/ebo.h"
+#include "open_gl_data_structure/shader_program.h"
+#include "open_gl_data_structure/vao.h"
+#include "open_gl_data_structure/vbo.h"
+
+namespace gpr {
+
+    /**
+     * Far away version of a model : a card sampling an atlas of the model seen from a grid of directions.
+     * The directions come from an octahedron unfolded on a square (octahedral mapping), so the grid covers the whole
+     * sphere evenly and finding the frame of a view direction is a couple of additions.
+     *
+     * Bake renders the model once per frame into 3 atlases : albedo (alpha = coverage), object-space normal and the
+     * depth of the surface along the frame direction. The card is aligned with the nearest frame and the depth
+     * moves its fragments back onto the real surface, so impostors intersect the ground and each other correctly.
+     */
+    class OctahedralImpostor {
+    public:
+        static constexpr int kFramesPerSide = 8;
+        static constexpr int kFrameSize = 256;
+        static constexpr int kAtlasSize = kFramesPerSide * kFrameSize;
+        //quad drawn per instance
+        static constexpr GLuint kIndexCount = 6;
+
+        //renders the model in the atlases, needs the GL context (done at load time), the GL state is restored after
+        void Bake(Model &model);
+
+        //program, atlases and uniforms for the instanced draw, the quad VAO is bound
+        void Use(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &eye) const;
+
+        void Delete();
+
+        [[nodiscard]] const ShaderProgram &program() const { return render_program_; }
+        [[nodiscard]] GLuint albedo_atlas() const { return albedo_atlas_; }
+        [[nodiscard]] GLuint normal_atlas() const { return normal_atlas_; }
+        [[nodiscard]] GLuint depth_atlas() const { return depth_atlas_; }
+
+    private:
+        ShaderProgram bake_program_{};
+        ShaderProgram render_program_{};
+        GLuint albedo_atlas_ = 0;
+        GLuint normal_atlas_ = 0;
+        GLuint depth_atlas_ = 0;
+        //bounding sphere of the model (xyz center, w radius), the cards are 2 radius wide
+        glm::vec4 sphere_{0.0f};
+
+        VAO quad_vao_{};
+        VBO quad_vbo_{};
+        EBO quad_ebo_{};
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_OCTAHEDRAL_IMPOSTOR_H
@@ -8,6 +8,7 @@
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
+#include "load3D/lod.h"
 #include "load3D/mesh.h"
 
 #include <vector>
@@ -32,6 +33,13 @@ public:
     std::vector<Mesh>    meshes_;
     std::string directory_;
     bool gammaCorrection;
+    //bounds of every mesh together, in the space of the model
+    AABB bounds_{};
+    Sphere bounding_sphere_{};
+    //coarser versions of meshes_ (lods_[0] is LOD 1), empty until CreateLods
+    std::vector<std::vector<Mesh>> lods_;
+    //screen size (see gpr::ProjectedScreenSize) under which LOD i + 1 is used
+    std::vector<float> lod_screen_sizes_;
 
     // constructor, expects a filepath to a 3D model.
     explicit Model(std::string const &path, bool gamma = false) : gammaCorrection(gamma)
@@ -46,12 +54,36 @@ public:
             mesh.Draw(shader);
     }
 
+    // draws one level of detail, 0 is meshes_
+    void Draw(GLuint &shader, std::size_t lod)
+    {
+        for(auto & mesh : lod == 0 ? meshes_ : lods_[lod - 1])
+            mesh.Draw(shader);
+    }
+
+    /**
+     * Loads the authored tiers next to the file (Megascans "_tier_N") or generates the missing levels
+     * by quadric simplification, each level keeping kLodReduction of the triangles of the previous one.
+     * The generated levels merge the meshes sharing the same textures, so the leaves of a tree become one draw.
+     */
+    void CreateLods(std::size_t level_count = gpr::kMaxLodCount - 1);
+
+    [[nodiscard]] std::size_t lod_count() const { return 1 + lods_.size(); }
+
+    [[nodiscard]] const std::vector<Mesh> &lod_meshes(std::size_t lod) const { return lod == 0 ? meshes_ : lods_[lod - 1]; }
+
 private:
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(std::string const &path);
 
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-    void ProcessNode(aiNode *node, const aiScene *scene);
+    void ProcessNode(aiNode *node, const aiScene *scene, std::vector<Mesh> &meshes);
+
+    // loads another tier of the same asset in meshes, false when the file doesn't exist
+    bool LoadTier(const std::string &path, std::vector<Mesh> &meshes);
+
+    // path the model was loaded from, used to find the authored tiers
+    std::string path_;
 
     Mesh ProcessMesh(aiMesh *mesh, const aiScene *scene);
 
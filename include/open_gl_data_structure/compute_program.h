@@ -0,0 +1,36 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_COMPUTE_PROGRAM_H
+#define SAMPLES_OPENGL_COMPUTE_PROGRAM_H
+
+#include <GL/glew.h>
+
+class ComputeProgram
+{
+private:
+    GLuint name_ = 0;
+
+public:
+    ComputeProgram() = default;
+
+    //load, compile and link the compute shader at path
+    void Create(const char* path);
+
+    //use the program
+    void Use() const;
+
+    //launch the work groups and wait for the given barrier
+    static void Dispatch(GLuint groups_x, GLuint groups_y, GLuint groups_z, GLbitfield barriers);
+
+    [[nodiscard]] GLint UniformLocation(const char* uniform) const;
+
+    [[nodiscard]] GLuint name() const { return name_; }
+
+    //delete
+    void Delete();
+};
+
+
+#endif //SAMPLES_OPENGL_COMPUTE_PROGRAM_H
@@ -7,24 +7,42 @@
 
 #include <GL/glew.h>
 
+/**
+ * Buffer of the indices, created with Direct State Access.
+ * Storage gives it an immutable size (flags GL_DYNAMIC_STORAGE_BIT for SubData, GL_MAP_*_BIT for Map),
+ * BindData is the old bind-to-edit path and can't be used after Storage.
+ */
 class EBO
 {
 private:
-    GLuint name_;
+    GLuint name_ = 0;
 
 public:
     EBO() = default;
     explicit EBO(GLuint& name);
 
-    //create the VBO
+    //create the EBO
     void Create();
 
-    //bind the VBO
+    //bind the EBO
     void Bind() const;
 
-    //bind the data of the VBO
+    //bind the data of the EBO
     void BindData(GLsizei size, const void* data, GLenum usage) const;
 
+    //allocate the immutable storage, data can be nullptr
+    void Storage(GLsizeiptr size, const void* data, GLbitfield flags = 0) const;
+
+    //update a range, the storage needs GL_DYNAMIC_STORAGE_BIT
+    void SubData(GLintptr offset, GLsizeiptr size, const void* data) const;
+
+    //map a range, access must be allowed by the storage flags
+    [[nodiscard]] void* Map(GLintptr offset, GLsizeiptr length, GLbitfield access) const;
+
+    void Unmap() const;
+
+    [[nodiscard]] GLuint name() const { return name_; }
+
     //delete
     void Delete();
 };
@@ -0,0 +1,59 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_FENCED_RING_H
+#define SAMPLES_OPENGL_FENCED_RING_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstddef>
+
+/**
+ * Buffer mapped once (persistent + coherent), never re-specified, and cut in kFramesInFlight partitions used in turn.
+ * Advance moves to the next partition and waits for its fence (the GPU is done with the frame that used it),
+ * Fence puts a fence behind the commands using the current one. Shared by the StreamingBuffer (CPU -> GPU)
+ * and the ReadbackBuffer (GPU -> CPU), which only decide what goes in the partitions.
+ */
+class FencedRing
+{
+public:
+    static constexpr std::size_t kFramesInFlight = 3;
+
+    //partitions of partition_size bytes rounded up to alignment, what names the buffer in the errors
+    void Create(GLsizeiptr partition_size, GLintptr alignment, GLbitfield map_flags, const char* what);
+
+    //false when the fence of the new partition could not be waited for, the GPU may still use it
+    bool Advance();
+
+    //after the commands using the current partition, replaces the fence if there is one already
+    void Fence();
+
+    //delete
+    void Delete();
+
+    [[nodiscard]] GLuint name() const { return name_; }
+    //nullptr if the mapping failed
+    [[nodiscard]] std::byte* mapped() const { return mapped_; }
+    [[nodiscard]] GLsizeiptr partition_size() const { return partition_size_; }
+    [[nodiscard]] GLsizeiptr size() const { return partition_size_ * static_cast<GLsizeiptr>(kFramesInFlight); }
+    //start of the current partition in the buffer
+    [[nodiscard]] GLintptr offset() const { return static_cast<GLintptr>(partition_) * partition_size_; }
+
+    //frames where Advance had to wait for the GPU
+    [[nodiscard]] std::size_t stall_count() const { return stall_count_; }
+
+private:
+    GLuint name_ = 0;
+    std::byte* mapped_ = nullptr;
+    GLsizeiptr partition_size_ = 0;
+    //the first Advance moves to partition 0
+    std::size_t partition_ = kFramesInFlight - 1;
+    std::array<GLsync, kFramesInFlight> fences_{};
+    std::size_t stall_count_ = 0;
+    const char* what_ = "";
+};
+
+
+#endif //SAMPLES_OPENGL_FENCED_RING_H
@@ -0,0 +1,103 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_GL_STATE_CACHE_H
+#define SAMPLES_OPENGL_GL_STATE_CACHE_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Shadow copy of the GL state the frame loop changes the most, a call that sets the value already set is dropped.
+ * Only correct if that state is changed through the cache : code that still uses raw GL (Model::Draw, the samples)
+ * must be followed by Invalidate, BeginFrame invalidates everything once per frame.
+ * Textures are bound with glBindTextureUnit, so the active texture unit is never changed.
+ * ShaderProgram::Use and ComputeProgram::Use go through it.
+ */
+class GLStateCache
+{
+public:
+    static constexpr std::size_t kTextureUnits = 16;
+
+    //the samples have a single GL context
+    static GLStateCache& Get();
+
+    //keep the counters of the last frame for the stats and forget the state (changed outside since last frame)
+    void BeginFrame();
+
+    //next call of every function reaches GL
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+
+    void BindVertexArray(GLuint vao);
+
+    //GL_FRAMEBUFFER sets both the draw and the read framebuffer
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    void BindTexture(GLuint unit, GLuint texture);
+
+    void BindSampler(GLuint unit, GLuint sampler);
+
+    //depth test, cull face, blend, scissor and stencil test are cached, other capabilities go straight to GL
+    void Enable(GLenum capability);
+
+    void Disable(GLenum capability);
+
+    void DepthFunc(GLenum func);
+
+    void DepthMask(GLboolean mask);
+
+    void CullFace(GLenum mode);
+
+    void FrontFace(GLenum mode);
+
+    void BlendFunc(GLenum source, GLenum destination);
+
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    //calls dropped / sent to GL during the last frame
+    [[nodiscard]] std::size_t hit_count() const { return last_hits_; }
+    [[nodiscard]] std::size_t miss_count() const { return last_misses_; }
+
+private:
+    //never a valid name or enum, forces the next call through
+    static constexpr GLuint kUnknown = 0xFFFFFFFF;
+
+    static constexpr std::size_t kCachedCapabilityCount = 5;
+    //same order as kCachedCapabilities in the cpp, -1 unknown, 0 disabled, 1 enabled
+    std::array<std::int8_t, kCachedCapabilityCount> capabilities_{};
+
+    GLuint program_ = kUnknown;
+    GLuint vao_ = kUnknown;
+    GLuint draw_framebuffer_ = kUnknown;
+    GLuint read_framebuffer_ = kUnknown;
+    std::array<GLuint, kTextureUnits> textures_{};
+    std::array<GLuint, kTextureUnits> samplers_{};
+    GLenum depth_func_ = kUnknown;
+    GLuint depth_mask_ = kUnknown;
+    GLenum cull_face_ = kUnknown;
+    GLenum front_face_ = kUnknown;
+    std::array<GLenum, 2> blend_func_{kUnknown, kUnknown};
+    std::array<GLint, 4> viewport_{};
+    bool viewport_known_ = false;
+
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+    std::size_t last_hits_ = 0;
+    std::size_t last_misses_ = 0;
+
+    //true when value is already set, else stores it and counts a miss
+    bool Cached(GLuint &current, GLuint value);
+
+    void SetCapability(GLenum capability, bool enabled);
+
+    GLStateCache() { Invalidate(); }
+};
+
+
+#endif //SAMPLES_OPENGL_GL_STATE_CACHE_H
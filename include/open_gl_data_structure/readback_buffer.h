@@ -0,0 +1,64 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_READBACK_BUFFER_H
+#define SAMPLES_OPENGL_READBACK_BUFFER_H
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "open_gl_data_structure/fenced_ring.h"
+
+/**
+ * Small SSBO written by the GPU every frame (the counters of a compute pass) and read by the CPU without stalling.
+ * Like the StreamingBuffer it is a FencedRing, each partition a copy of the buffer :
+ * BeginFrame waits for the fence of the copy it reuses, keeps what the GPU wrote in it and zeroes it,
+ * Fence puts a fence behind the passes that wrote the copy of the frame.
+ * The CPU never touches a copy the GPU may still be using, the value read is kFramesInFlight frames old.
+ */
+class ReadbackBuffer
+{
+public:
+    static constexpr std::size_t kFramesInFlight = FencedRing::kFramesInFlight;
+
+    void Create(GLsizeiptr size);
+
+    //once per frame, before the first pass writing the buffer
+    void BeginFrame();
+
+    //copy of this frame on an SSBO binding point
+    void Bind(GLuint binding) const;
+
+    //after the passes writing the copy of this frame, call it again if another pass writes it later in the frame
+    void Fence();
+
+    //last copy read back, zeroed until the first one comes back
+    template<typename T>
+    [[nodiscard]] T Read() const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        std::memcpy(&value, last_.data(), std::min(sizeof(T), last_.size()));
+        return value;
+    }
+
+    //frames where BeginFrame had to wait for the GPU
+    [[nodiscard]] std::size_t stall_count() const { return ring_.stall_count(); }
+
+    //delete
+    void Delete();
+
+private:
+    FencedRing ring_{};
+    GLsizeiptr size_ = 0;
+    std::vector<std::byte> last_{};
+};
+
+
+#endif //SAMPLES_OPENGL_READBACK_BUFFER_H
@@ -0,0 +1,33 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_SHADER_PROGRAM_H
+#define SAMPLES_OPENGL_SHADER_PROGRAM_H
+
+#include <GL/glew.h>
+
+class ShaderProgram
+{
+private:
+    GLuint name_ = 0;
+
+public:
+    ShaderProgram() = default;
+
+    //load, compile and link the vertex and fragment shaders
+    void Create(const char* vertex_path, const char* fragment_path);
+
+    //use the program
+    void Use() const;
+
+    [[nodiscard]] GLint UniformLocation(const char* uniform) const;
+
+    [[nodiscard]] GLuint name() const { return name_; }
+
+    //delete
+    void Delete();
+};
+
+
+#endif //SAMPLES_OPENGL_SHADER_PROGRAM_H
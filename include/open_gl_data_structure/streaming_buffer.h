@@ -0,0 +1,73 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_STREAMING_BUFFER_H
+#define SAMPLES_OPENGL_STREAMING_BUFFER_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <span>
+
+#include "open_gl_data_structure/fenced_ring.h"
+
+//part of the streaming buffer written this frame, offset is from the start of the buffer (for binds and copies)
+template<typename T>
+struct StreamAllocation {
+    std::span<T> data{};
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+
+    [[nodiscard]] bool empty() const { return data.empty(); }
+};
+
+/**
+ * Buffer for the data written by the CPU every frame, a FencedRing : BeginFrame waits for the fence of the partition
+ * it reuses (the GPU finished the frame that read it), EndFrame puts a fence behind the commands of the frame.
+ * Allocations are written directly in the mapped memory, the driver makes no copy,
+ * they can be bound with glBindBufferRange or copied GPU-side in another buffer.
+ */
+class StreamingBuffer
+{
+public:
+    static constexpr std::size_t kFramesInFlight = FencedRing::kFramesInFlight;
+
+    //bytes_per_frame is the most that can be allocated between BeginFrame and EndFrame
+    void Create(GLsizeiptr bytes_per_frame);
+
+    void BeginFrame();
+
+    void EndFrame();
+
+    //count elements aligned for a SSBO/UBO bind, empty when the partition is full
+    template<typename T>
+    StreamAllocation<T> Allocate(std::size_t count)
+    {
+        const GLintptr offset = Reserve(static_cast<GLsizeiptr>(count * sizeof(T)));
+        if (offset < 0) {
+            return {};
+        }
+        return {std::span<T>(reinterpret_cast<T*>(ring_.mapped() + offset), count), offset,
+                static_cast<GLsizeiptr>(count * sizeof(T))};
+    }
+
+    [[nodiscard]] GLuint name() const { return ring_.name(); }
+
+    //frames where BeginFrame had to wait for the GPU
+    [[nodiscard]] std::size_t stall_count() const { return ring_.stall_count(); }
+
+    //delete
+    void Delete();
+
+private:
+    FencedRing ring_{};
+    GLintptr alignment_ = 1;
+    GLintptr head_ = 0;
+
+    //offset of size bytes in the current partition, -1 when it doesn't fit
+    GLintptr Reserve(GLsizeiptr size);
+};
+
+
+#endif //SAMPLES_OPENGL_STREAMING_BUFFER_H
@@ -6,7 +6,15 @@
 #define SAMPLES_OPENGL_VAO_H
 #include <GL/glew.h>
 
+#include "open_gl_data_structure/vbo.h"
+#include "open_gl_data_structure/ebo.h"
 
+
+/**
+ * Vertex array, the setup functions use Direct State Access : the VAO doesn't need to be bound to be configured
+ * and the bindings of the context are left untouched.
+ * A vertex buffer is attached to a binding point, each attribute reads one binding point at its relative offset.
+ */
 class VAO
 {
 private:
@@ -22,6 +30,24 @@ public:
     //bind the VAO_
     void Bind() const;
 
+    //read vbo from offset with stride bytes per vertex on the binding point
+    void SetVertexBuffer(GLuint binding, const VBO& vbo, GLintptr offset, GLsizei stride) const;
+
+    //indices of the glDrawElements
+    void SetElementBuffer(const EBO& ebo) const;
+
+    //float attribute (normalized integers when normalized is GL_TRUE) read from the binding point
+    void SetAttribute(GLuint index, GLint size, GLenum type, GLuint relative_offset, GLuint binding = 0,
+                      GLboolean normalized = GL_FALSE) const;
+
+    //integer attribute (ivec/uvec in the shader) read from the binding point
+    void SetIntegerAttribute(GLuint index, GLint size, GLenum type, GLuint relative_offset, GLuint binding = 0) const;
+
+    //0 = per vertex, n = next element every n instances
+    void SetBindingDivisor(GLuint binding, GLuint divisor) const;
+
+    [[nodiscard]] GLuint name() const { return name_; }
+
     //delete
     void Delete();
 };
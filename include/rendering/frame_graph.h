@@ -0,0 +1,132 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_FRAME_GRAPH_H
+#define SAMPLES_OPENGL_FRAME_GRAPH_H
+
+#include "rendering/render_target_pool.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gpr {
+
+    //index of a resource, only valid for the frame it was created in
+    using FrameResource = std::uint32_t;
+
+    class FrameGraph;
+
+    //given to the setup of a pass to declare what it touches
+    class FramePassBuilder {
+    public:
+        //sampled (or read by a compute shader) during the pass
+        FrameResource Read(FrameResource resource);
+
+        //attached to the framebuffer of the pass : colors in the order of the calls, depth formats as depth
+        FrameResource Write(FrameResource resource);
+
+    private:
+        friend class FrameGraph;
+
+        FramePassBuilder(FrameGraph &graph, std::uint32_t pass) : graph_(graph), pass_(pass) {}
+
+        FrameGraph &graph_;
+        std::uint32_t pass_;
+    };
+
+    /**
+     * The passes of a frame declare the render targets they read and write, the graph does the rest :
+     * - the passes whose writes are never read are culled (with the passes feeding only them),
+     *   writing an imported resource or nothing at all keeps a pass alive
+     * - the transient targets get a texture from the RenderTargetPool when they are first used and give it back after
+     *   their last use, so targets with the same description and lifetimes that don't overlap share the same memory
+     * - the framebuffer of each pass is bound (and created once per set of textures) with the viewport of its targets
+     * - the content of a transient target is invalidated (glInvalidateTexImage) after its last use
+     * The graph is rebuilt every frame (Reset, Create/Import, AddPass, Compile, Execute), the pool stays.
+     */
+    class FrameGraph {
+    public:
+        using Setup = std::function<void(FramePassBuilder &)>;
+        using Pass = std::function<void(FrameGraph &)>;
+
+        //forget the passes and the resources of the last frame
+        void Reset();
+
+        FrameResource Create(std::string_view name, const RenderTargetDesc &desc);
+
+        //texture owned outside the graph, 0 is the default framebuffer
+        FrameResource Import(std::string_view name, GLuint texture, const RenderTargetDesc &desc);
+
+        //setup is called right away, execute during Execute if the pass is not culled
+        void AddPass(std::string_view name, const Setup &setup, Pass execute);
+
+        void Compile();
+
+        void Execute();
+
+        //texture given to the resource for this frame, 0 if every pass using it was culled
+        [[nodiscard]] GLuint texture(FrameResource resource) const { return resources_[resource].texture; }
+
+        //framebuffer with the textures of these resources attached, for the passes switching targets (ping-pong)
+        GLuint Framebuffer(std::initializer_list<FrameResource> attachments);
+
+        //delete the pool and the framebuffers
+        void Delete();
+
+        [[nodiscard]] std::size_t pass_count() const { return passes_.size(); }
+        [[nodiscard]] std::size_t culled_count() const { return culled_count_; }
+        [[nodiscard]] std::size_t transient_count() const { return transient_count_; }
+        [[nodiscard]] const RenderTargetPool &pool() const { return pool_; }
+
+    private:
+        friend class FramePassBuilder;
+
+        struct Resource {
+            std::string name{};
+            RenderTargetDesc desc{};
+            bool imported = false;
+            GLuint texture = 0;
+            //passes writing it, and how many passes still alive read it
+            std::vector<std::uint32_t> writers{};
+            std::uint32_t readers = 0;
+            std::uint32_t first_use = 0;
+            std::uint32_t last_use = 0;
+        };
+
+        struct PassNode {
+            std::string name{};
+            Pass execute{};
+            std::vector<FrameResource> reads{};
+            std::vector<FrameResource> writes{};
+            //transient resources whose last use is this pass
+            std::vector<FrameResource> invalidates{};
+            std::uint32_t references = 0;
+            bool culled = false;
+        };
+
+        std::vector<Resource> resources_{};
+        std::vector<PassNode> passes_{};
+        RenderTargetPool pool_{};
+        //attached textures -> framebuffer
+        std::map<std::vector<GLuint>, GLuint> framebuffers_{};
+        std::size_t culled_count_ = 0;
+        std::size_t transient_count_ = 0;
+
+        void Cull();
+
+        void Allocate();
+
+        GLuint CachedFramebuffer(const std::vector<FrameResource> &attachments);
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_FRAME_GRAPH_H
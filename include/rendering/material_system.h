@@ -0,0 +1,96 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_MATERIAL_SYSTEM_H
+#define SAMPLES_OPENGL_MATERIAL_SYSTEM_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "load3D/texture_loader.h"
+
+namespace gpr {
+
+    //texture of a material : index of the texture array << 16 | layer, kNoTexture when the material has none
+    static constexpr std::uint32_t kNoTexture = 0xFFFFFFFF;
+
+    //one element of the Materials block (std430)
+    struct GpuMaterial {
+        glm::vec4 base_color{1.0f};
+        std::uint32_t diffuse = kNoTexture;
+        std::uint32_t normal = kNoTexture;
+        std::uint32_t specular = kNoTexture;
+        float shininess = 32.0f;
+    };
+
+    /**
+     * Every material of the scene in one table on the GPU, the shaders read Materials[id] instead of having
+     * their textures bound per draw : switching material costs no GL call and different materials can share a draw.
+     * The textures are copied (glCopyImageSubData, all the mips) in one GL_TEXTURE_2D_ARRAY per format and size,
+     * the arrays are bound once to the units kFirstArrayUnit + i (uniform sampler2DArray materialArrays[kMaxTextureArrays]).
+     * Material 0 is the default one, white without textures.
+     *
+     * Binding points used by the shaders : 15 -> materials, units 8..15 -> texture arrays
+     */
+    class MaterialSystem {
+    public:
+        static constexpr GLuint kMaterialsBinding = 15;
+        static constexpr GLuint kFirstArrayUnit = 8;
+        static constexpr std::size_t kMaxTextureArrays = 8;
+
+        MaterialSystem() { materials_.emplace_back(); }
+
+        //texture already loaded as a GL_TEXTURE_2D, the same texture always gets the same reference
+        std::uint32_t AddTexture(GLuint texture);
+
+        //material from the tags of Model (texture_diffuse, texture_normal, texture_specular),
+        //meshes with the same textures share the material
+        std::uint16_t AddMaterial(const std::vector<Texture> &textures);
+
+        std::uint16_t AddMaterial(const GpuMaterial &material);
+
+        //set Mesh::material_ of every mesh of every LOD
+        void AddModel(Model &model);
+
+        //create the texture arrays and upload the table, after the last Add
+        void Build();
+
+        //bind the table and the arrays for the next draws
+        void Bind() const;
+
+        //delete
+        void Delete();
+
+        [[nodiscard]] std::size_t material_count() const { return materials_.size(); }
+        [[nodiscard]] std::size_t texture_count() const { return texture_refs_.size(); }
+        [[nodiscard]] std::size_t array_count() const { return arrays_.size(); }
+
+    private:
+        //textures that share a format and a size, they become the layers of one array
+        struct TextureArray {
+            GLenum internal_format = 0;
+            GLsizei width = 0;
+            GLsizei height = 0;
+            GLsizei levels = 1;
+            std::vector<GLuint> textures{};
+            GLuint name = 0;
+        };
+
+        std::vector<TextureArray> arrays_{};
+        std::unordered_map<GLuint, std::uint32_t> texture_refs_{};
+        std::vector<GpuMaterial> materials_{};
+        //diffuse, normal, specular -> material, to share the materials between the meshes
+        std::map<std::array<std::uint32_t, 3>, std::uint16_t> material_ids_{};
+        GLuint materials_buffer_ = 0;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_MATERIAL_SYSTEM_H
@@ -0,0 +1,81 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_PRIMITIVES_H
+#define SAMPLES_OPENGL_PRIMITIVES_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstdint>
+
+#include "open_gl_data_structure/vao.h"
+#include "open_gl_data_structure/vbo.h"
+#include "rendering/render_queue.h"
+
+namespace gpr {
+
+    enum class Primitive : std::uint8_t {
+        //-1..1, CCW outside
+        kCube = 0,
+        //-1..1 in the XY plane facing +Z, uv 0..1
+        kQuad = 1,
+        //the cube seen from the inside
+        kSkybox = 2,
+        //3 vertices without attributes, the vertex shader makes the positions (full_screen_triangle.vert)
+        kFullScreenTriangle = 3,
+    };
+
+    static constexpr std::size_t kPrimitiveCount = 4;
+
+    //same layout as Vertex without the bones : 0 position, 1 normal, 2 uv, 3 tangent, 4 bitangent
+    struct PrimitiveVertex {
+        std::array<float, 3> position{};
+        std::array<float, 3> normal{};
+        std::array<float, 2> uv{};
+        std::array<float, 3> tangent{};
+        std::array<float, 3> bitangent{};
+    };
+
+    struct PrimitiveRange {
+        GLint first = 0;
+        GLsizei count = 0;
+    };
+
+    /**
+     * The shapes every scene needs, built once from constexpr tables in one vertex buffer with one VAO,
+     * so drawing one of them after another doesn't even change the VAO.
+     * The full-screen triangle has no vertex data, the post-processing passes draw it with an empty VAO.
+     */
+    class PrimitiveRegistry {
+    public:
+        void Create();
+
+        //bind through the GLStateCache and draw, instance_count > 1 for instanced shaders
+        void Draw(Primitive primitive, GLsizei instance_count = 1) const;
+
+        //packet already pointing at the primitive, the rest is filled by the scene
+        [[nodiscard]] DrawPacket Packet(Primitive primitive) const;
+
+        [[nodiscard]] PrimitiveRange range(Primitive primitive) const {
+            return ranges_[static_cast<std::size_t>(primitive)];
+        }
+
+        [[nodiscard]] GLuint vao(Primitive primitive) const {
+            return primitive == Primitive::kFullScreenTriangle ? empty_vao_.name() : vao_.name();
+        }
+
+        //delete
+        void Delete();
+
+    private:
+        VAO vao_{};
+        VBO vbo_{};
+        VAO empty_vao_{};
+        std::array<PrimitiveRange, kPrimitiveCount> ranges_{};
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_PRIMITIVES_H
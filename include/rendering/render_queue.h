@@ -0,0 +1,156 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_RENDER_QUEUE_H
+#define SAMPLES_OPENGL_RENDER_QUEUE_H
+
+#include "open_gl_data_structure/streaming_buffer.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gpr {
+
+    //passes in the order of the sort key, each one is executed on its own framebuffer
+    enum class RenderPass : std::uint8_t {
+        kShadow = 0,
+        kOpaque = 1,
+        kSky = 2,
+        kTransparent = 3,
+    };
+
+    static constexpr std::size_t kPacketTextureCount = 4;
+    //depths past it share the last bucket of the key
+    static constexpr float kMaxSortDepth = 1000.0f;
+
+    //everything needed to issue one draw, the uniforms shared by the pass are set by the scene before Execute
+    struct DrawPacket {
+        RenderPass pass = RenderPass::kOpaque;
+        GLuint program = 0;
+        //sent to the "model" uniform of the program if it has one
+        glm::mat4 model{1.0f};
+        //id of the material in the key and in DrawInstance::ids,
+        //its textures are bound to the units 0..n (0 = keep the unit, programs using the MaterialSystem bind none)
+        std::uint16_t material = 0;
+        std::array<GLuint, kPacketTextureCount> textures{};
+        //read by the instanced programs next to the model (colour of a light cube...)
+        glm::vec4 instance_data{0.0f};
+        GLuint vao = 0;
+        GLenum mode = GL_TRIANGLES;
+        //first index (indexed, GL_UNSIGNED_INT) or first vertex, and how many
+        GLint first = 0;
+        GLsizei count = 0;
+        bool indexed = false;
+        //only for the programs without the DrawInstances block, the others are instanced by the queue
+        GLsizei instance_count = 1;
+        GLuint base_instance = 0;
+        bool cull_back_faces = false;
+        GLenum front_face = GL_CW;
+        GLenum depth_func = GL_LESS;
+    };
+
+    //one element of the DrawInstances block (std430, data/shaders/3D_scene/draw_instance.glsl),
+    //written by the queue in the streaming buffer
+    struct DrawInstance {
+        glm::mat4 model{1.0f};
+        glm::vec4 data{0.0f};
+        //x : material of the packet (MaterialSystem id for the programs reading Materials)
+        glm::uvec4 ids{0u};
+    };
+
+    struct SortEntry {
+        std::uint64_t key = 0;
+        std::uint32_t packet = 0;
+    };
+
+    /**
+     * 64 bits key, the order of the bits is the order of the draws :
+     * shadow, opaque -> pass (4) | program (12) | material (16) | depth front to back (24) | 0 (8)
+     * sky, transparent -> pass (4) | depth back to front (24) | program (12) | material (16) | 0 (8)
+     * so the opaque draws change program and textures as little as possible and the blended ones stay in depth order.
+     */
+    std::uint64_t MakeSortKey(RenderPass pass, GLuint program, std::uint16_t material, float view_depth);
+
+    //LSD radix sort on the keys, 8 bits per pass, stable (equal keys keep their submission order)
+    void RadixSort(std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch);
+
+    /**
+     * Draws submitted in any order during the frame, sorted once by key then executed pass by pass.
+     * The state goes through the GLStateCache, so consecutive packets only pay for what differs.
+     * Programs that declare the DrawInstances block read their model from it : consecutive packets of such a program
+     * with the same mesh, textures and state are merged in one instanced draw, with
+     * instances[instanceOffset + gl_InstanceID] written in the streaming buffer by Sort.
+     */
+    class RenderQueue {
+    public:
+        static constexpr GLuint kDrawInstancesBinding = 14;
+
+        //forget the packets and the stats of the last frame
+        void Clear();
+
+        //view_depth is the distance of the packet along the view direction of its pass
+        void Submit(const DrawPacket &packet, float view_depth);
+
+        //sort the keys then merge the runs of identical draws, instance_stream must be between BeginFrame and EndFrame
+        void Sort(StreamingBuffer &instance_stream);
+
+        //draw the packets of the pass in key order, Sort must have been called since the last Submit
+        void Execute(RenderPass pass);
+
+        [[nodiscard]] std::size_t packet_count() const { return packets_.size(); }
+        //draw calls issued by Execute since Clear
+        [[nodiscard]] std::size_t draw_calls() const { return draw_calls_; }
+        [[nodiscard]] std::size_t program_switches() const { return program_switches_; }
+        [[nodiscard]] std::size_t material_switches() const { return material_switches_; }
+
+    private:
+        //uniform locations are -1 when the program doesn't have them
+        struct ProgramInfo {
+            GLint model_location = -1;
+            GLint instance_offset_location = -1;
+            bool instanced = false;
+        };
+
+        //packets entries_[first_entry, first_entry + instance_count) drawn at once
+        struct Batch {
+            std::uint64_t key = 0;
+            std::uint32_t first_entry = 0;
+            std::uint32_t instance_count = 1;
+            //first DrawInstance of the batch, only for instanced programs
+            std::uint32_t first_instance = 0;
+            bool instanced = false;
+        };
+
+        std::vector<DrawPacket> packets_{};
+        std::vector<SortEntry> entries_{};
+        std::vector<SortEntry> scratch_{};
+        std::vector<Batch> batches_{};
+        std::unordered_map<GLuint, ProgramInfo> programs_{};
+        //DrawInstances of the frame in the streaming buffer
+        GLuint instance_buffer_ = 0;
+        GLintptr instance_offset_ = 0;
+        GLsizeiptr instance_size_ = 0;
+        std::size_t program_switches_ = 0;
+        std::size_t material_switches_ = 0;
+        std::size_t draw_calls_ = 0;
+
+        const ProgramInfo &Program(GLuint program);
+    };
+
+    //same mesh, textures and state, only the model, the instance data and the material id differ
+    bool CanMergeDraws(const DrawPacket &first, const DrawPacket &second);
+
+    //view depth of the origin of a model matrix
+    inline float ViewDepth(const glm::mat4 &view, const glm::mat4 &model) {
+        return -(view * model[3]).z;
+    }
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_RENDER_QUEUE_H
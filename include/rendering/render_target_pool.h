@@ -0,0 +1,72 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_RENDER_TARGET_POOL_H
+#define SAMPLES_OPENGL_RENDER_TARGET_POOL_H
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace gpr {
+
+    //texture of a render target, two targets with the same description can share the same GL texture
+    struct RenderTargetDesc {
+        GLsizei width = 0;
+        GLsizei height = 0;
+        GLenum internal_format = GL_RGBA8;
+        GLenum filter = GL_LINEAR;
+        //GL_CLAMP_TO_BORDER gets a white border (depth 1, nothing in front)
+        GLenum wrap = GL_CLAMP_TO_EDGE;
+        //> 1 -> GL_TEXTURE_2D_MULTISAMPLE, filter and wrap are ignored
+        GLsizei samples = 1;
+
+        bool operator==(const RenderTargetDesc &other) const = default;
+    };
+
+    /**
+     * Textures of the render targets, reused by the passes of a frame and from one frame to the next.
+     * Acquire gives a free texture with the same description (format, size, samples...) or creates one,
+     * Release frees it for the next Acquire of the frame. Nothing is allocated up front : when the window is resized
+     * the new size is simply asked for, and the textures of the old size are deleted after kMaxIdleFrames frames
+     * without being acquired, so the memory follows the size of the window.
+     */
+    class RenderTargetPool {
+    public:
+        //also covers a few frames of a toggled pass before its targets are deleted
+        static constexpr std::uint64_t kMaxIdleFrames = 3;
+
+        //free every texture and delete the idle ones, returns them so the framebuffers using them can go too
+        const std::vector<GLuint> &BeginFrame();
+
+        GLuint Acquire(const RenderTargetDesc &desc);
+
+        void Release(GLuint texture);
+
+        //delete
+        void Delete();
+
+        //textures alive, acquired this frame, and the memory of the alive ones
+        [[nodiscard]] std::size_t texture_count() const { return textures_.size(); }
+        [[nodiscard]] std::size_t used_count() const { return used_count_; }
+        [[nodiscard]] std::size_t memory_bytes() const;
+
+    private:
+        struct PooledTexture {
+            RenderTargetDesc desc{};
+            GLuint name = 0;
+            bool in_use = false;
+            std::uint64_t last_used_frame = 0;
+        };
+
+        std::vector<PooledTexture> textures_{};
+        std::vector<GLuint> deleted_{};
+        std::uint64_t frame_ = 0;
+        std::size_t used_count_ = 0;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_RENDER_TARGET_POOL_H
@@ -0,0 +1,46 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_SAMPLES_PASSED_QUERY_H
+#define SAMPLES_OPENGL_SAMPLES_PASSED_QUERY_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstdint>
+
+namespace gpr {
+
+    /**
+     * Counts the samples passing the depth test (the fragments shaded) between Begin and End.
+     * Each frame uses its own query of a ring, the result is read kLatency frames later if the GPU has it,
+     * so nothing stalls. Divided by the pixels of the target it gives the overdraw of the draws.
+     */
+    class SamplesPassedQuery {
+    public:
+        static constexpr std::size_t kLatency = 3;
+
+        void Create();
+
+        //read the oldest query of the ring if it is done, then start counting
+        void Begin();
+
+        void End();
+
+        void Delete();
+
+        //last result read back, 0 until the first one is
+        [[nodiscard]] std::uint64_t samples() const { return samples_; }
+
+    private:
+        std::array<GLuint, kLatency> queries_{};
+        //the queries of the ring that were begun at least once
+        std::array<bool, kLatency> issued_{};
+        std::size_t next_ = 0;
+        std::uint64_t samples_ = 0;
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_SAMPLES_PASSED_QUERY_H
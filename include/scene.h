@@ -14,6 +14,8 @@ namespace gpr
         virtual void Update(float dt) = 0;
         virtual void DrawImGui() {}
         virtual void OnEvent(const SDL_Event& event, float dt) {}
+        //size of the window in pixels, once before Begin then after every resize
+        virtual void OnResize(int width, int height) {}
     };
 
 } // namespace gpr
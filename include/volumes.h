@@ -5,133 +5,113 @@
 #ifndef SAMPLES_OPENGL_VOLUMES_H
 #define SAMPLES_OPENGL_VOLUMES_H
 
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
 struct Sphere {
 private:
     glm::vec3 center_{0.f, 0.f, 0.f};
     float radius_{10.f};
 
 public:
+    Sphere() = default;
+
     Sphere(const glm::vec3 &inCenter, float inRadius) : center_{inCenter}, radius_{inRadius} {}
 
     [[nodiscard]] glm::vec3 center() const{return center_;}
     [[nodiscard]] float radius() const{return radius_;}
 };
 
+//axis aligned box, empty (min > max) until a point is added
+struct AABB {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
 
+    AABB() = default;
 
+    AABB(const glm::vec3 &inMin, const glm::vec3 &inMax) : min{inMin}, max{inMax} {}
 
+    static AABB FromCenterExtents(const glm::vec3 &center, const glm::vec3 &extents) {
+        return {center - extents, center + extents};
+    }
 
-//
-//
-//struct SquareAABB : public BoundingVolume {
-//    glm::vec3 center{0.f, 0.f, 0.f};
-//    float extent{0.f};
-//
-//    SquareAABB(const glm::vec3 &inCenter, float inExtent)
-//            : BoundingVolume{}, center{inCenter}, extent{inExtent} {}
-//
-//    [[nodiscard]] bool isOnOrForwardPlane(const Plane &plane) const final {
-//        // Compute the projection interval radius of b onto L(t) = b.c + t * p.n
-//        const float r = extent * (std::abs(plane.normal.x) + std::abs(plane.normal.y) + std::abs(plane.normal.z));
-//        return -r <= plane.GetSignedDistanceToPlaneFromACircle(center);
-//    }
-//
-//    [[nodiscard]] bool isOnFrustum(const Frustum &camFrustum, const Transform &transform) const final {
-//        //Get global scale thanks to our transform
-//        const glm::vec3 globalCenter{transform.getModelMatrix() * glm::vec4(center, 1.f)};
-//
-//        // Scaled orientation
-//        const glm::vec3 right = transform.getRight() * extent;
-//        const glm::vec3 up = transform.getUp() * extent;
-//        const glm::vec3 forward = transform.getForward() * extent;
-//
-//        const float newIi = std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, forward));
-//
-//        const float newIj = std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, forward));
-//
-//        const float newIk = std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, forward));
-//
-//        const SquareAABB globalAABB(globalCenter, std::fmax(std::fmax(newIi, newIj), newIk));
-//
-//        return (globalAABB.isOnOrForwardPlane(camFrustum.leftFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.rightFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.topFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.bottomFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.nearFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.farFace));
-//    };
-//};
-//
-//struct AABB : public BoundingVolume {
-//    glm::vec3 center{0.f, 0.f, 0.f};
-//    glm::vec3 extents{0.f, 0.f, 0.f};
-//
-//    AABB(const glm::vec3 &min, const glm::vec3 &max)
-//            : BoundingVolume{}, center{(max + min) * 0.5f},
-//              extents{max.x - center.x, max.y - center.y, max.z - center.z} {}
-//
-//    AABB(const glm::vec3 &inCenter, float iI, float iJ, float iK)
-//            : BoundingVolume{}, center{inCenter}, extents{iI, iJ, iK} {}
-//
-//    [[maybe_unused]] [[nodiscard]] std::array<glm::vec3, 8> getVertices() const {
-//        std::array<glm::vec3, 8> vertices{};
-//        vertices[0] = {center.x - extents.x, center.y - extents.y, center.z - extents.z};
-//        vertices[1] = {center.x + extents.x, center.y - extents.y, center.z - extents.z};
-//        vertices[2] = {center.x - extents.x, center.y + extents.y, center.z - extents.z};
-//        vertices[3] = {center.x + extents.x, center.y + extents.y, center.z - extents.z};
-//        vertices[4] = {center.x - extents.x, center.y - extents.y, center.z + extents.z};
-//        vertices[5] = {center.x + extents.x, center.y - extents.y, center.z + extents.z};
-//        vertices[6] = {center.x - extents.x, center.y + extents.y, center.z + extents.z};
-//        vertices[7] = {center.x + extents.x, center.y + extents.y, center.z + extents.z};
-//        return vertices;
-//    }
-//
-//
-//    [[nodiscard]] bool isOnOrForwardPlane(const Plane &plane) const final {
-//        // Compute the projection interval radius of b onto L(t) = b.c + t * p.n
-//        const float r = extents.x * std::abs(plane.normal.x) + extents.y * std::abs(plane.normal.y) +
-//                        extents.z * std::abs(plane.normal.z);
-//
-//        return -r <= plane.GetSignedDistanceToPlaneFromACircle(center);
-//    }
-//
-//    [[nodiscard]] bool isOnFrustum(const Frustum &camFrustum, const Transform &transform) const final {
-//        //Get global scale thanks to our transform
-//        const glm::vec3 globalCenter{transform.getModelMatrix() * glm::vec4(center, 1.f)};
-//
-//        // Scaled orientation
-//        const glm::vec3 right = transform.getRight() * extents.x;
-//        const glm::vec3 up = transform.getUp() * extents.y;
-//        const glm::vec3 forward = transform.getForward() * extents.z;
-//
-//        const float newIi = std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{1.f, 0.f, 0.f}, forward));
-//
-//        const float newIj = std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 1.f, 0.f}, forward));
-//
-//        const float newIk = std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, right)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, up)) +
-//                            std::abs(glm::dot(glm::vec3{0.f, 0.f, 1.f}, forward));
-//
-//        const AABB globalAABB(globalCenter, newIi, newIj, newIk);
-//
-//        return (globalAABB.isOnOrForwardPlane(camFrustum.leftFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.rightFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.topFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.bottomFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.nearFace) &&
-//                globalAABB.isOnOrForwardPlane(camFrustum.farFace));
-//    };
-//};
+    void Expand(const glm::vec3 &point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Expand(const AABB &other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    [[nodiscard]] bool IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    [[nodiscard]] glm::vec3 center() const { return (min + max) * 0.5f; }
+    [[nodiscard]] glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+    [[nodiscard]] std::array<glm::vec3, 8> Corners() const {
+        return {glm::vec3(min.x, min.y, min.z), glm::vec3(max.x, min.y, min.z),
+                glm::vec3(min.x, max.y, min.z), glm::vec3(max.x, max.y, min.z),
+                glm::vec3(min.x, min.y, max.z), glm::vec3(max.x, min.y, max.z),
+                glm::vec3(min.x, max.y, max.z), glm::vec3(max.x, max.y, max.z)};
+    }
+
+    /**
+     * World box of the box under a matrix (Arvo) : the center is transformed,
+     * the extents are multiplied by the absolute value of the 3x3 part. Same result as the 8 corners, 3x cheaper.
+     */
+    [[nodiscard]] AABB Transformed(const glm::mat4 &matrix) const {
+        const glm::vec3 worldCenter = glm::vec3(matrix * glm::vec4(center(), 1.0f));
+        const glm::mat3 absolute(glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])),
+                                 glm::abs(glm::vec3(matrix[2])));
+        return FromCenterExtents(worldCenter, absolute * extents());
+    }
+};
+
+//oriented box : center, unit axes (columns) and the half size along each axis
+struct OBB {
+    glm::vec3 center{0.f, 0.f, 0.f};
+    glm::mat3 axes{1.0f};
+    glm::vec3 extents{0.f, 0.f, 0.f};
+
+    OBB() = default;
+
+    //local box placed by a matrix, the scale goes in the extents so the axes stay unit length
+    OBB(const AABB &local, const glm::mat4 &matrix) {
+        center = glm::vec3(matrix * glm::vec4(local.center(), 1.0f));
+        const glm::vec3 scale(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])),
+                              glm::length(glm::vec3(matrix[2])));
+        axes = glm::mat3(glm::vec3(matrix[0]) / scale.x, glm::vec3(matrix[1]) / scale.y,
+                         glm::vec3(matrix[2]) / scale.z);
+        extents = local.extents() * scale;
+    }
+
+    [[nodiscard]] std::array<glm::vec3, 8> Corners() const {
+        std::array<glm::vec3, 8> corners{};
+        for (int i = 0; i < 8; i++) {
+            const glm::vec3 sign((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+            corners[i] = center + axes * (sign * extents);
+        }
+        return corners;
+    }
+
+    //axis aligned box containing the oriented box
+    [[nodiscard]] AABB Bounds() const {
+        const glm::mat3 absolute(glm::abs(axes[0]), glm::abs(axes[1]), glm::abs(axes[2]));
+        return AABB::FromCenterExtents(center, absolute * extents);
+    }
+
+    //half size of the box projected on a direction (used by the plane tests)
+    [[nodiscard]] float ProjectedRadius(const glm::vec3 &direction) const {
+        return extents.x * std::abs(glm::dot(axes[0], direction)) +
+               extents.y * std::abs(glm::dot(axes[1], direction)) +
+               extents.z * std::abs(glm::dot(axes[2], direction));
+    }
+};
 
 
 #endif //SAMPLES_OPENGL_VOLUMES_H
@@ -0,0 +1,63 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#ifndef SAMPLES_OPENGL_WORKER_POOL_H
+#define SAMPLES_OPENGL_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gpr {
+
+    /**
+     * Threads created once and reused every frame (creating threads each frame costs more than the work itself).
+     * Only one ParallelFor runs at a time, the calling thread works too.
+     */
+    class WorkerPool {
+    public:
+        explicit WorkerPool(std::size_t thread_count);
+
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        //call task(i) for every i in [0, count), returns once every call is done
+        void ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task);
+
+        [[nodiscard]] std::size_t thread_count() const { return threads_.size() + 1; }
+
+        //pool shared by the engine, one thread per core minus the main thread
+        static WorkerPool &Instance();
+
+    private:
+        std::vector<std::thread> threads_{};
+        std::mutex submit_mutex_{};
+        std::mutex mutex_{};
+        std::condition_variable wake_{};
+        std::condition_variable finished_{};
+
+        //current job, replaced under mutex_ only when no worker is inside it
+        const std::function<void(std::size_t)> *task_ = nullptr;
+        std::size_t count_ = 0;
+        std::size_t generation_ = 0;
+        std::size_t active_workers_ = 0;
+        std::atomic<std::size_t> next_{0};
+        std::atomic<std::size_t> done_{0};
+        bool stop_ = false;
+
+        void WorkerLoop();
+
+        void RunTasks(const std::function<void(std::size_t)> &task, std::size_t count);
+    };
+
+} // namespace gpr
+
+#endif //SAMPLES_OPENGL_WORKER_POOL_H
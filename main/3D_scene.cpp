@@ -12,6 +12,9 @@
 #include "load3D/texture_loader.h"
 #include "camera.h"
 #include "open_gl_data_structure/vao.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+#include "open_gl_data_structure/streaming_buffer.h"
+#include "rendering/render_queue.h"
 #include "file_utility.h"
 
 #include <sstream>
@@ -62,12 +65,15 @@ namespace gpr {
         VAO quad_vao_;
 
         Camera *camera_ = nullptr;
+        //the cubes are submitted one by one and drawn as one instanced draw
+        RenderQueue render_queue_{};
+        StreamingBuffer instance_stream_{};
         Model *model_ = nullptr;
         Frustum frustum{};
 
         void SetAndBindTextures() const;
 
-        void SetAndDrawMultipleCubes() const;
+        void SetAndDrawMultipleCubes();
 
         void SetTheCubes();
 
@@ -132,7 +138,7 @@ namespace gpr {
         texture[1] = TextureManager::LoadTexture("data/texture/2D/ennemy_01.png");
 
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         vertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexShader_, 1, &ptr, nullptr);
@@ -144,7 +150,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader\n";
         }
         //Load vertex shader light 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/light.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/light.vert");
         ptr = vertexContent.data();
         lightVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(lightVertexShader_, 1, &ptr, nullptr);
@@ -154,7 +160,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for light\n";
         }
         //Load vertex shader model 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/model.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/model.vert");
         ptr = vertexContent.data();
         modelVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(modelVertexShader_, 1, &ptr, nullptr);
@@ -164,7 +170,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for model\n";
         }
         //Load quad vertex shader 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/quad.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/quad.vert");
         ptr = vertexContent.data();
         quadVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(quadVertexShader_, 1, &ptr, nullptr);
@@ -174,7 +180,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for quad\n";
         }
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
         ptr = fragmentContent.data();
         fragmentShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentShader_, 1, &ptr, nullptr);
@@ -185,7 +191,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader\n";
         }
         //Load fragment shaders light 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/light.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/light.frag");
         ptr = fragmentContent.data();
         fragmentLightShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentLightShader_, 1, &ptr, nullptr);
@@ -196,7 +202,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for light\n";
         }
         //Load fragment shaders model 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/model.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/model.frag");
         ptr = fragmentContent.data();
         fragmentModelShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentModelShader_, 1, &ptr, nullptr);
@@ -207,7 +213,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for model\n";
         }
         //Load fragment quad 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/quad.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/quad.frag");
         ptr = fragmentContent.data();
         fragmentquadShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentquadShader_, 1, &ptr, nullptr);
@@ -271,6 +277,7 @@ namespace gpr {
         std::string n = "data/texture/3D/backpack/backpack.obj";
         model_ = new Model(n);
         camera_ = new Camera;
+        instance_stream_.Create(static_cast<GLsizeiptr>(all_cubes_.size() * sizeof(DrawInstance)));
 
         //----------------------------------------------------------- frame buffer / render buffer
 
@@ -327,6 +334,7 @@ namespace gpr {
 
         free(model_);
         free(camera_);
+        instance_stream_.Delete();
         vao_.Delete();
         quad_vao_.Delete();
     }
@@ -464,26 +472,30 @@ namespace gpr {
         //glBindTexture(GL_TEXTURE_2D, texture[1]);
     }
 
-    void ThreeDScene::SetAndDrawMultipleCubes() const {
-        vao_.Bind();
+    void ThreeDScene::SetAndDrawMultipleCubes() {
+        instance_stream_.BeginFrame();
+        render_queue_.Clear();
+
+        DrawPacket cube{};
+        cube.program = program_;
+        cube.textures[0] = texture[0];
+        cube.vao = vao_.name();
+        cube.count = 36;
+        cube.cull_back_faces = true;
+        cube.front_face = GL_CW;
         for (auto current_cube: all_cubes_) {
-            //set matrix model
-            auto model = glm::mat4(1.0f);
-            model = glm::translate(model, current_cube);
-//            float angle = 20.0f + static_cast<float>(i);
-//            model = glm::rotate(model, elapsed_time_ * glm::radians(angle) * cos(elapsed_time_),
-//                                glm::vec3(1.0f, 0.3f, 0.5f));
-//            model = glm::scale(model, glm::vec3(2.0f * cos(elapsed_time_),
-//                                                2.0f * cos(elapsed_time_), 2.0f * cos(elapsed_time_)));
-
-            //apply model matrix
-            int modelLoc = glGetUniformLocation(program_, "model");
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-            if (frustum.IsCubeInFrustum(glm::vec3(current_cube.x, current_cube.y, current_cube.z), 0.5f)) {
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+            if (!frustum.IsCubeInFrustum(current_cube, 0.5f)) {
+                continue;
             }
+            cube.model = glm::translate(glm::mat4(1.0f), current_cube);
+            render_queue_.Submit(cube, ViewDepth(camera_->view(), cube.model));
         }
+        render_queue_.Sort(instance_stream_);
+
+        //the state was set with raw GL until here
+        GLStateCache::Get().Invalidate();
+        render_queue_.Execute(RenderPass::kOpaque);
+        instance_stream_.EndFrame();
     }
 }
 
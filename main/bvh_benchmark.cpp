@@ -0,0 +1,142 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmark_tools.h"
+#include "camera.h"
+#include "culling/bvh.h"
+#include "utility_tools.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+//build time and query cost of the BVH against testing every box, no window needed
+namespace gpr {
+    static constexpr std::size_t kObjectCounts[] = {1'000, 10'000, 100'000, 1'000'000};
+    static constexpr int kRepetitions = 10;
+    static constexpr int kRayCount = 100;
+    static constexpr float kWorldHalfSize = 200.0f;
+
+    static std::vector<AABB> GenerateBoxes(std::size_t count) {
+        std::vector<AABB> boxes;
+        boxes.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            const glm::vec3 center(tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize),
+                                   tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize),
+                                   tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize));
+            const glm::vec3 extents(tools::GenerateRandomNumber(0.25f, 1.0f), tools::GenerateRandomNumber(0.25f, 1.0f),
+                                    tools::GenerateRandomNumber(0.25f, 1.0f));
+            boxes.push_back(AABB::FromCenterExtents(center, extents));
+        }
+        return boxes;
+    }
+
+    //same slab test as the BVH leaves
+    static bool RayHitsBox(const Ray &ray, const AABB &box, float max_distance, float &distance) {
+        const glm::vec3 inverse_direction = 1.0f / ray.direction;
+        const glm::vec3 t0 = (box.min - ray.origin) * inverse_direction;
+        const glm::vec3 t1 = (box.max - ray.origin) * inverse_direction;
+        const glm::vec3 t_min = glm::min(t0, t1);
+        const glm::vec3 t_max = glm::max(t0, t1);
+        distance = std::max(std::max(t_min.x, t_min.y), std::max(t_min.z, 0.0f));
+        return distance <= std::min(std::min(t_max.x, t_max.y), std::min(t_max.z, max_distance));
+    }
+
+    static void RunBenchmark(std::size_t count, const Frustum &frustum) {
+        const std::vector<AABB> boxes = GenerateBoxes(count);
+        std::vector<Ray> rays(kRayCount);
+        for (Ray &ray: rays) {
+            ray.direction = glm::normalize(glm::vec3(tools::GenerateRandomNumber(-1.0f, 1.0f),
+                                                     tools::GenerateRandomNumber(-1.0f, 1.0f),
+                                                     tools::GenerateRandomNumber(-1.0f, 1.0f)));
+        }
+        const AABB query = AABB::FromCenterExtents(glm::vec3(0.0f), glm::vec3(20.0f));
+        std::cout << "\n--- " << count << " boxes ---\n";
+
+        Bvh bvh;
+        std::size_t result = 0;
+        double time = tools::Measure(kRepetitions, [&] {
+            bvh.Build(boxes);
+            return bvh.node_count();
+        }, result);
+        tools::PrintResult("build (nodes)", time, result);
+
+        std::vector<std::uint32_t> indices;
+        time = tools::Measure(kRepetitions, [&] {
+            return static_cast<std::size_t>(std::count_if(boxes.begin(), boxes.end(), [&frustum](const AABB &box) {
+                return frustum.IsAabbInFrustum(box);
+            }));
+        }, result);
+        tools::PrintResult("frustum brute force", time, result);
+        time = tools::Measure(kRepetitions, [&] {
+            indices.clear();
+            bvh.CullFrustum(frustum, indices);
+            return indices.size();
+        }, result);
+        tools::PrintResult("frustum BVH", time, result);
+        std::cout << "    nodes visited : " << bvh.nodes_visited() << "\n";
+
+        //the sum of the hit indices checks both find the same closest box
+        time = tools::Measure(kRepetitions, [&] {
+            std::size_t hits = 0;
+            for (const Ray &ray: rays) {
+                float closest = kWorldHalfSize * 4.0f, distance = 0.0f;
+                std::size_t closest_index = count;
+                for (std::size_t i = 0; i < count; i++) {
+                    if (RayHitsBox(ray, boxes[i], closest, distance) && (closest_index == count || distance < closest)) {
+                        closest = distance;
+                        closest_index = i;
+                    }
+                }
+                hits += closest_index == count ? 0 : closest_index;
+            }
+            return hits;
+        }, result);
+        tools::PrintResult("100 rays brute force", time, result);
+        time = tools::Measure(kRepetitions, [&] {
+            std::size_t hits = 0;
+            for (const Ray &ray: rays) {
+                std::uint32_t index = 0;
+                float distance = 0.0f;
+                if (bvh.Raycast(ray, kWorldHalfSize * 4.0f, index, distance)) {
+                    hits += index;
+                }
+            }
+            return hits;
+        }, result);
+        tools::PrintResult("100 rays BVH", time, result);
+
+        time = tools::Measure(kRepetitions, [&] {
+            return static_cast<std::size_t>(std::count_if(boxes.begin(), boxes.end(), [&query](const AABB &box) {
+                return box.min.x <= query.max.x && box.max.x >= query.min.x && box.min.y <= query.max.y &&
+                       box.max.y >= query.min.y && box.min.z <= query.max.z && box.max.z >= query.min.z;
+            }));
+        }, result);
+        tools::PrintResult("box query brute force", time, result);
+        time = tools::Measure(kRepetitions, [&] {
+            indices.clear();
+            bvh.QueryBox(query, indices);
+            return indices.size();
+        }, result);
+        tools::PrintResult("box query BVH", time, result);
+    }
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    const glm::mat4 projection = glm::perspective(std::numbers::pi_v<float> / 2, 1200.0f / 800.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum;
+    frustum.CreateFrustumFromMatrix(projection * view);
+
+    for (const std::size_t count: gpr::kObjectCounts) {
+        gpr::RunBenchmark(count, frustum);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,10 @@
 #include "camera.h"
 #include "open_gl_data_structure/vao.h"
 #include "open_gl_data_structure/vbo.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+#include "open_gl_data_structure/streaming_buffer.h"
+#include "rendering/render_queue.h"
+#include "rendering/primitives.h"
 #include "file_utility.h"
 
 #include <sstream>
@@ -77,18 +81,20 @@ namespace gpr {
         VAO vao_;
         VAO cube_vao_;
         VAO skybox_vao_;
-        VAO quad_vao_;
 
         VBO skybox_vbo_{};
         VBO cube_vbo_{};
-        VBO quad_vbo_{};
 
         Camera *camera_ = nullptr;
+        //the cubes are submitted one by one and drawn as one instanced draw
+        RenderQueue render_queue_{};
+        StreamingBuffer instance_stream_{};
+        PrimitiveRegistry primitives_{};
         Frustum frustum{};
 
         void SetAndBindTextures() const;
 
-        void SetAndDrawMultipleCubes() const;
+        void SetAndDrawMultipleCubes();
 
         void SetTheCubes();
 
@@ -162,7 +168,7 @@ namespace gpr {
         cubeMapText_ = TextureManager::loadCubemap(faces);
 
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         vertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexShader_, 1, &ptr, nullptr);
@@ -174,7 +180,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader\n";
         }
         //Load vertex shader light 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/light.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/light.vert");
         ptr = vertexContent.data();
         lightVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(lightVertexShader_, 1, &ptr, nullptr);
@@ -184,7 +190,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for light\n";
         }
         //Load vertex shader map 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/skybox.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/skybox.vert");
         ptr = vertexContent.data();
         cubeMapVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(cubeMapVertexShader_, 1, &ptr, nullptr);
@@ -194,7 +200,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for map\n";
         }
         //Load vertex shader quad 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/quad.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/quad.vert");
         ptr = vertexContent.data();
         quadVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(quadVertexShader_, 1, &ptr, nullptr);
@@ -204,7 +210,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for quad\n";
         }
         //Load vertex shader bloom 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/shader_bloom.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/shader_bloom.vert");
         ptr = vertexContent.data();
         bloomVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(bloomVertexShader_, 1, &ptr, nullptr);
@@ -214,7 +220,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for bloom\n";
         }
         //Load vertex shader blur 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/blur_shader.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         blurVertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(blurVertexShader_, 1, &ptr, nullptr);
@@ -226,7 +232,7 @@ namespace gpr {
 
 
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
         ptr = fragmentContent.data();
         fragmentShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentShader_, 1, &ptr, nullptr);
@@ -237,7 +243,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader\n";
         }
         //Load fragment shaders light 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/light.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/light.frag");
         ptr = fragmentContent.data();
         fragmentLightShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentLightShader_, 1, &ptr, nullptr);
@@ -248,7 +254,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for light\n";
         }
         //Load fragment shaders light 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/skybox.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/skybox.frag");
         ptr = fragmentContent.data();
         fragmentCubeMapShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentCubeMapShader_, 1, &ptr, nullptr);
@@ -259,7 +265,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for cube map\n";
         }
         //Load fragment shaders quad 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/quad.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/quad.frag");
         ptr = fragmentContent.data();
         fragmentquadShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentquadShader_, 1, &ptr, nullptr);
@@ -270,7 +276,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for cube quad\n";
         }
         //Load fragment shaders bloom 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/shader_bloom.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/shader_bloom.frag");
         ptr = fragmentContent.data();
         fragmentbloomShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentbloomShader_, 1, &ptr, nullptr);
@@ -281,7 +287,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for bloom\n";
         }
         //Load fragment shaders bloom light 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/shader_light_bloom.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/shader_light_bloom.frag");
         ptr = fragmentContent.data();
         fragmentbloomLightShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentbloomLightShader_, 1, &ptr, nullptr);
@@ -292,7 +298,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for bloom light\n";
         }
         //Load fragment shaders blur 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/blur_shader.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/blur_shader.frag");
         ptr = fragmentContent.data();
         fragmentblurrShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentblurrShader_, 1, &ptr, nullptr);
@@ -303,7 +309,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for blur\n";
         }
         //Load fragment shaders bloom final 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/final_bloom.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/final_bloom.frag");
         ptr = fragmentContent.data();
         fragmentfinalBlurShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentfinalBlurShader_, 1, &ptr, nullptr);
@@ -399,14 +405,14 @@ namespace gpr {
         vao_.Create();
         skybox_vao_.Create();
         skybox_vbo_.Create();
-        quad_vao_.Create();
-        quad_vbo_.Create();
+        primitives_.Create();
         cube_vao_.Create();
         cube_vbo_.Create();
 
         //----------------------------------------------------------- set pointers
 
         camera_ = new Camera;
+        instance_stream_.Create(static_cast<GLsizeiptr>(all_cubes_.size() * sizeof(DrawInstance)));
 
         //----------------------------------------------------------- set vertices
 
@@ -628,11 +634,11 @@ namespace gpr {
         glDeleteRenderbuffers(1, &render_buffer_);
 
         free(camera_);
+        instance_stream_.Delete();
         vao_.Delete();
         skybox_vao_.Delete();
         skybox_vbo_.Delete();
-        quad_vao_.Delete();
-        quad_vbo_.Delete();
+        primitives_.Delete();
         cube_vao_.Delete();
         cube_vbo_.Delete();
     }
@@ -826,6 +832,8 @@ namespace gpr {
 
         bool horizontal = true, first_iteration = true;
         unsigned int amount = 10;
+        //the passes above bind with raw GL calls, the primitives go through the cache
+        GLStateCache::Get().Invalidate();
         glUseProgram(program_blur_);
         for (unsigned int i = 0; i < amount; i++) {
             glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[horizontal]);
@@ -836,24 +844,7 @@ namespace gpr {
             glBindTexture(GL_TEXTURE_2D, first_iteration ?
                                          colorBuffers_[1]: pingpongColorbuffers[!horizontal]);  // bind texture of other framebuffer (or scene if first iteration)
 
-            float quadVertices[] = {
-                    // positions        // texture Coords
-                    -1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-                    -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-                    1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-                    1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-            };
-            // setup plane VAO
-            quad_vao_.Bind();
-            quad_vbo_.Bind();
-            quad_vbo_.BindData(sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) nullptr);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (3 * sizeof(float)));
-            quad_vao_.Bind();
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            glBindVertexArray(0);
+            primitives_.Draw(Primitive::kFullScreenTriangle);
 
 
             horizontal = !horizontal;
@@ -887,32 +878,12 @@ namespace gpr {
         glUniform1f(glGetUniformLocation(program_final_blur_, "exposure"), exposure);
 
 
-        float quadVertices[] = {
-                // positions        // texture Coords
-                -1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-                -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-                1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-                1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-        };
-        // setup plane VAO
-        quad_vao_.Bind();
-        quad_vbo_.Bind();
-        quad_vbo_.BindData(sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-                              (void *) nullptr);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-                              (void *) (3 * sizeof(float)));
-
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 
         glDepthFunc(GL_LESS); // set depth function back to default
 
-        quad_vao_.Bind();
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
+        primitives_.Draw(Primitive::kFullScreenTriangle);
 
 //        elapsed_time_ += dt;
 //        //Draw program -> cubes
@@ -1032,26 +1003,30 @@ namespace gpr {
         //glBindTexture(GL_TEXTURE_2D, texture[1]);
     }
 
-    void CubeMapScene::SetAndDrawMultipleCubes() const {
-        vao_.Bind();
+    void CubeMapScene::SetAndDrawMultipleCubes() {
+        instance_stream_.BeginFrame();
+        render_queue_.Clear();
+
+        DrawPacket cube{};
+        cube.program = program_;
+        cube.textures[0] = texture_[0];
+        cube.vao = vao_.name();
+        cube.count = 36;
+        cube.cull_back_faces = true;
+        cube.front_face = GL_CW;
         for (auto current_cube: all_cubes_) {
-            //set matrix model
-            auto model = glm::mat4(1.0f);
-            model = glm::translate(model, current_cube);
-//            float angle = 20.0f + static_cast<float>(i);
-//            model = glm::rotate(model, elapsed_time_ * glm::radians(angle) * cos(elapsed_time_),
-//                                glm::vec3(1.0f, 0.3f, 0.5f));
-//            model = glm::scale(model, glm::vec3(2.0f * cos(elapsed_time_),
-//                                                2.0f * cos(elapsed_time_), 2.0f * cos(elapsed_time_)));
-
-            //apply model matrix
-            int modelLoc = glGetUniformLocation(program_, "model");
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-            if (frustum.IsCubeInFrustum(glm::vec3(current_cube.x, current_cube.y, current_cube.z), 0.5f)) {
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+            if (!frustum.IsCubeInFrustum(current_cube, 0.5f)) {
+                continue;
             }
+            cube.model = glm::translate(glm::mat4(1.0f), current_cube);
+            render_queue_.Submit(cube, ViewDepth(camera_->view(), cube.model));
         }
+        render_queue_.Sort(instance_stream_);
+
+        //the state was set with raw GL until here
+        GLStateCache::Get().Invalidate();
+        render_queue_.Execute(RenderPass::kOpaque);
+        instance_stream_.EndFrame();
     }
 
 }
@@ -18,10 +18,29 @@
 #include "engine.h"
 #include "scene.h"
 #include "camera.h"
+#include "load3D/hlod.h"
+#include "load3D/octahedral_impostor.h"
 #include "load3D/texture_loader.h"
 #include "file_utility.h"
 #include "utility_tools.h"
-
+#include "culling/bvh.h"
+#include "culling/gpu_culling.h"
+#include "culling/hi_z_pyramid.h"
+#include "culling/instance_bounds.h"
+#include "culling/light_clusters.h"
+#include "culling/meshlet_culling.h"
+#include "culling/software_occlusion.h"
+#include "culling/spatial_grid.h"
+#include "rendering/frame_graph.h"
+#include "rendering/material_system.h"
+#include "rendering/primitives.h"
+#include "rendering/render_queue.h"
+#include "rendering/samples_passed_query.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+#include "open_gl_data_structure/streaming_buffer.h"
+
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <iostream>
 #include <array>
@@ -29,15 +48,61 @@
 
 namespace gpr {
     static constexpr std::int32_t kTreesCount = 1000;
-    static constexpr std::int32_t kLightsCount = 1;
+    //light 0 casts the shadow and can be moved in ImGui, every light shades the ground through the clusters
+    static constexpr std::int32_t kLightsCount = 512;
+    //instances the render queue can write in the streaming buffer each frame
+    static constexpr std::size_t kMaxQueueInstances = 1024;
     static constexpr std::int32_t kKernelSize = 64;
     static constexpr std::int32_t kShadowWidth = 1024, kShadowHeight = 1024;
-    static constexpr std::int32_t kScreenWidth = 1200, kScreenHeight = 800;
+    //horizontal and vertical passes of the bloom blur, the last one writes bloom target kBloomBlurSteps % 2
+    static constexpr std::int32_t kBloomBlurSteps = 10;
+    //views culled by the GPU each frame, the late view gets the trees uncovered by the occlusion pass
+    static constexpr GLuint kCameraView = 0, kShadowView = 1, kCameraLateView = 2, kCullViewsCount = 3;
+    //software occlusion : only the trunks close to the camera are worth rasterizing
+    static constexpr float kOccluderDistance = 30.0f;
+    //proxies are shrunk so they stay inside the real mesh
+    static constexpr float kOccluderShrink = 0.5f;
+    //point light attenuation, also gives the range used to find what a light touches
+    static constexpr float kLightLinear = 0.09f, kLightQuadratic = 0.032f;
+    //the bright lights would reach the whole scene, the clusters only pay off when the lights stay local
+    static constexpr float kMaxLightRadius = 10.0f;
+    //half size of the emissive cube drawn at each light
+    static constexpr float kLightProxyScale = 0.25f;
+    //layers of the dynamic grid
+    static constexpr std::uint32_t kGridTreeLayer = 1u << 0, kGridLightLayer = 1u << 1, kGridCameraLayer = 1u << 2;
 
     static constexpr float Lerp(float f) {
         return 0.1f + f * (1.0f - 0.1f);
     }
 
+    //distance where the attenuated light falls under 5/256 of its brightest channel
+    static float LightRange(const glm::vec3 &color) {
+        const float brightest = std::max({color.r, color.g, color.b});
+        return (-kLightLinear + std::sqrt(kLightLinear * kLightLinear -
+                                          4.0f * kLightQuadratic * (1.0f - (256.0f / 5.0f) * brightest))) /
+               (2.0f * kLightQuadratic);
+    }
+
+    //where the light is cut (windowed to 0 in the shaders)
+    static float LightRadius(const glm::vec3 &color) {
+        return std::min(LightRange(color), kMaxLightRadius);
+    }
+
+    //box around the vertices of the bottom slice of the tree (model is z-up), shrunk to stay inside the trunk
+    static AABB ComputeTrunkProxy(const Model &model) {
+        const float slice_top = model.bounds_.min.z + (model.bounds_.max.z - model.bounds_.min.z) * 0.25f;
+        AABB slice;
+        for (const auto &mesh: model.meshes_) {
+            for (const auto &vertex: mesh.vertices_) {
+                if (vertex.Position.z <= slice_top) {
+                    slice.Expand(vertex.Position);
+                }
+            }
+        }
+        return AABB::FromCenterExtents(slice.center(),
+                                       slice.extents() * glm::vec3(kOccluderShrink, kOccluderShrink, 1.0f));
+    }
+
     class FinalScene final : public Scene {
     public:
         void Begin() override;
@@ -48,15 +113,18 @@ namespace gpr {
 
         void OnEvent(const SDL_Event &event, float dt) override;
 
+        void OnResize(int width, int height) override;
+
         void DrawImGui() override;
 
     private:
+        //size of the window, the render targets of the frame graph follow it
+        GLsizei screen_width_ = 0, screen_height_ = 0;
         bool reverse_enable_ = false;
         bool reverse_gamma_enable_ = true;
         bool bloom = true;
         float exposure = 1.0f;
         float elapsed_time_ = 0.0f;
-        float skybox_vertices_[108]{};
         unsigned int cube_map_text_ = 0;
         unsigned int ground_text_ = 0;
         unsigned int ground_text_normal_ = 0;
@@ -76,10 +144,10 @@ namespace gpr {
         GLuint light_cube_blur_vertex_shader_ = 0;
         GLuint bloom_vertex_shader_ = 0;
         GLuint instancing_vertex_shader_ = 0;
+        GLuint instancing_depth_vertex_shader_ = 0;
         GLuint depth_map_making_vertex_shader_ = 0;
         GLuint shadow_vertex_shader_ = 0;
         GLuint normal_mapping_vertex_shader_ = 0;
-        GLuint geometry_pass_vertex_shader_ = 0;
         GLuint lighting_pass_vertex_shader_ = 0;
         GLuint ssao_vertex_shader_ = 0;
         GLuint ssao_blur_vertex_shader_ = 0;
@@ -93,10 +161,10 @@ namespace gpr {
         GLuint light_cube_blur_fragment_shader_ = 0;
         GLuint bloom_fragment_shader_ = 0;
         GLuint instancing_fragment_shader_ = 0;
+        GLuint instancing_depth_fragment_shader_ = 0;
         GLuint depth_map_making_fragment_shader_ = 0;
         GLuint shadow_fragment_shader_ = 0;
         GLuint normal_mapping_fragment_shader_ = 0;
-        GLuint geometry_pass_fragment_shader_ = 0;
         GLuint lighting_pass_fragment_shader_ = 0;
         GLuint ssao_fragment_shader_ = 0;
         GLuint ssao_blur_fragment_shader_ = 0;
@@ -110,57 +178,113 @@ namespace gpr {
         GLuint program_light_cube_blur_ = 0;
         GLuint program_bloom_ = 0;
         GLuint program_instancing_ = 0;
+        //culled_instancing.vert with the empty fragment shader, the depth pre-pass of the trees
+        GLuint program_instancing_prepass_ = 0;
+        GLuint program_instancing_depth_ = 0;
         GLuint program_making_depth_map_ = 0;
         GLuint program_shadow_ = 0;
         GLuint program_normal_mapping_ = 0;
-        GLuint program_geometry_pass_ = 0;
         GLuint program_lighting_pass_ = 0;
         GLuint program_ssao_ = 0;
         GLuint program_ssao_blur_ = 0;
 
-        //all frameBuffers-----------------
-        GLuint screen_frame_buffer_ = 0;
-        GLuint depth_buffer = 0;
-        unsigned int g_buffer_ = 0;
-        unsigned int ssao_fbo_ = 0, ssao_blur_fbo_ = 0;
-        unsigned int g_position_ = 0, g_normal_ = 0, g_albedo_ = 0;
+        //render targets and their framebuffers come from the frame graph, rebuilt every frame
+        FrameGraph frame_graph_{};
+        //SSAO on the depth of the forward pass, darkens the scene color before the sky and the light cubes
+        bool ssao_enabled_ = true;
+        //the trees fill the depth first, their color pass then only shades the visible fragments (GL_EQUAL)
+        bool depth_prepass_ = true;
+        //fragments shaded by the scene pass and by the pre-pass, read a few frames late
+        SamplesPassedQuery scene_samples_{};
+        SamplesPassedQuery prepass_samples_{};
         unsigned int noise_texture_ = 0;
-        unsigned int ssao_color_buffer_ = 0, ssao_color_buffer_blur_ = 0;
-        std::array<GLuint, 2> text_for_screen_frame_buffer{};
-        unsigned int ping_pong_fbo_[2]{};
-        unsigned int ping_pong_color_buffers_[2]{};
         std::vector<glm::vec3> ssao_kernel_{};
 
         std::unique_ptr<Model> tree_model_unique_{};
         std::unique_ptr<Model> rock_model_unique_{};
         std::unique_ptr<Camera> camera_{};
         Frustum frustum{};
+        GpuInstanceCuller tree_culler_{};
+        OctahedralImpostor tree_impostor_{};
+        //far regions of the forest are drawn as one merged proxy per cluster
+        HlodClusters tree_hlod_{};
+        //LOD 0 trees are drawn meshlet by meshlet, the back facing and hidden parts are skipped
+        MeshletCuller tree_meshlets_{};
+        bool meshlet_culling_ = true;
+        HiZPyramid hi_z_{};
+        //froxel grid of the camera, each cluster lists the point lights touching it
+        LightClusters light_clusters_{};
+        std::vector<PointLight> point_lights_{};
+        //the light buffer (clusters and light cubes) and the grid are only updated when a light is dragged
+        bool lights_moved_ = true;
+        SoftwareOcclusionCuller software_occlusion_{};
+        bool cpu_occlusion_ = false;
+        std::vector<GLuint> cpu_visibility_{};
+        //data written by the CPU every frame (the CPU visibility), ring of kFramesInFlight partitions
+        StreamingBuffer frame_stream_{};
+        //every bind and toggle of the frame goes through it, the redundant ones are dropped
+        GLStateCache &gl_state_ = GLStateCache::Get();
+        InstanceBounds tree_bounds_{};
+        Bvh tree_bvh_{};
+        std::vector<std::uint32_t> nearby_trees_{};
+        //trees, lights and camera, the lights and camera move every frame
+        SpatialGrid dynamic_grid_{};
+        std::array<SpatialGrid::Handle, kLightsCount> light_handles_{};
+        SpatialGrid::Handle camera_handle_ = SpatialGrid::kInvalidHandle;
+        std::vector<SpatialGrid::Handle> lit_trees_{};
+        SpatialGrid::Handle nearest_tree_ = SpatialGrid::kInvalidHandle;
+        AABB trunk_occluder_{};
+        AABB rock_occluder_{};
+        glm::mat4 rock_model_matrix_{1.0f};
+        std::size_t rock_lod_ = 0;
 
-        VAO skybox_vao_{};
-        VAO quad_vao_{};
         VAO plane_vao_{};
-        VBO skybox_vbo_{};
+        //cube (light cubes), quad (ground), skybox and full-screen triangle (post-processing)
+        PrimitiveRegistry primitives_{};
+        glm::mat4 ground_model_matrix_{1.0f};
+        //ground, rock and skybox, submitted once per frame and drawn in key order by each pass
+        RenderQueue render_queue_{};
+        //materials of the rock, read by material_model.frag from the table
+        MaterialSystem materials_{};
 
 
         void SetCameraProperties(const glm::mat4 &projection, GLuint &program) const;
 
         void SetPositionsAndColors();
 
-        static void CreateLightCube();
-
         void RenderScene(const glm::mat4 &projection);
 
-        void RenderSceneForDepth(GLuint &pipeline);
+        void RenderLateTrees(const glm::mat4 &projection);
+
+        void DepthPrepass(const glm::mat4 &projection);
+
+        void SoftwareOcclusionPass(const glm::mat4 &view_projection);
+
+        void UpdateDynamicGrid();
 
-        static void RenderQuad();
+        void UploadPointLights();
 
-        void RenderGroundPlane(const glm::mat4 &projection);
+        void SelectRockLod(const glm::mat4 &projection);
+
+        void RenderSceneForDepth();
+
+        void SetGroundPlaneUniforms(const glm::mat4 &projection);
+
+        [[nodiscard]] glm::mat4 LightView() const;
+
+        void SubmitDraws();
 
         void SetAllPipelines();
 
-        void BloomPass(const glm::mat4 &projection);
+        void RenderFrameGraph(const glm::mat4 &projection, const glm::mat4 &view_projection);
+
+        void BloomBlurPass(FrameGraph &graph, GLuint bright, const std::array<FrameResource, 2> &targets);
+
+        void BloomCompositePass(GLuint scene, GLuint blurred);
+
+        void SsaoPass(const glm::mat4 &projection, GLuint depth);
 
-        void SsaoPass(const glm::mat4 &projection);
+        void SsaoResolvePass(GLuint ssao, GLuint scene);
 
         void ShadowPass();
     };
@@ -222,6 +346,15 @@ namespace gpr {
         }
     }
 
+    void FinalScene::OnResize(int width, int height) {
+        screen_width_ = width;
+        screen_height_ = height;
+        //the frame graph asks its pool for targets of the new size on the next frame, only the pyramid is kept here
+        if (hi_z_.texture() != 0) {
+            hi_z_.Resize(screen_width_, screen_height_);
+        }
+    }
+
     void FinalScene::Begin() {
 #ifdef TRACY_ENABLE
         TracyCZoneN(begin, "Begin", true)
@@ -257,10 +390,8 @@ namespace gpr {
 
         //----------------------------------------------------------- set VAO / VBO
 
-        skybox_vao_.Create();
-        quad_vao_.Create();
+        primitives_.Create();
         plane_vao_.Create();
-        skybox_vbo_.Create();
 
         //----------------------------------------------------------- set pointers
 
@@ -272,6 +403,14 @@ namespace gpr {
         tree_model_unique_ = std::make_unique<Model>(path_1);
         stbi_set_flip_vertically_on_load(false);
         rock_model_unique_ = std::make_unique<Model>(path_2);
+        //the far trees and rocks use simplified meshes (the rock also looks for its authored Megascans tiers)
+        tree_model_unique_->CreateLods();
+        rock_model_unique_->CreateLods();
+        materials_.AddModel(*tree_model_unique_);
+        materials_.AddModel(*rock_model_unique_);
+        materials_.Build();
+        //past the last LOD the trees are cards sampling an atlas of the model
+        tree_impostor_.Bake(*tree_model_unique_);
 
         model_matrices_.resize(kTreesCount);
 
@@ -298,120 +437,58 @@ namespace gpr {
 
         std::cout << "buffer\n";
 
-        VBO buffer_{};
-        buffer_.Create();
-        buffer_.Bind();
-        buffer_.BindData(kTreesCount * sizeof(glm::mat4), &model_matrices_[0], GL_STATIC_DRAW);
-
-        std::cout << "tree model\n";
-
-        for (auto &mesh: tree_model_unique_->meshes_) {
-            VAO temp_ = mesh.vao_;
-            temp_.Bind();
-            // set attribute pointers for matrix (4 times vec4)
-            glEnableVertexAttribArray(3);
-            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) nullptr);
-            glEnableVertexAttribArray(4);
-            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (sizeof(glm::vec4)));
-            glEnableVertexAttribArray(5);
-            glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (2 * sizeof(glm::vec4)));
-            glEnableVertexAttribArray(6);
-            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (3 * sizeof(glm::vec4)));
-
-            glVertexAttribDivisor(3, 1);
-            glVertexAttribDivisor(4, 1);
-            glVertexAttribDivisor(5, 1);
-            glVertexAttribDivisor(6, 1);
-
-            glBindVertexArray(0);
-        }
+        //matrices live in a SSBO, the culling pass picks the visible ones for each view
+        tree_culler_.Create(model_matrices_, *tree_model_unique_, kCullViewsCount, &tree_impostor_);
+        //visibility of the trees and instances of the render queue, plus the alignment between them
+        frame_stream_.Create(static_cast<GLsizeiptr>(kTreesCount * sizeof(GLuint) +
+                                                     kMaxQueueInstances * sizeof(DrawInstance) + 256));
+        tree_hlod_.Build(*tree_model_unique_, model_matrices_);
+        tree_culler_.SetInstanceClusters(tree_hlod_.instance_clusters(), static_cast<GLuint>(tree_hlod_.cluster_count()));
+        //the trees are drawn with CCW front faces
+        tree_meshlets_.Create(*tree_model_unique_, tree_culler_, kCullViewsCount, true);
+        light_clusters_.Create(kLightsCount);
+
+        //software occlusion : world boxes of the trees (they don't move) and the occluder proxies
+        tree_bounds_.Refit(tree_model_unique_->bounds_, model_matrices_);
+        std::vector<AABB> tree_boxes(tree_bounds_.size());
+        for (std::size_t i = 0; i < tree_boxes.size(); i++) {
+            tree_boxes[i] = tree_bounds_.box(i);
+        }
+        tree_bvh_.Build(tree_boxes);
+        for (std::uint32_t i = 0; i < tree_boxes.size(); i++) {
+            dynamic_grid_.Insert(Sphere(tree_boxes[i].center(), glm::length(tree_boxes[i].extents())), i,
+                                 kGridTreeLayer);
+        }
+        for (std::uint32_t i = 0; i < kLightsCount; i++) {
+            light_handles_[i] = dynamic_grid_.Insert(Sphere(light_cube_pos_[i], LightRadius(light_cube_color_[i])), i,
+                                                     kGridLightLayer);
+        }
+        camera_handle_ = dynamic_grid_.Insert(Sphere(camera_->position_, 0.5f), 0, kGridCameraLayer);
+        trunk_occluder_ = ComputeTrunkProxy(*tree_model_unique_);
+        rock_occluder_ = AABB::FromCenterExtents(rock_model_unique_->bounds_.center(),
+                                                 rock_model_unique_->bounds_.extents() * kOccluderShrink);
+        rock_model_matrix_ = glm::translate(glm::mat4(1.0f), glm::vec3(50.0f, -1.0f, 5.0f));
+        rock_model_matrix_ = glm::rotate(rock_model_matrix_, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        rock_model_matrix_ = glm::scale(rock_model_matrix_, glm::vec3(0.1f));
+        ground_model_matrix_ = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+        ground_model_matrix_ = glm::scale(ground_model_matrix_, glm::vec3(100.0f, 100.0f, 100.0f));
+        ground_model_matrix_ = glm::rotate(ground_model_matrix_, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 
 
         //----------------------------------------------------------- frame buffer / render buffer
 
-        static constexpr float skybox_vertices[] = {
-                // positions
-                -1.0f, 1.0f, -1.0f,
-                -1.0f, -1.0f, -1.0f,
-                1.0f, -1.0f, -1.0f,
-                1.0f, -1.0f, -1.0f,
-                1.0f, 1.0f, -1.0f,
-                -1.0f, 1.0f, -1.0f,
-
-                -1.0f, -1.0f, 1.0f,
-                -1.0f, -1.0f, -1.0f,
-                -1.0f, 1.0f, -1.0f,
-                -1.0f, 1.0f, -1.0f,
-                -1.0f, 1.0f, 1.0f,
-                -1.0f, -1.0f, 1.0f,
-
-                1.0f, -1.0f, -1.0f,
-                1.0f, -1.0f, 1.0f,
-                1.0f, 1.0f, 1.0f,
-                1.0f, 1.0f, 1.0f,
-                1.0f, 1.0f, -1.0f,
-                1.0f, -1.0f, -1.0f,
-
-                -1.0f, -1.0f, 1.0f,
-                -1.0f, 1.0f, 1.0f,
-                1.0f, 1.0f, 1.0f,
-                1.0f, 1.0f, 1.0f,
-                1.0f, -1.0f, 1.0f,
-                -1.0f, -1.0f, 1.0f,
-
-                -1.0f, 1.0f, -1.0f,
-                1.0f, 1.0f, -1.0f,
-                1.0f, 1.0f, 1.0f,
-                1.0f, 1.0f, 1.0f,
-                -1.0f, 1.0f, 1.0f,
-                -1.0f, 1.0f, -1.0f,
-
-                -1.0f, -1.0f, -1.0f,
-                -1.0f, -1.0f, 1.0f,
-                1.0f, -1.0f, -1.0f,
-                1.0f, -1.0f, -1.0f,
-                -1.0f, -1.0f, 1.0f,
-                1.0f, -1.0f, 1.0f
-        };
-
-        std::ranges::copy(skybox_vertices, skybox_vertices_);
-
-        //skybox VAO
-        skybox_vao_.Bind();
-        skybox_vbo_.Bind();
-        skybox_vbo_.BindData(sizeof(skybox_vertices_), &skybox_vertices_, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *) nullptr);
-
         glUseProgram(program_cube_map_);
         glUniform1i(glGetUniformLocation(program_cube_map_, "skybox"), 0);
 
-        //create framebuffer ------------------------------------------------------------------------------------------------------
-
-        glGenFramebuffers(1, &depth_buffer);
-        // create depth texture
-        glGenTextures(1, &depth_maps_);
-        glBindTexture(GL_TEXTURE_2D, depth_maps_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, kScreenWidth, kScreenHeight, 0,
-                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        //shadow map, kept from frame to frame and imported in the frame graph
+        glCreateTextures(GL_TEXTURE_2D, 1, &depth_maps_);
+        glTextureStorage2D(depth_maps_, 1, GL_DEPTH_COMPONENT24, kShadowWidth, kShadowHeight);
+        glTextureParameteri(depth_maps_, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(depth_maps_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(depth_maps_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTextureParameteri(depth_maps_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
         float border_color[] = {1.0, 1.0, 1.0, 1.0};
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border_color);
-
-        // attach depth texture as FBO's depth buffer
-        glBindFramebuffer(GL_FRAMEBUFFER, depth_buffer);
-
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_maps_, 0);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "Framebuffer not complete!" << std::endl;
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "Framebuffer not complete!" << std::endl;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glTextureParameterfv(depth_maps_, GL_TEXTURE_BORDER_COLOR, border_color);
 
 
         static constexpr float plane_vertices[] = {
@@ -425,82 +502,22 @@ namespace gpr {
                 25.0f, -0.5f, -25.0f, 0.0f, 1.0f, 0.0f, 25.0f, 25.0f
         };
         // plane VAO
-        plane_vao_.Bind();
         VBO plane_vbo_{};
         plane_vbo_.Create();
-        plane_vbo_.Bind();
-        plane_vbo_.BindData(sizeof(plane_vertices), plane_vertices, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) nullptr);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (3 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (6 * sizeof(float)));
-        glBindVertexArray(0);
-
-        //----------------------------------------
-        glGenFramebuffers(1, &screen_frame_buffer_);
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
-
-        glGenTextures(2, text_for_screen_frame_buffer.data());
-        for (unsigned int i = 0; i < 2; i++) {
-            glBindTexture(GL_TEXTURE_2D, text_for_screen_frame_buffer[i]);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, kScreenWidth, kScreenHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
-                            GL_CLAMP_TO_EDGE);  // we clamp to the edge as the blur filter would otherwise sample repeated texture values!
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            // attach texture to framebuffer
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D,
-                                   text_for_screen_frame_buffer[i], 0);
-            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-                std::cout << "Framebuffer not complete!" << std::endl;
-        }
-        // create and attach depth buffer (renderbuffer)
-        unsigned int rbo_depth_screen;
-        glGenRenderbuffers(1, &rbo_depth_screen);
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo_depth_screen);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, kScreenWidth, kScreenHeight);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo_depth_screen);
-        // tell OpenGL which color attachments we'll use (of this framebuffer) for rendering
-        unsigned int attachments[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
-        glDrawBuffers(2, attachments);
-        // finally check if framebuffer is complete
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "Framebuffer not complete!" << std::endl;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        //check of done correctly + release memory
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << glCheckFramebufferStatus(GL_FRAMEBUFFER)
-                      << std::endl;
-        }
+        plane_vbo_.Storage(sizeof(plane_vertices), plane_vertices);
+        plane_vao_.SetVertexBuffer(0, plane_vbo_, 0, 8 * sizeof(float));
+        plane_vao_.SetAttribute(0, 3, GL_FLOAT, 0);
+        plane_vao_.SetAttribute(1, 3, GL_FLOAT, 3 * sizeof(float));
+        plane_vao_.SetAttribute(2, 2, GL_FLOAT, 6 * sizeof(float));
+
+        hi_z_.Create(screen_width_, screen_height_);
+        scene_samples_.Create();
+        prepass_samples_.Create();
 
         // configure global opengl state
         // -----------------------------
         glEnable(GL_DEPTH_TEST);
 
-        // configure (floating point) framebuffers
-        // ---------------------------------------
-
-        glGenFramebuffers(2, ping_pong_fbo_);
-        glGenTextures(2, ping_pong_color_buffers_);
-        for (unsigned int i = 0; i < 2; i++) {
-            glBindFramebuffer(GL_FRAMEBUFFER, ping_pong_fbo_[i]);
-            glBindTexture(GL_TEXTURE_2D, ping_pong_color_buffers_[i]);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, kScreenWidth, kScreenHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
-                            GL_CLAMP_TO_EDGE); // we clamp to the edge as the blur filter would otherwise sample repeated texture values!
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ping_pong_color_buffers_[i], 0);
-            // also check if framebuffers are complete (no need for depth buffer)
-            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-                std::cout << "Framebuffer not complete!" << std::endl;
-        }
-
         // shader configuration
         // --------------------
         glUseProgram(program_light_cube_blur_);
@@ -509,84 +526,12 @@ namespace gpr {
         glUniform1i(glGetUniformLocation(program_bloom_, "scene"), 0);
         glUniform1i(glGetUniformLocation(program_bloom_, "bloomBlur"), 1);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
 
         glUseProgram(program_normal_mapping_);
         glUniform1i(glGetUniformLocation(program_normal_mapping_, "diffuseMap"), 0);
         glUniform1i(glGetUniformLocation(program_normal_mapping_, "normalMap"), 1);
-
-        // configure g-buffer framebuffer
-        // ------------------------------------------------------------------------------------------------
-
-        glGenFramebuffers(1, &g_buffer_);
-        glBindFramebuffer(GL_FRAMEBUFFER, g_buffer_);
-
-        // position color buffer
-        glGenTextures(1, &g_position_);
-        glBindTexture(GL_TEXTURE_2D, g_position_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, kScreenWidth, kScreenHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_position_, 0);
-        // normal color buffer
-        glGenTextures(1, &g_normal_);
-        glBindTexture(GL_TEXTURE_2D, g_normal_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, kScreenWidth, kScreenHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, g_normal_, 0);
-        // color + specular color buffer
-        glGenTextures(1, &g_albedo_);
-        glBindTexture(GL_TEXTURE_2D, g_albedo_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kScreenWidth, kScreenHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, g_albedo_, 0);
-        // tell OpenGL which color attachments we'll use (of this framebuffer) for rendering
-        unsigned int new_attachments[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
-        glDrawBuffers(3, new_attachments);
-        // create and attach depth buffer (renderbuffer)
-        unsigned int rbo_depth;
-        glGenRenderbuffers(1, &rbo_depth);
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo_depth);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, kScreenWidth, kScreenHeight);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo_depth);
-        // finally check if framebuffer is complete
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "Framebuffer not complete!" << std::endl;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        // also create framebuffer to hold SSAO processing stage
-        // -----------------------------------------------------
-
-        glGenFramebuffers(1, &ssao_blur_fbo_);
-        glGenFramebuffers(1, &ssao_fbo_);
-        glBindFramebuffer(GL_FRAMEBUFFER, ssao_fbo_);
-
-        // SSAO color buffer
-        glGenTextures(1, &ssao_color_buffer_);
-        glBindTexture(GL_TEXTURE_2D, ssao_color_buffer_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, kScreenWidth, kScreenHeight, 0, GL_RED, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ssao_color_buffer_, 0);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "SSAO Framebuffer not complete!" << std::endl;
-
-        // and blur stage
-        glBindFramebuffer(GL_FRAMEBUFFER, ssao_blur_fbo_);
-        glGenTextures(1, &ssao_color_buffer_blur_);
-        glBindTexture(GL_TEXTURE_2D, ssao_color_buffer_blur_);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, kScreenWidth, kScreenHeight, 0, GL_RED, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ssao_color_buffer_blur_, 0);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "SSAO Blur Framebuffer not complete!" << std::endl;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glUniform1f(glGetUniformLocation(program_normal_mapping_, "lightLinear"), kLightLinear);
+        glUniform1f(glGetUniformLocation(program_normal_mapping_, "lightQuadratic"), kLightQuadratic);
 
         // generate sample kernel
         // ----------------------
@@ -627,14 +572,11 @@ namespace gpr {
         // shader configuration
         // --------------------
         glUseProgram(program_lighting_pass_);
-        glUniform1i(glGetUniformLocation(program_lighting_pass_, "gPosition"), 0);
-        glUniform1i(glGetUniformLocation(program_lighting_pass_, "gNormal"), 1);
-        glUniform1i(glGetUniformLocation(program_lighting_pass_, "gAlbedo"), 2);
-        glUniform1i(glGetUniformLocation(program_lighting_pass_, "ssao"), 3);
+        glUniform1i(glGetUniformLocation(program_lighting_pass_, "ssao"), 0);
+        glUniform1i(glGetUniformLocation(program_lighting_pass_, "scene"), 1);
         glUseProgram(program_ssao_);
-        glUniform1i(glGetUniformLocation(program_ssao_, "gPosition"), 0);
-        glUniform1i(glGetUniformLocation(program_ssao_, "gNormal"), 1);
-        glUniform1i(glGetUniformLocation(program_ssao_, "texNoise"), 2);
+        glUniform1i(glGetUniformLocation(program_ssao_, "gDepth"), 0);
+        glUniform1i(glGetUniformLocation(program_ssao_, "texNoise"), 1);
         glUseProgram(program_ssao_blur_);
         glUniform1i(glGetUniformLocation(program_ssao_blur_, "ssaoInput"), 0);
 #ifdef TRACY_ENABLE
@@ -647,11 +589,11 @@ namespace gpr {
         ZoneScoped;
 #endif
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         GLint success;
         //Load vertex shader model 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/model.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/material_model.vert");
         ptr = vertexContent.data();
         model_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(model_vertex_shader_, 1, &ptr, nullptr);
@@ -661,7 +603,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for model\n";
         }
         //Load vertex shader map 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/skybox.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/skybox.vert");
         ptr = vertexContent.data();
         cube_map_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(cube_map_vertex_shader_, 1, &ptr, nullptr);
@@ -671,7 +613,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for map\n";
         }
         //Load vertex shader screen 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/quad.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         screen_quad_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(screen_quad_vertex_shader_, 1, &ptr, nullptr);
@@ -681,7 +623,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for screen\n";
         }
         //Load vertex shader gamma 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/gamma_correction/gamma_correction.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/gamma_correction/gamma_correction.vert");
         ptr = vertexContent.data();
         gamma_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(gamma_vertex_shader_, 1, &ptr, nullptr);
@@ -691,7 +633,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for gamma\n";
         }
         //Load vertex shader light 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/shader_bloom.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/light_cube_instanced.vert");
         ptr = vertexContent.data();
         light_cube_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(light_cube_vertex_shader_, 1, &ptr, nullptr);
@@ -701,7 +643,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for light cube\n";
         }
         //Load vertex shader light blur 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/blur_shader.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         light_cube_blur_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(light_cube_blur_vertex_shader_, 1, &ptr, nullptr);
@@ -711,7 +653,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for blur light cube\n";
         }
         //Load vertex shader bloom 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/blur_shader.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         bloom_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(bloom_vertex_shader_, 1, &ptr, nullptr);
@@ -721,7 +663,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for bloom\n";
         }
         //Load vertex shader instancing 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/rocks_instancing_sample/rocks.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing.vert");
         ptr = vertexContent.data();
         instancing_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(instancing_vertex_shader_, 1, &ptr, nullptr);
@@ -730,8 +672,18 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while loading vertex shader for instancing\n";
         }
+        //Load vertex shader instancing depth 1 ---------------------------------------------------------
+        vertexContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing_depth.vert");
+        ptr = vertexContent.data();
+        instancing_depth_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(instancing_depth_vertex_shader_, 1, &ptr, nullptr);
+        glCompileShader(instancing_depth_vertex_shader_);
+        glGetShaderiv(instancing_depth_vertex_shader_, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            std::cerr << "Error while loading vertex shader for instancing depth\n";
+        }
         //Load vertex shader cube 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/shadow_mapping_depth.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/shadow_mapping_depth.vert");
         ptr = vertexContent.data();
         depth_map_making_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(depth_map_making_vertex_shader_, 1, &ptr, nullptr);
@@ -742,7 +694,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex depth making shader\n";
         }
         //Load vertex shader shadow 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/shadow_mapping.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/shadow_mapping.vert");
         ptr = vertexContent.data();
         shadow_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(shadow_vertex_shader_, 1, &ptr, nullptr);
@@ -753,7 +705,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shadow shader\n";
         }
         //Load vertex shader cube 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/normal_mapping.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/normal_mapping_clustered.vert");
         ptr = vertexContent.data();
         normal_mapping_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(normal_mapping_vertex_shader_, 1, &ptr, nullptr);
@@ -763,19 +715,8 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while loading vertex normal mapping\n";
         }
-        //Load vertex shader geometry pass 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/geometry_pass.vert");
-        ptr = vertexContent.data();
-        geometry_pass_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(geometry_pass_vertex_shader_, 1, &ptr, nullptr);
-        glCompileShader(geometry_pass_vertex_shader_);
-        //Check success status of shader compilation
-        glGetShaderiv(geometry_pass_vertex_shader_, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            std::cerr << "Error while loading vertex geometry pass\n";
-        }
         //Load vertex shader lightning pass 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/lightning_pass.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         lighting_pass_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(lighting_pass_vertex_shader_, 1, &ptr, nullptr);
@@ -786,7 +727,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex lightning pass\n";
         }
         //Load vertex shader ssao 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/ssao.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         ssao_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(ssao_vertex_shader_, 1, &ptr, nullptr);
@@ -797,7 +738,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex ssao\n";
         }
         //Load vertex shader ssao blur 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/ssao_blur.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/full_screen_triangle.vert");
         ptr = vertexContent.data();
         ssao_blur_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(ssao_blur_vertex_shader_, 1, &ptr, nullptr);
@@ -811,9 +752,9 @@ namespace gpr {
         std::cout << "fragment\n";
 
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
         //Load fragment shaders model 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/model.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/material_model.frag");
         ptr = fragmentContent.data();
         model_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(model_fragment_shader_, 1, &ptr, nullptr);
@@ -824,7 +765,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for model\n";
         }
         //Load fragment shaders map 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/skybox.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/skybox.frag");
         ptr = fragmentContent.data();
         cube_map_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(cube_map_fragment_shader_, 1, &ptr, nullptr);
@@ -835,7 +776,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for cube map\n";
         }
         //Load fragment shaders screen 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/quad.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/quad.frag");
         ptr = fragmentContent.data();
         screen_quad_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(screen_quad_fragment_shader_, 1, &ptr, nullptr);
@@ -846,7 +787,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for screen\n";
         }
         //Load fragment shaders gamma 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/gamma_correction/gamma_correction.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/gamma_correction/gamma_correction.frag");
         ptr = fragmentContent.data();
         gamma_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(gamma_fragment_shader_, 1, &ptr, nullptr);
@@ -857,7 +798,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for gamma\n";
         }
         //Load fragment shaders light 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/shader_light_bloom.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/light_cube_instanced.frag");
         ptr = fragmentContent.data();
         light_cube_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(light_cube_fragment_shader_, 1, &ptr, nullptr);
@@ -868,7 +809,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for light cube\n";
         }
         //Load fragment shaders light blur 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/blur_shader.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/blur_shader.frag");
         ptr = fragmentContent.data();
         light_cube_blur_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(light_cube_blur_fragment_shader_, 1, &ptr, nullptr);
@@ -879,7 +820,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for light cube blur\n";
         }
         //Load fragment shaders bloom 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/final_bloom.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/final_bloom.frag");
         ptr = fragmentContent.data();
         bloom_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(bloom_fragment_shader_, 1, &ptr, nullptr);
@@ -890,7 +831,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for bloom\n";
         }
         //Load fragment shaders instancing 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/rocks_instancing_sample/rocks.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing_material.frag");
         ptr = fragmentContent.data();
         instancing_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(instancing_fragment_shader_, 1, &ptr, nullptr);
@@ -900,8 +841,18 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while loading fragment shader for inconstant\n";
         }
+        //Load fragment shaders instancing depth 1 ---------------------------------------------------------
+        fragmentContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing_depth.frag");
+        ptr = fragmentContent.data();
+        instancing_depth_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(instancing_depth_fragment_shader_, 1, &ptr, nullptr);
+        glCompileShader(instancing_depth_fragment_shader_);
+        glGetShaderiv(instancing_depth_fragment_shader_, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            std::cerr << "Error while loading fragment shader for instancing depth\n";
+        }
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/shadow_mapping_depth.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/shadow_mapping_depth.frag");
         ptr = fragmentContent.data();
         depth_map_making_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(depth_map_making_fragment_shader_, 1, &ptr, nullptr);
@@ -912,7 +863,7 @@ namespace gpr {
             std::cerr << "Error while loading depth making fragment shader\n";
         }
         //Load fragment shaders shadow 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/shadow_mapping.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/shadow_mapping.frag");
         ptr = fragmentContent.data();
         shadow_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(shadow_fragment_shader_, 1, &ptr, nullptr);
@@ -923,7 +874,7 @@ namespace gpr {
             std::cerr << "Error while loading shadow fragment shader\n";
         }
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/normal_mapping.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/normal_mapping_clustered.frag");
         ptr = fragmentContent.data();
         normal_mapping_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(normal_mapping_fragment_shader_, 1, &ptr, nullptr);
@@ -933,19 +884,8 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while loading normal mapping fragment shader\n";
         }
-        //Load fragment shaders geometry pass 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/geometry_pass.frag");
-        ptr = fragmentContent.data();
-        geometry_pass_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(geometry_pass_fragment_shader_, 1, &ptr, nullptr);
-        glCompileShader(geometry_pass_fragment_shader_);
-        //Check success status of shader compilation
-        glGetShaderiv(geometry_pass_fragment_shader_, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            std::cerr << "Error while loading geometry pass fragment shader\n";
-        }
         //Load fragment lightning pass 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/lightning_pass.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/all_ssao_neccessity/lightning_pass.frag");
         ptr = fragmentContent.data();
         lighting_pass_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(lighting_pass_fragment_shader_, 1, &ptr, nullptr);
@@ -956,7 +896,7 @@ namespace gpr {
             std::cerr << "Error while loading lightning pass fragment shader\n";
         }
         //Load fragment ssao 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/ssao.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/all_ssao_neccessity/ssao.frag");
         ptr = fragmentContent.data();
         ssao_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(ssao_fragment_shader_, 1, &ptr, nullptr);
@@ -967,7 +907,7 @@ namespace gpr {
             std::cerr << "Error while loading ssao fragment shader\n";
         }
         //Load fragment ssao blur 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/all_ssao_neccessity/ssao_blur.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/all_ssao_neccessity/ssao_blur.frag");
         ptr = fragmentContent.data();
         ssao_blur_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(ssao_blur_fragment_shader_, 1, &ptr, nullptr);
@@ -990,10 +930,11 @@ namespace gpr {
         program_light_cube_blur_ = glCreateProgram();
         program_bloom_ = glCreateProgram();
         program_instancing_ = glCreateProgram();
+        program_instancing_prepass_ = glCreateProgram();
+        program_instancing_depth_ = glCreateProgram();
         program_making_depth_map_ = glCreateProgram();
         program_shadow_ = glCreateProgram();
         program_normal_mapping_ = glCreateProgram();
-        program_geometry_pass_ = glCreateProgram();
         program_lighting_pass_ = glCreateProgram();
         program_ssao_ = glCreateProgram();
         program_ssao_blur_ = glCreateProgram();
@@ -1024,6 +965,12 @@ namespace gpr {
         glAttachShader(program_instancing_, instancing_vertex_shader_);
         glAttachShader(program_instancing_, instancing_fragment_shader_);
 
+        glAttachShader(program_instancing_prepass_, instancing_vertex_shader_);
+        glAttachShader(program_instancing_prepass_, instancing_depth_fragment_shader_);
+
+        glAttachShader(program_instancing_depth_, instancing_depth_vertex_shader_);
+        glAttachShader(program_instancing_depth_, instancing_depth_fragment_shader_);
+
         glAttachShader(program_making_depth_map_, depth_map_making_vertex_shader_);
         glAttachShader(program_making_depth_map_, depth_map_making_fragment_shader_);
 
@@ -1033,9 +980,6 @@ namespace gpr {
         glAttachShader(program_normal_mapping_, normal_mapping_vertex_shader_);
         glAttachShader(program_normal_mapping_, normal_mapping_fragment_shader_);
 
-        glAttachShader(program_geometry_pass_, geometry_pass_vertex_shader_);
-        glAttachShader(program_geometry_pass_, geometry_pass_fragment_shader_);
-
         glAttachShader(program_lighting_pass_, lighting_pass_vertex_shader_);
         glAttachShader(program_lighting_pass_, lighting_pass_fragment_shader_);
 
@@ -1053,10 +997,11 @@ namespace gpr {
         glLinkProgram(program_light_cube_blur_);
         glLinkProgram(program_bloom_);
         glLinkProgram(program_instancing_);
+        glLinkProgram(program_instancing_prepass_);
+        glLinkProgram(program_instancing_depth_);
         glLinkProgram(program_making_depth_map_);
         glLinkProgram(program_shadow_);
         glLinkProgram(program_normal_mapping_);
-        glLinkProgram(program_geometry_pass_);
         glLinkProgram(program_lighting_pass_);
         glLinkProgram(program_ssao_);
         glLinkProgram(program_ssao_blur_);
@@ -1094,6 +1039,14 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while linking instancing shader program\n";
         }
+        glGetProgramiv(program_instancing_prepass_, GL_LINK_STATUS, &success);
+        if (!success) {
+            std::cerr << "Error while linking instancing pre-pass shader program\n";
+        }
+        glGetProgramiv(program_instancing_depth_, GL_LINK_STATUS, &success);
+        if (!success) {
+            std::cerr << "Error while linking instancing depth shader program\n";
+        }
         glGetProgramiv(program_making_depth_map_, GL_LINK_STATUS, &success);
         if (!success) {
             std::cerr << "Error while linking depth making shader program\n";
@@ -1106,10 +1059,6 @@ namespace gpr {
         if (!success) {
             std::cerr << "Error while linking normal mapping shader program\n";
         }
-        glGetProgramiv(program_geometry_pass_, GL_LINK_STATUS, &success);
-        if (!success) {
-            std::cerr << "Error while linking geometry pass shader program\n";
-        }
         glGetProgramiv(program_lighting_pass_, GL_LINK_STATUS, &success);
         if (!success) {
             std::cerr << "Error while linking lightning pass shader program\n";
@@ -1131,13 +1080,14 @@ namespace gpr {
         glDeleteProgram(program_normal_mapping_);
         glDeleteProgram(program_ssao_);
         glDeleteProgram(program_model_);
-        glDeleteProgram(program_geometry_pass_);
         glDeleteProgram(program_bloom_);
         glDeleteProgram(program_light_cube_blur_);
         glDeleteProgram(program_light_cube_);
         glDeleteProgram(program_ssao_blur_);
         glDeleteProgram(program_making_depth_map_);
         glDeleteProgram(program_instancing_);
+        glDeleteProgram(program_instancing_prepass_);
+        glDeleteProgram(program_instancing_depth_);
         glDeleteProgram(program_screen_frame_buffer_);
         glDeleteProgram(program_shadow_);
         glDeleteProgram(program_gamma_);
@@ -1148,13 +1098,13 @@ namespace gpr {
         glDeleteShader(ssao_blur_vertex_shader_);
         glDeleteShader(ssao_vertex_shader_);
         glDeleteShader(lighting_pass_vertex_shader_);
-        glDeleteShader(geometry_pass_vertex_shader_);
         glDeleteShader(shadow_vertex_shader_);
         glDeleteShader(normal_mapping_vertex_shader_);
         glDeleteShader(bloom_vertex_shader_);
         glDeleteShader(light_cube_blur_vertex_shader_);
         glDeleteShader(depth_map_making_vertex_shader_);
         glDeleteShader(instancing_vertex_shader_);
+        glDeleteShader(instancing_depth_vertex_shader_);
         glDeleteShader(light_cube_vertex_shader_);
         glDeleteShader(gamma_vertex_shader_);
         glDeleteShader(screen_quad_vertex_shader_);
@@ -1165,192 +1115,294 @@ namespace gpr {
         glDeleteShader(ssao_blur_fragment_shader_);
         glDeleteShader(ssao_fragment_shader_);
         glDeleteShader(lighting_pass_fragment_shader_);
-        glDeleteShader(geometry_pass_fragment_shader_);
         glDeleteShader(shadow_fragment_shader_);
         glDeleteShader(normal_mapping_fragment_shader_);
         glDeleteShader(bloom_fragment_shader_);
         glDeleteShader(light_cube_blur_fragment_shader_);
         glDeleteShader(depth_map_making_fragment_shader_);
         glDeleteShader(instancing_fragment_shader_);
+        glDeleteShader(instancing_depth_fragment_shader_);
         glDeleteShader(light_cube_fragment_shader_);
         glDeleteShader(gamma_fragment_shader_);
         glDeleteShader(screen_quad_fragment_shader_);
 
-        //delete (framebuffers)
-        glDeleteFramebuffers(1, &screen_frame_buffer_);
-        glDeleteFramebuffers(1, &depth_buffer);
-        glDeleteFramebuffers(1, &g_buffer_);
-        glDeleteFramebuffers(1, &ping_pong_fbo_[0]);
-        glDeleteFramebuffers(1, &ping_pong_fbo_[1]);
-        glDeleteFramebuffers(1, &ssao_fbo_);
-        glDeleteFramebuffers(1, &ssao_blur_fbo_);
-
-        //delete (color buffers)
-        glDeleteBuffers(1, &ssao_color_buffer_);
-        glDeleteBuffers(1, &ssao_color_buffer_blur_);
-        glDeleteBuffers(1, &ping_pong_color_buffers_[0]);
-        glDeleteBuffers(1, &ping_pong_color_buffers_[1]);
+        //delete (render targets and framebuffers)
+        frame_graph_.Delete();
 
         //delete (textures)
-        glDeleteTextures(1, &g_position_);
-        glDeleteTextures(1, &g_normal_);
-        glDeleteTextures(1, &g_albedo_);
+        glDeleteTextures(1, &depth_maps_);
         glDeleteTextures(1, &noise_texture_);
-        glDeleteTextures(1, &text_for_screen_frame_buffer[0]);
-        glDeleteTextures(1, &text_for_screen_frame_buffer[1]);
 
         //delete (vao/vbo)
-        skybox_vao_.Delete();
-        skybox_vbo_.Delete();
-        quad_vao_.Delete();
+        tree_culler_.Delete();
+        frame_stream_.Delete();
+        tree_impostor_.Delete();
+        tree_hlod_.Delete();
+        tree_meshlets_.Delete();
+        light_clusters_.Delete();
+        materials_.Delete();
+        hi_z_.Delete();
+        scene_samples_.Delete();
+        prepass_samples_.Delete();
+        primitives_.Delete();
         plane_vao_.Delete();
     }
 
-    void renderQuad() {
-#ifdef TRACY_ENABLE
-        ZoneScoped;
-#endif
-
-        static constexpr float quadVertices[] = {
-                // positions        // texture Coords
-                -1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-                -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-                1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-                1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-        };
-        VAO cube_vao_{};
-        VBO cube_vbo_{};
-        cube_vao_.Create();
-        cube_vbo_.Create();
-        cube_vao_.Bind();
-        cube_vbo_.Bind();
-        cube_vbo_.BindData(sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) nullptr);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (3 * sizeof(float)));
-
-        cube_vao_.Bind();
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
-    }
-
     void FinalScene::Update(float dt) {
 #ifdef TRACY_ENABLE
         TracyCZoneN(const update, "udate", true)
 #endif
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
+        frame_stream_.BeginFrame();
+        gl_state_.BeginFrame();
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // we're not using the stencil buffer now
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LESS);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        glFrontFace(GL_CW);
+        gl_state_.Enable(GL_DEPTH_TEST);
+        gl_state_.DepthFunc(GL_LESS);
+        gl_state_.Enable(GL_CULL_FACE);
+        gl_state_.CullFace(GL_BACK);
+        gl_state_.FrontFace(GL_CW);
         elapsed_time_ += dt;
         glm::mat4 projection;
 
-        const float aspect = 1200.0f / 800.0f; //see in the engine.Begin() -> window size
+        const float aspect = static_cast<float>(screen_width_) / static_cast<float>(screen_height_);
         const float z_near = 0.1f;
         const float z_far = 100.0f;
         const float fov_y = std::numbers::pi_v<float> / 2;
 
-        frustum.CreateFrustumFromCamera(*camera_, aspect, fov_y, z_near, z_far);
         projection = glm::perspective(fov_y, aspect, z_near, z_far);
+        //built from the matrices so it follows the real orientation of the view
+        const glm::mat4 view_projection = projection * camera_->view();
+        frustum.CreateFrustumFromMatrix(view_projection);
+        tree_culler_.SetLodCamera(camera_->position_, projection);
+        SelectRockLod(projection);
+        if (tree_hlod_.Select(camera_->position_)) {
+            tree_culler_.UploadProxiedClusters(tree_hlod_.proxied());
+        }
+        //occlusion phase 1 -> only the trees that were visible last frame (or not hidden on the CPU)
+        if (cpu_occlusion_) {
+            SoftwareOcclusionPass(view_projection);
+        }
+        tree_culler_.CullPreviouslyVisible(frustum, kCameraView);
+        if (meshlet_culling_) {
+            tree_meshlets_.Cull(tree_culler_, frustum, camera_->position_, kCameraView);
+        }
+        UpdateDynamicGrid();
+        if (lights_moved_) {
+            UploadPointLights();
+            lights_moved_ = false;
+        }
+        light_clusters_.Cull(camera_->view(), projection, z_near, z_far, screen_width_, screen_height_);
+        SubmitDraws();
 
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
+        RenderFrameGraph(projection, view_projection);
 
-        //Render -> Depth map from light perspective ------------------------------------------
-        ShadowPass();
+        //ImGui
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui::NewFrame();
+        DrawImGui();
+        frame_stream_.EndFrame();
+#ifdef TRACY_ENABLE
+        TracyCZoneEnd(update)
+#endif
+    }
 
-        //Render -> scene -----------------------------------------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
-        RenderScene(projection);
+    void FinalScene::RenderFrameGraph(const glm::mat4 &projection, const glm::mat4 &view_projection) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        frame_graph_.Reset();
+        const RenderTargetDesc hdr_desc{screen_width_, screen_height_, GL_RGBA16F};
+        const RenderTargetDesc ssao_desc{screen_width_, screen_height_, GL_R8, GL_NEAREST};
+
+        const FrameResource backbuffer = frame_graph_.Import("Backbuffer", 0, {screen_width_, screen_height_});
+        const FrameResource shadow_map = frame_graph_.Import(
+                "Shadow map", depth_maps_,
+                {kShadowWidth, kShadowHeight, GL_DEPTH_COMPONENT24, GL_NEAREST, GL_CLAMP_TO_BORDER});
+        const FrameResource scene_color = frame_graph_.Create("Scene color", hdr_desc);
+        const FrameResource scene_bright = frame_graph_.Create("Scene bright", hdr_desc);
+        //a texture so the Hi-Z pyramid can read it
+        const FrameResource scene_depth = frame_graph_.Create(
+                "Scene depth", {screen_width_, screen_height_, GL_DEPTH_COMPONENT32F, GL_NEAREST});
+        const FrameResource ssao = frame_graph_.Create("SSAO", ssao_desc);
+        const FrameResource ssao_blurred = frame_graph_.Create("SSAO blurred", ssao_desc);
+        const std::array<FrameResource, 2> bloom_blur = {frame_graph_.Create("Bloom ping", hdr_desc),
+                                                         frame_graph_.Create("Bloom pong", hdr_desc)};
+        const FrameResource tone_mapped = frame_graph_.Create("Tone mapped", hdr_desc);
 
-        //SSAO
-        SsaoPass(projection);
+        //Render -> Depth map from light perspective ------------------------------------------
+        frame_graph_.AddPass("Shadow", [&](FramePassBuilder &builder) {
+            builder.Write(shadow_map);
+        }, [&](FrameGraph &) {
+            ShadowPass();
+        });
+
+        //Render -> depth of the trees, only the positions -----------------------------------------------
+        if (depth_prepass_) {
+            frame_graph_.AddPass("Depth prepass", [&](FramePassBuilder &builder) {
+                builder.Write(scene_depth);
+            }, [&](FrameGraph &) {
+                glClear(GL_DEPTH_BUFFER_BIT);
+                prepass_samples_.Begin();
+                DepthPrepass(projection);
+                prepass_samples_.End();
+            });
+        }
 
+        //Render -> scene -----------------------------------------------------------
+        frame_graph_.AddPass("Scene", [&](FramePassBuilder &builder) {
+            //the trees are shaded with GL_EQUAL against the pre-pass depth, it must not be culled
+            if (depth_prepass_) {
+                builder.Read(scene_depth);
+            }
+            builder.Write(scene_color);
+            builder.Write(scene_bright);
+            builder.Write(scene_depth);
+        }, [&](FrameGraph &) {
+            glClear(depth_prepass_ ? GL_COLOR_BUFFER_BIT : GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            scene_samples_.Begin();
+            RenderScene(projection);
+            scene_samples_.End();
+        });
+
+        //occlusion phase 2 -> test every tree against the depth just drawn, draw the ones that were missed
+        if (!cpu_occlusion_) {
+            frame_graph_.AddPass("Late trees", [&](FramePassBuilder &builder) {
+                builder.Read(scene_depth);
+                builder.Write(scene_color);
+                builder.Write(scene_bright);
+                builder.Write(scene_depth);
+            }, [&](FrameGraph &graph) {
+                hi_z_.Build(graph.texture(scene_depth));
+                tree_culler_.CullOcclusion(frustum, view_projection, hi_z_, kCameraLateView);
+                if (meshlet_culling_) {
+                    tree_meshlets_.CullOcclusion(tree_culler_, frustum, camera_->position_, view_projection, hi_z_,
+                                                 kCameraLateView);
+                }
+                RenderLateTrees(projection);
+            });
+        }
+
+        //SSAO from the depth of the opaque geometry, no second geometry pass
+        if (ssao_enabled_) {
+            frame_graph_.AddPass("SSAO", [&](FramePassBuilder &builder) {
+                builder.Read(scene_depth);
+                builder.Write(ssao);
+            }, [&](FrameGraph &graph) {
+                SsaoPass(projection, graph.texture(scene_depth));
+            });
+            frame_graph_.AddPass("SSAO blur", [&](FramePassBuilder &builder) {
+                builder.Read(ssao);
+                builder.Write(ssao_blurred);
+            }, [&](FrameGraph &graph) {
+                glClear(GL_COLOR_BUFFER_BIT);
+                gl_state_.UseProgram(program_ssao_blur_);
+                gl_state_.BindTexture(0, graph.texture(ssao));
+                primitives_.Draw(Primitive::kFullScreenTriangle);
+            });
+            //before the sky and the light cubes, only the lit geometry is occluded
+            frame_graph_.AddPass("SSAO resolve", [&](FramePassBuilder &builder) {
+                builder.Read(ssao_blurred);
+                builder.Read(scene_color);
+                builder.Write(scene_color);
+            }, [&](FrameGraph &graph) {
+                SsaoResolvePass(graph.texture(ssao_blurred), graph.texture(scene_color));
+            });
+        }
 
         //draw programme -> cube map --------------------------------------------------------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
-        glDisable(GL_CULL_FACE);
-        glDepthFunc(GL_LEQUAL);
-        glUseProgram(program_cube_map_);
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
-        auto view = glm::mat4(glm::mat3(camera_->view())); // remove translation from the view matrix
-        int view_loc_p = glGetUniformLocation(program_cube_map_, "view");
-        glUniformMatrix4fv(view_loc_p,
-                           1, GL_FALSE,
-                           glm::value_ptr(view)
-        );
-        int projection_loc_p = glGetUniformLocation(program_cube_map_, "projection");
-        glUniformMatrix4fv(projection_loc_p,
-                           1, GL_FALSE,
-                           glm::value_ptr(projection)
-        );
-        //skybox cube
-        skybox_vao_.Bind();
-
-        //draw cube map
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cube_map_text_);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
-
+        frame_graph_.AddPass("Sky", [&](FramePassBuilder &builder) {
+            builder.Write(scene_color);
+            builder.Write(scene_bright);
+            builder.Write(scene_depth);
+        }, [&](FrameGraph &) {
+            gl_state_.UseProgram(program_cube_map_);
+            auto view = glm::mat4(glm::mat3(camera_->view())); // remove translation from the view matrix
+            glUniformMatrix4fv(glGetUniformLocation(program_cube_map_, "view"), 1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(program_cube_map_, "projection"), 1, GL_FALSE,
+                               glm::value_ptr(projection));
+            render_queue_.Execute(RenderPass::kSky);
+        });
 
         //Blooming light ----------------------------------------------------------------------------------
-        BloomPass(projection);
+        frame_graph_.AddPass("Light cubes", [&](FramePassBuilder &builder) {
+            builder.Write(scene_color);
+            builder.Write(scene_bright);
+            builder.Write(scene_depth);
+        }, [&](FrameGraph &) {
+            gl_state_.UseProgram(program_light_cube_);
+            SetCameraProperties(projection, program_light_cube_);
+            //one instanced draw for all the cubes, position, color and scale come from the light buffer
+            gl_state_.Disable(GL_CULL_FACE);
+            gl_state_.DepthFunc(GL_LESS);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightClusters::kLightsBinding, light_clusters_.lights_buffer());
+            primitives_.Draw(Primitive::kCube, static_cast<GLsizei>(light_clusters_.light_count()));
+        });
+        frame_graph_.AddPass("Bloom blur", [&](FramePassBuilder &builder) {
+            builder.Read(scene_bright);
+            builder.Write(bloom_blur[0]);
+            builder.Write(bloom_blur[1]);
+        }, [&](FrameGraph &graph) {
+            BloomBlurPass(graph, graph.texture(scene_bright), bloom_blur);
+        });
+        frame_graph_.AddPass("Bloom composite", [&](FramePassBuilder &builder) {
+            builder.Read(scene_color);
+            builder.Read(bloom_blur[kBloomBlurSteps % 2]);
+            builder.Write(tone_mapped);
+        }, [&](FrameGraph &graph) {
+            BloomCompositePass(graph.texture(scene_color), graph.texture(bloom_blur[kBloomBlurSteps % 2]));
+        });
 
         //frame buffer screen ----------------------------------------------------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, 0); // back to default
-//        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-//        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(program_screen_frame_buffer_);
-
-        //set post process
-        glUniform1i(glGetUniformLocation(program_screen_frame_buffer_, "reverse"), reverse_enable_);
-        glUniform1i(glGetUniformLocation(program_screen_frame_buffer_, "reverseGammaEffect"), reverse_gamma_enable_);
-        quad_vao_.Bind();
-        glDisable(GL_DEPTH_TEST);
-        glBindTexture(GL_TEXTURE_2D, text_for_screen_frame_buffer[0]);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        //ImGui
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui::NewFrame();
-        DrawImGui();
-#ifdef TRACY_ENABLE
-        TracyCZoneEnd(update)
-#endif
+        frame_graph_.AddPass("Screen", [&](FramePassBuilder &builder) {
+            builder.Read(tone_mapped);
+            builder.Write(backbuffer);
+        }, [&](FrameGraph &graph) {
+            gl_state_.UseProgram(program_screen_frame_buffer_);
+
+            //set post process
+            glUniform1i(glGetUniformLocation(program_screen_frame_buffer_, "reverse"), reverse_enable_);
+            glUniform1i(glGetUniformLocation(program_screen_frame_buffer_, "reverseGammaEffect"),
+                        reverse_gamma_enable_);
+            gl_state_.Disable(GL_DEPTH_TEST);
+            gl_state_.BindTexture(0, graph.texture(tone_mapped));
+            primitives_.Draw(Primitive::kFullScreenTriangle);
+        });
+
+        frame_graph_.Compile();
+        frame_graph_.Execute();
     }
 
-    void FinalScene::ShadowPass() {//set framebuffer
+    void FinalScene::ShadowPass() {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        glUseProgram(program_making_depth_map_);
-
         glm::mat4 light_projection(1.0f), light_view(1.0f);
         glm::mat4 light_space_matrix(1.0f);
         float near_plane = 0.1f, far_plane = 50.0f;
         //lightProjection = glm::perspective(glm::radians(45.0f), (GLfloat)SHADOW_WIDTH / (GLfloat)SHADOW_HEIGHT, near_plane, far_plane); // note that if you use a perspective projection matrix you'll have to change the light position as the current light position isn't enough to reflect the whole scene
         light_projection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane);
-        light_view = glm::lookAt(light_cube_pos_[0], glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        light_view = LightView();
         light_space_matrix = light_projection * light_view;
-        // render scene from light's point of view
 
+        //only the trees inside the light volume cast a shadow
+        Frustum light_frustum{};
+        light_frustum.CreateFrustumFromMatrix(light_space_matrix);
+        tree_culler_.Cull(light_frustum, kShadowView);
+
+        gl_state_.UseProgram(program_instancing_depth_);
+        glUniformMatrix4fv(glGetUniformLocation(program_instancing_depth_, "lightSpaceMatrix"), 1, GL_FALSE,
+                           glm::value_ptr(light_space_matrix));
+
+        // render scene from light's point of view
+        gl_state_.UseProgram(program_making_depth_map_);
         int light_space_loc_p = glGetUniformLocation(program_making_depth_map_, "lightSpaceMatrix");
         glUniformMatrix4fv(light_space_loc_p, 1, GL_FALSE, glm::value_ptr(light_space_matrix));
 
-        glViewport(0, 0, kShadowWidth, kShadowHeight);
-        glBindFramebuffer(GL_FRAMEBUFFER, depth_buffer);
         glClear(GL_DEPTH_BUFFER_BIT);
 
         //RenderScene(projection);
-        RenderSceneForDepth(program_making_depth_map_);
-
-        // reset viewport
-        glViewport(0, 0, kScreenWidth, kScreenHeight);
+        RenderSceneForDepth();
+        gl_state_.UseProgram(program_making_depth_map_);
+        tree_hlod_.DrawDepth(program_making_depth_map_, light_frustum);
         //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // 2. render scene as normal using the generated depth/shadow map ->
@@ -1399,62 +1451,14 @@ namespace gpr {
 
     }
 
-    void FinalScene::SsaoPass(
-            const glm::mat4 &projection) {
+    void FinalScene::SsaoPass(const glm::mat4 &projection, GLuint depth) {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        // 1. geometry pass: render scene's geometry/color data into gbuffer
-// -----------------------------------------------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, g_buffer_);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glUseProgram(program_geometry_pass_);
-        SetCameraProperties(projection, program_geometry_pass_);
-        // room cube
-        auto model = glm::mat4(1.0f);
-        glUniform1i(glGetUniformLocation(program_geometry_pass_, "invertedNormals"), 0);
-        // backpack model on the floor
-
-        for (int i = 0; i < tree_model_unique_->meshes_.size(); i++) {
-            glUniformMatrix4fv(glGetUniformLocation(program_geometry_pass_, "model"), 1, GL_FALSE,
-                               glm::value_ptr(model_matrices_[i]));
-            tree_model_unique_->meshes_[i].vao_.Bind();
-            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(tree_model_unique_->meshes_[i].indices_.size()),
-                                    GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(kTreesCount));
-            glBindVertexArray(0);
-        }
-
-        glDisable(GL_CULL_FACE);
-        glFrontFace(GL_CW);
-        //draw plane -> normal + bin long + gamma---------------------------------------------------------------
-
-        model = glm::mat4(1.0f);
-        // rotate the quad to show normal mapping from multiple directions
-        model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(100.0, 100.0, 100.0));
-        model = glm::rotate(model, static_cast<float>(glm::radians(90.0)), glm::vec3(1.0, 0.0, 0.0));
-
-        glUniformMatrix4fv(glGetUniformLocation(program_geometry_pass_, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        //set uniform
-
-        RenderQuad();
-
-        //draw rock-------------------------------------------------------------------------------------
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(50.0f, -1.0f, 5.0f));
-        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(0.1f));
-        glUniformMatrix4fv(glGetUniformLocation(program_geometry_pass_, "model"), 1, GL_FALSE, glm::value_ptr(model));
-
-        rock_model_unique_->Draw(program_model_);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
         // 2. generate SSAO texture
 // ------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, ssao_fbo_);
         glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(program_ssao_);
+        gl_state_.UseProgram(program_ssao_);
         // Send kernel + rotation
         for (unsigned int i = 0; i < kKernelSize; ++i) {
             std::string path = "samples[" + std::to_string(i) + "]";
@@ -1462,408 +1466,298 @@ namespace gpr {
                         ssao_kernel_[i].z);
         }
         glUniformMatrix4fv(glGetUniformLocation(program_ssao_, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, g_position_);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_normal_);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, noise_texture_);
-        renderQuad();
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-        // 3. blur SSAO texture to remove noise
-// ------------------------------------
-        glBindFramebuffer(GL_FRAMEBUFFER, ssao_blur_fbo_);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(program_ssao_blur_);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, ssao_color_buffer_);
-        renderQuad();
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-        // 4. lighting pass: traditional deferred Blinn-Phong lighting with added screen-space ambient occlusion
-// -----------------------------------------------------------------------------------------------------
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glUseProgram(program_lighting_pass_);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        // send light relevant uniforms
-        glm::vec3 lightPosView = glm::vec3(camera_->view() * glm::vec4(light_cube_pos_[0], 1.0));
-
-        glUniform3f(glGetUniformLocation(program_lighting_pass_, "light.Position"), light_cube_pos_[0].x,
-                    light_cube_pos_[0].y, light_cube_pos_[0].z);
-        glUniform3f(glGetUniformLocation(program_lighting_pass_, "light.Color"), light_cube_color_[0].x,
-                    light_cube_color_[0].y, light_cube_color_[0].z);
-
-        // Update attenuation parameters
-        const float linear = 0.09f;
-        const float quadratic = 0.032f;
-
-        glUniform1f(glGetUniformLocation(program_lighting_pass_, "light.Linear"), linear);
-        glUniform1f(glGetUniformLocation(program_lighting_pass_, "light.Quadratic"), quadratic);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, g_position_);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, g_normal_);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, g_albedo_);
-        glActiveTexture(GL_TEXTURE3); // add extra SSAO texture to lighting pass
-        glBindTexture(GL_TEXTURE_2D, ssao_color_buffer_blur_);
-        renderQuad();
+        //view space positions are rebuilt from the depth
+        glUniformMatrix4fv(glGetUniformLocation(program_ssao_, "inverseProjection"), 1, GL_FALSE,
+                           glm::value_ptr(glm::inverse(projection)));
+        gl_state_.BindTexture(0, depth);
+        gl_state_.BindTexture(1, noise_texture_);
+        primitives_.Draw(Primitive::kFullScreenTriangle);
     }
 
-    void FinalScene::BloomPass(const glm::mat4 &projection) {
+    void FinalScene::SsaoResolvePass(GLuint ssao, GLuint scene) {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        //3 steps :
-
-        //make light cube ----------------------------------------
-// finally show all the light sources as bright cubes
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
-        //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glUseProgram(program_light_cube_);
-        SetCameraProperties(projection, program_light_cube_);
-
-        for (unsigned int i = 0; i < kLightsCount; i++) {
-            auto model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(light_cube_pos_[i]));
-            model = glm::scale(model, glm::vec3(0.25f));
-            int view_loc_p_temp = glGetUniformLocation(program_light_cube_, "model");
-            glUniformMatrix4fv(view_loc_p_temp,
-                               1, GL_FALSE,
-                               glm::value_ptr(model)
-            );
-            view_loc_p_temp = glGetUniformLocation(program_light_cube_, "lightColor");
-            glUniform3f(view_loc_p_temp, light_cube_color_[i].x, light_cube_color_[i].y, light_cube_color_[i].z);
-            CreateLightCube();
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        // 4. resolve: only the ambient share of the forward lighting (alpha of the scene color) is occluded,
+        // each pixel reads itself from the target it writes, the texture barrier makes the scene draws visible to it
+// -----------------------------------------------------------------------------------------------------------------
+        glTextureBarrier();
+        gl_state_.UseProgram(program_lighting_pass_);
+        gl_state_.Disable(GL_DEPTH_TEST);
+        gl_state_.BindTexture(0, ssao);
+        gl_state_.BindTexture(1, scene);
+        primitives_.Draw(Primitive::kFullScreenTriangle);
+        gl_state_.Enable(GL_DEPTH_TEST);
+    }
 
+    void FinalScene::BloomBlurPass(FrameGraph &graph, GLuint bright, const std::array<FrameResource, 2> &targets) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
         // 2. blur bright fragments with two-pass Gaussian Blur
 // --------------------------------------------------
         bool horizontal = true, first_iteration = true;
-        unsigned int amount = 10;
-        glUseProgram(program_light_cube_blur_);
-        for (unsigned int i = 0; i < amount; i++) {
-            glBindFramebuffer(GL_FRAMEBUFFER, ping_pong_fbo_[horizontal]);
+        gl_state_.UseProgram(program_light_cube_blur_);
+        for (std::int32_t i = 0; i < kBloomBlurSteps; i++) {
+            gl_state_.BindFramebuffer(GL_FRAMEBUFFER, graph.Framebuffer({targets[horizontal]}));
             glUniform1i(glGetUniformLocation(program_light_cube_blur_, "horizontal"), horizontal);
-            glBindTexture(GL_TEXTURE_2D, first_iteration ? text_for_screen_frame_buffer[1]
-                                                         : ping_pong_color_buffers_[!horizontal]);  // bind texture of other framebuffer (or scene if first iteration)
-            renderQuad();
+            gl_state_.BindTexture(0, first_iteration ? bright
+                                                     : graph.texture(targets[!horizontal]));  // bind texture of other framebuffer (or scene if first iteration)
+            primitives_.Draw(Primitive::kFullScreenTriangle);
             horizontal = !horizontal;
             if (first_iteration) {
                 first_iteration = false;
             }
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, screen_frame_buffer_);
+    }
 
+    void FinalScene::BloomCompositePass(GLuint scene, GLuint blurred) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
         // 3. now render floating point color buffer to 2D quad and tonemap HDR colors to default framebuffer's (clamped) color range
 // --------------------------------------------------------------------------------------------------------------------------
-//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glUseProgram(program_bloom_);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, text_for_screen_frame_buffer[0]);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, ping_pong_color_buffers_[!horizontal]);
+        gl_state_.UseProgram(program_bloom_);
+        gl_state_.BindTexture(0, scene);
+        gl_state_.BindTexture(1, blurred);
         glUniform1i(glGetUniformLocation(program_bloom_, "bloom"), bloom);
         glUniform1f(glGetUniformLocation(program_bloom_, "exposure"), exposure);
-        renderQuad();
+        primitives_.Draw(Primitive::kFullScreenTriangle);
     }
 
-    void FinalScene::RenderQuad() {
+    void FinalScene::RenderSceneForDepth() {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        // positions
-        glm::vec3 pos1(-1.0f, 1.0f, 0.0f);
-        glm::vec3 pos2(-1.0f, -1.0f, 0.0f);
-        glm::vec3 pos3(1.0f, -1.0f, 0.0f);
-        glm::vec3 pos4(1.0f, 1.0f, 0.0f);
-        // texture coordinates
-        glm::vec2 uv1(0.0f, 1.0f);
-        glm::vec2 uv2(0.0f, 0.0f);
-        glm::vec2 uv3(1.0f, 0.0f);
-        glm::vec2 uv4(1.0f, 1.0f);
-        // normal vector
-        glm::vec3 nm(0.0f, 0.0f, 1.0f);
-
-        // calculate tangent/bitangent vectors of both triangles
-        glm::vec3 tangent1, bitangent1;
-        glm::vec3 tangent2, bitangent2;
-        // triangle 1
-        // ----------
-        glm::vec3 edge1 = pos2 - pos1;
-        glm::vec3 edge2 = pos3 - pos1;
-        glm::vec2 delta_uv1 = uv2 - uv1;
-        glm::vec2 delta_uv2 = uv3 - uv1;
-
-        float f = 1.0f / (delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y);
-
-        tangent1.x = f * (delta_uv2.y * edge1.x - delta_uv1.y * edge2.x);
-        tangent1.y = f * (delta_uv2.y * edge1.y - delta_uv1.y * edge2.y);
-        tangent1.z = f * (delta_uv2.y * edge1.z - delta_uv1.y * edge2.z);
-
-        bitangent1.x = f * (-delta_uv2.x * edge1.x + delta_uv1.x * edge2.x);
-        bitangent1.y = f * (-delta_uv2.x * edge1.y + delta_uv1.x * edge2.y);
-        bitangent1.z = f * (-delta_uv2.x * edge1.z + delta_uv1.x * edge2.z);
-
-        // triangle 2
-        // ----------
-        edge1 = pos3 - pos1;
-        edge2 = pos4 - pos1;
-        delta_uv1 = uv3 - uv1;
-        delta_uv2 = uv4 - uv1;
-
-        f = 1.0f / (delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y);
-
-        tangent2.x = f * (delta_uv2.y * edge1.x - delta_uv1.y * edge2.x);
-        tangent2.y = f * (delta_uv2.y * edge1.y - delta_uv1.y * edge2.y);
-        tangent2.z = f * (delta_uv2.y * edge1.z - delta_uv1.y * edge2.z);
-
-
-        bitangent2.x = f * (-delta_uv2.x * edge1.x + delta_uv1.x * edge2.x);
-        bitangent2.y = f * (-delta_uv2.x * edge1.y + delta_uv1.x * edge2.y);
-        bitangent2.z = f * (-delta_uv2.x * edge1.z + delta_uv1.x * edge2.z);
-
-
-        float quad_vertices[] = {
-                // positions                            // normal                     // texcoords          // tangent                          // bitangent
-                pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent1.x, tangent1.y, tangent1.z,
-                bitangent1.x, bitangent1.y, bitangent1.z,
-                pos2.x, pos2.y, pos2.z, nm.x, nm.y, nm.z, uv2.x, uv2.y, tangent1.x, tangent1.y, tangent1.z,
-                bitangent1.x, bitangent1.y, bitangent1.z,
-                pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent1.x, tangent1.y, tangent1.z,
-                bitangent1.x, bitangent1.y, bitangent1.z,
-
-                pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent2.x, tangent2.y, tangent2.z,
-                bitangent2.x, bitangent2.y, bitangent2.z,
-                pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent2.x, tangent2.y, tangent2.z,
-                bitangent2.x, bitangent2.y, bitangent2.z,
-                pos4.x, pos4.y, pos4.z, nm.x, nm.y, nm.z, uv4.x, uv4.y, tangent2.x, tangent2.y, tangent2.z,
-                bitangent2.x, bitangent2.y, bitangent2.z
-        };
-        // configure plane VAO
-        VAO new_plane_vao{};
-        VBO plane_vbo_{};
-        new_plane_vao.Create();
-        new_plane_vao.Bind();
-        plane_vbo_.Create();
-        plane_vbo_.Bind();
-        plane_vbo_.BindData(sizeof(quad_vertices), &quad_vertices, GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float),
-                              (void *) nullptr);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float),
-                              (void *) (3 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 14 * sizeof(float),
-                              (void *) (6 * sizeof(float)));
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float),
-                              (void *) (8 * sizeof(float)));
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float),
-                              (void *) (11 * sizeof(float)));
-        new_plane_vao.Bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
+        //draw programme -> 3D model --------------------------------------------------------------------------
+        //swap to CCW because tree's triangles are done the oposite way
+        gl_state_.Enable(GL_CULL_FACE);
+        gl_state_.CullFace(GL_BACK);
+        gl_state_.FrontFace(GL_CCW);
+
+        gl_state_.UseProgram(program_instancing_depth_);
+        tree_culler_.Draw(*tree_model_unique_, program_instancing_depth_, kShadowView);
+
+        //ground and rock
+        render_queue_.Execute(RenderPass::kShadow);
     }
 
-    void FinalScene::RenderSceneForDepth(GLuint &pipeline) {
+    void FinalScene::RenderScene(
+            const glm::mat4 &projection) {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
         //draw programme -> 3D model --------------------------------------------------------------------------
         //swap to CCW because tree's triangles are done the oposite way
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        glFrontFace(GL_CCW);
+        gl_state_.Enable(GL_CULL_FACE);
+        gl_state_.CullFace(GL_BACK);
+        gl_state_.FrontFace(GL_CCW);
 
-        for (int i = 0; i < tree_model_unique_->meshes_.size(); i++) {
-            glUniformMatrix4fv(glGetUniformLocation(pipeline, "model"), 1, GL_FALSE,
-                               glm::value_ptr(model_matrices_[i]));
-            tree_model_unique_->meshes_[i].vao_.Bind();
-            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(tree_model_unique_->meshes_[i].indices_.size()),
-                                    GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(kTreesCount));
-            glBindVertexArray(0);
+        //the pre-pass drew the same trees with the same vertex shaders, only the nearest fragment is equal
+        if (depth_prepass_) {
+            gl_state_.DepthFunc(GL_EQUAL);
+            gl_state_.DepthMask(GL_FALSE);
         }
+        gl_state_.UseProgram(program_instancing_);
+        SetCameraProperties(projection, program_instancing_);
 
-        glDisable(GL_CULL_FACE);
-        glFrontFace(GL_CW);
-        //draw plane -> normal + bin long + gamma---------------------------------------------------------------
-
-        auto model = glm::mat4(1.0f);
-        // rotate the quad to show normal mapping from multiple directions
-        model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(100.0, 100.0, 100.0));
-        model = glm::rotate(model, static_cast<float>(glm::radians(90.0)), glm::vec3(1.0, 0.0, 0.0));
+        //the trees and the rock read their textures from the material table
+        materials_.Bind();
+        tree_culler_.Draw(*tree_model_unique_, program_instancing_, kCameraView, meshlet_culling_ ? 1 : 0);
+        if (meshlet_culling_) {
+            tree_meshlets_.Draw(tree_culler_, camera_->view(), projection, kCameraView);
+        }
+        gl_state_.DepthFunc(GL_LESS);
+        gl_state_.DepthMask(GL_TRUE);
 
-        glUniformMatrix4fv(glGetUniformLocation(pipeline, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        //set uniform
+        gl_state_.Disable(GL_CULL_FACE);
+        gl_state_.FrontFace(GL_CW);
+        tree_culler_.DrawImpostors(tree_impostor_, camera_->view(), projection, camera_->position_, kCameraView);
+        tree_hlod_.Draw(camera_->view(), projection, frustum);
+        //draw plane -> normal + bin long + gamma---------------------------------------------------------------
 
-        RenderQuad();
+        SetGroundPlaneUniforms(projection);
 
         //draw rock-------------------------------------------------------------------------------------
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(50.0f, -1.0f, 5.0f));
-        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(0.1f));
-        glUniformMatrix4fv(glGetUniformLocation(pipeline, "model"), 1, GL_FALSE, glm::value_ptr(model));
+        gl_state_.UseProgram(program_model_);
+        SetCameraProperties(projection, program_model_);
 
-        rock_model_unique_->Draw(program_model_);
+        render_queue_.Execute(RenderPass::kOpaque);
     }
 
-    void FinalScene::RenderScene(
-            const glm::mat4 &projection) {
+    void FinalScene::DepthPrepass(const glm::mat4 &projection) {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        //draw programme -> 3D model --------------------------------------------------------------------------
-        //swap to CCW because tree's triangles are done the oposite way
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        glFrontFace(GL_CCW);
-
-        glUseProgram(program_instancing_);
-        SetCameraProperties(projection, program_instancing_);
+        //the impostors write gl_FragDepth and the ground and rock don't overlap much, they keep their single pass
+        gl_state_.Enable(GL_CULL_FACE);
+        gl_state_.CullFace(GL_BACK);
+        gl_state_.FrontFace(GL_CCW);
+        gl_state_.DepthFunc(GL_LESS);
+        gl_state_.DepthMask(GL_TRUE);
+
+        gl_state_.UseProgram(program_instancing_prepass_);
+        SetCameraProperties(projection, program_instancing_prepass_);
+        tree_culler_.Draw(*tree_model_unique_, program_instancing_prepass_, kCameraView, meshlet_culling_ ? 1 : 0);
+        if (meshlet_culling_) {
+            tree_meshlets_.DrawDepth(tree_culler_, camera_->view(), projection, kCameraView);
+        }
+    }
 
-        // draw meteorites
-        glUniform1i(glGetUniformLocation(program_instancing_, "texture_diffuse1"), 0);
-        glActiveTexture(GL_TEXTURE0);
+    void FinalScene::RenderLateTrees(const glm::mat4 &projection) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        gl_state_.Enable(GL_CULL_FACE);
+        gl_state_.CullFace(GL_BACK);
+        gl_state_.FrontFace(GL_CCW);
 
-        glBindTexture(GL_TEXTURE_2D,
-                      tree_model_unique_->textures_loaded_[0].id); // note: we also made the textures_loaded vector public (instead of private) from the model class.
-        for (auto &mesh: tree_model_unique_->meshes_) {
-            mesh.vao_.Bind();
-            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices_.size()),
-                                    GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(kTreesCount));
-            glBindVertexArray(0);
+        gl_state_.UseProgram(program_instancing_);
+        SetCameraProperties(projection, program_instancing_);
+        materials_.Bind();
+        tree_culler_.Draw(*tree_model_unique_, program_instancing_, kCameraLateView, meshlet_culling_ ? 1 : 0);
+        if (meshlet_culling_) {
+            tree_meshlets_.Draw(tree_culler_, camera_->view(), projection, kCameraLateView);
         }
 
-        glDisable(GL_CULL_FACE);
-        glFrontFace(GL_CW);
-        //draw plane -> normal + bin long + gamma---------------------------------------------------------------
+        gl_state_.Disable(GL_CULL_FACE);
+        gl_state_.FrontFace(GL_CW);
+        tree_culler_.DrawImpostors(tree_impostor_, camera_->view(), projection, camera_->position_, kCameraLateView);
+    }
+
+    void FinalScene::SoftwareOcclusionPass(const glm::mat4 &view_projection) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        software_occlusion_.BeginFrame(view_projection);
 
-        RenderGroundPlane(projection);
+        //ground plane (same as the ground quad of the render queue)
+        static constexpr std::array<glm::vec3, 4> kGroundVertices = {
+                glm::vec3(-100.0f, -1.0f, -100.0f), glm::vec3(100.0f, -1.0f, -100.0f),
+                glm::vec3(100.0f, -1.0f, 100.0f), glm::vec3(-100.0f, -1.0f, 100.0f)
+        };
+        static constexpr std::array<std::uint32_t, 6> kGroundIndices = {0, 1, 2, 0, 2, 3};
+        software_occlusion_.AddOccluder(kGroundVertices, kGroundIndices, glm::mat4(1.0f));
+
+        software_occlusion_.AddBoxOccluder(rock_occluder_.min, rock_occluder_.max, rock_model_matrix_);
+        //the BVH gives the trees around the camera without looping over all of them
+        nearby_trees_.clear();
+        tree_bvh_.QueryBox(AABB::FromCenterExtents(camera_->position_, glm::vec3(kOccluderDistance)), nearby_trees_);
+        for (const std::uint32_t i: nearby_trees_) {
+            if (glm::distance(tree_pos_[i], camera_->position_) < kOccluderDistance) {
+                software_occlusion_.AddBoxOccluder(trunk_occluder_.min, trunk_occluder_.max, model_matrices_[i]);
+            }
+        }
+        software_occlusion_.Rasterize();
 
-        //draw rock-------------------------------------------------------------------------------------
-        glUseProgram(program_model_);
-        SetCameraProperties(projection, program_model_);
+        software_occlusion_.TestAabbs(tree_bounds_.batch(), cpu_visibility_);
+        tree_culler_.UploadVisibility(cpu_visibility_, frame_stream_);
+    }
 
-        auto model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(50.0f, -1.0f, 5.0f));
-        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(0.1f));
-        glUniformMatrix4fv(glGetUniformLocation(program_model_, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(glGetUniformLocation(program_model_, "texture_diffuse1"), 0);
-        glActiveTexture(GL_TEXTURE0);
+    void FinalScene::UpdateDynamicGrid() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //the lights can be dragged in ImGui, moving them only touches the grid when they change cell
+        if (lights_moved_) {
+            for (std::uint32_t i = 0; i < kLightsCount; i++) {
+                dynamic_grid_.Move(light_handles_[i], light_cube_pos_[i]);
+            }
+        }
+        dynamic_grid_.Move(camera_handle_, camera_->position_);
 
-        rock_model_unique_->Draw(program_model_);
+        lit_trees_.clear();
+        dynamic_grid_.QuerySphere(dynamic_grid_.bounds(light_handles_[0]), lit_trees_, kGridTreeLayer);
+        nearest_tree_ = dynamic_grid_.Nearest(camera_->position_, kOccluderDistance, kGridTreeLayer);
     }
 
-    void FinalScene::RenderGroundPlane(const glm::mat4 &projection) {
+    void FinalScene::UploadPointLights() {
 #ifdef TRACY_ENABLE
         ZoneScoped;
 #endif
-        glDisable(GL_CULL_FACE);
-        glUseProgram(program_normal_mapping_);
+        point_lights_.resize(kLightsCount);
+        for (std::size_t i = 0; i < kLightsCount; i++) {
+            point_lights_[i].position_radius = glm::vec4(light_cube_pos_[i], LightRadius(light_cube_color_[i]));
+            point_lights_[i].color = glm::vec4(light_cube_color_[i], kLightProxyScale);
+        }
+        light_clusters_.UploadLights(point_lights_);
+    }
 
-        SetCameraProperties(projection, program_normal_mapping_);
-        // render normal-mapped quad
+    void FinalScene::SelectRockLod(const glm::mat4 &projection) {
+        //the rock is drawn alone, its level is picked on the CPU with the same rule as the culling shader
+        const glm::vec3 center = glm::vec3(rock_model_matrix_ *
+                                           glm::vec4(rock_model_unique_->bounding_sphere_.center(), 1.0f));
+        const float radius = rock_model_unique_->bounding_sphere_.radius() * glm::length(glm::vec3(rock_model_matrix_[0]));
+        const float screen_size = ProjectedScreenSize(radius, glm::distance(center, camera_->position_), projection[1][1]);
+        rock_lod_ = SelectLod(rock_model_unique_->lod_screen_sizes_, screen_size, rock_lod_);
+    }
 
-        auto model = glm::mat4(1.0f);
-        // rotate the quad to show normal mapping from multiple directions
-        model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(100.0, 100.0, 100.0));
-        model = glm::rotate(model, static_cast<float>(glm::radians(90.0)), glm::vec3(1.0, 0.0, 0.0));
+    void FinalScene::SetGroundPlaneUniforms(const glm::mat4 &projection) {
+        gl_state_.UseProgram(program_normal_mapping_);
 
-        int model_loc = glGetUniformLocation(program_normal_mapping_, "model");
-        glUniformMatrix4fv(model_loc, 1, GL_FALSE, glm::value_ptr(model));
+        SetCameraProperties(projection, program_normal_mapping_);
 
         int cam_loc = glGetUniformLocation(program_normal_mapping_, "viewPos");
         glUniform3f(cam_loc, camera_->position_.x, camera_->position_.y, camera_->position_.z);
 
-        int light_loc = glGetUniformLocation(program_normal_mapping_, "lightPos");
-        glUniform3f(light_loc, light_cube_pos_[0].x, light_cube_pos_[0].y, light_cube_pos_[0].z);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, ground_text_);
-
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, ground_text_normal_);
-
-        RenderQuad();
+        light_clusters_.Bind(program_normal_mapping_);
     }
 
-    void FinalScene::CreateLightCube() {
-        static constexpr float vertices[] = {
-                // back face
-                -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
-                1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f, // top-right
-                1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, // bottom-right
-                1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f, // top-right
-                -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
-                -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, // top-left
-                // front face
-                -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, // bottom-left
-                1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, // bottom-right
-                1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, // top-right
-                1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, // top-right
-                -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, // top-left
-                -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, // bottom-left
-                // left face
-                -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f, // top-right
-                -1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f, // top-left
-                -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // bottom-left
-                -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // bottom-left
-                -1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, // bottom-right
-                -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f, // top-right
-                // right face
-                1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, // top-left
-                1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // bottom-right
-                1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, // top-right
-                1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // bottom-right
-                1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, // top-left
-                1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, // bottom-left
-                // bottom face
-                -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, // top-right
-                1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f, // top-left
-                1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, // bottom-left
-                1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, // bottom-left
-                -1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, // bottom-right
-                -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, // top-right
-                // top face
-                -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, // top-left
-                1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, // bottom-right
-                1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, // top-right
-                1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, // bottom-right
-                -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, // top-left
-                -1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f  // bottom-left
-        };
+    glm::mat4 FinalScene::LightView() const {
+        return glm::lookAt(light_cube_pos_[0], glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
 
-        VAO cube_vao{};
-        VBO cube_vbo{};
-        cube_vao.Create();
-        cube_vbo.Create();
-        cube_vao.Bind();
-        cube_vbo.Bind();
-        cube_vbo.BindData(sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) nullptr);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (3 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (6 * sizeof(float)));
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        // render Cube
-        cube_vao.Bind();
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
+    void FinalScene::SubmitDraws() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        render_queue_.Clear();
+        const glm::mat4 camera_view = camera_->view();
+        const glm::mat4 light_view = LightView();
+
+        //normal mapped ground, drawn from both sides
+        DrawPacket ground = primitives_.Packet(Primitive::kQuad);
+        ground.program = program_normal_mapping_;
+        ground.model = ground_model_matrix_;
+        ground.material = static_cast<std::uint16_t>(ground_text_);
+        ground.textures = {ground_text_, ground_text_normal_};
+        render_queue_.Submit(ground, ViewDepth(camera_view, ground.model));
+
+        //the rock meshes of the current LOD, one packet per mesh
+        DrawPacket rock{};
+        rock.program = program_model_;
+        rock.model = rock_model_matrix_;
+        rock.indexed = true;
+        for (const Mesh &mesh: rock_model_unique_->lod_meshes(rock_lod_)) {
+            rock.material = mesh.material_;
+            rock.vao = mesh.vao_.name();
+            rock.count = static_cast<GLsizei>(mesh.indices_.size());
+            render_queue_.Submit(rock, ViewDepth(camera_view, rock.model));
+
+            DrawPacket rock_shadow = rock;
+            rock_shadow.pass = RenderPass::kShadow;
+            rock_shadow.program = program_making_depth_map_;
+            rock_shadow.material = 0;
+            rock_shadow.textures = {};
+            render_queue_.Submit(rock_shadow, ViewDepth(light_view, rock.model));
+        }
+
+        DrawPacket ground_shadow = ground;
+        ground_shadow.pass = RenderPass::kShadow;
+        ground_shadow.program = program_making_depth_map_;
+        ground_shadow.material = 0;
+        ground_shadow.textures = {};
+        render_queue_.Submit(ground_shadow, ViewDepth(light_view, ground.model));
+
+        //skybox last, where the depth is still at the far plane
+        DrawPacket skybox = primitives_.Packet(Primitive::kSkybox);
+        skybox.pass = RenderPass::kSky;
+        skybox.program = program_cube_map_;
+        skybox.textures[0] = cube_map_text_;
+        skybox.depth_func = GL_LEQUAL;
+        render_queue_.Submit(skybox, kMaxSortDepth);
+
+        render_queue_.Sort(frame_stream_);
     }
 
     void FinalScene::DrawImGui() {
@@ -1873,9 +1767,49 @@ namespace gpr {
         ImGui::Checkbox("Enable Reverse Gamma effect", &reverse_gamma_enable_);
         ImGui::Checkbox("Enable Bloom", &bloom);
         ImGui::DragFloat("Exposure Level", &exposure);
-        ImGui::DragFloat("Light Position X", &light_cube_pos_[0].x, 1.0f, 0.0f, 10.0f);
-        ImGui::DragFloat("Light Position Y", &light_cube_pos_[0].y, 1.0f, 0.0f, 10.0f);
-        ImGui::DragFloat("Light Position Z", &light_cube_pos_[0].z, 1.0f, 0.0f, 10.0f);
+        lights_moved_ |= ImGui::DragFloat("Light Position X", &light_cube_pos_[0].x, 1.0f, 0.0f, 10.0f);
+        lights_moved_ |= ImGui::DragFloat("Light Position Y", &light_cube_pos_[0].y, 1.0f, 0.0f, 10.0f);
+        lights_moved_ |= ImGui::DragFloat("Light Position Z", &light_cube_pos_[0].z, 1.0f, 0.0f, 10.0f);
+        ImGui::Checkbox("CPU software occlusion", &cpu_occlusion_);
+        if (cpu_occlusion_) {
+            ImGui::Text("Occluder triangles : %zu", software_occlusion_.occluder_triangle_count());
+            ImGui::Text("Trees hidden on the CPU : %zu", software_occlusion_.hidden_count());
+            ImGui::Text("Streaming buffer stalls : %zu", frame_stream_.stall_count());
+        } else {
+            ImGui::Text("Trees occlusion culled : %.1f %%", tree_culler_.occlusion_culled_percent());
+        }
+        ImGui::Text("Trees touched by the light : %zu", lit_trees_.size());
+        ImGui::Text("Clustered lights : %u, %.1f per lit cluster, %u at most, %u clusters full",
+                    light_clusters_.light_count(), light_clusters_.average_cluster_lights(),
+                    light_clusters_.max_cluster_lights(), light_clusters_.overflowed_clusters());
+        ImGui::Checkbox("Meshlet culling (LOD 0 trees)", &meshlet_culling_);
+        if (meshlet_culling_) {
+            ImGui::Text("Meshlets : %zu, LOD 0 triangles drawn : %u / %u", tree_meshlets_.meshlet_count(),
+                        tree_meshlets_.drawn_triangles(), tree_meshlets_.tested_triangles());
+        }
+        ImGui::Text("HLOD proxies : %zu / %zu clusters, %zu drawn, %zu triangles", tree_hlod_.proxied_count(),
+                    tree_hlod_.cluster_count(), tree_hlod_.drawn_proxies(), tree_hlod_.drawn_triangles());
+        ImGui::Text("Rock LOD : %zu / %zu", rock_lod_, rock_model_unique_->lod_count() - 1);
+        ImGui::Text("Materials : %zu in %zu texture arrays", materials_.material_count(), materials_.array_count());
+        ImGui::Text("Render queue : %zu packets in %zu draws, %zu program / %zu material switches",
+                    render_queue_.packet_count(), render_queue_.draw_calls(), render_queue_.program_switches(),
+                    render_queue_.material_switches());
+        ImGui::Text("GL state cache : %zu calls dropped, %zu sent", gl_state_.hit_count(), gl_state_.miss_count());
+        ImGui::Checkbox("SSAO", &ssao_enabled_);
+        ImGui::Checkbox("Depth pre-pass", &depth_prepass_);
+        //1 = every pixel shaded once, the pre-pass only pays off when the scene pass is well above it
+        const auto screen_pixels = static_cast<float>(screen_width_) * static_cast<float>(screen_height_);
+        ImGui::Text("Overdraw : %.2f fragments shaded per pixel, %.2f depth only",
+                    static_cast<float>(scene_samples_.samples()) / screen_pixels,
+                    depth_prepass_ ? static_cast<float>(prepass_samples_.samples()) / screen_pixels : 0.0f);
+        ImGui::Text("Frame graph : %zu / %zu passes culled, %zu targets in %zu textures", frame_graph_.culled_count(),
+                    frame_graph_.pass_count(), frame_graph_.transient_count(), frame_graph_.pool().used_count());
+        ImGui::Text("Render targets : %d x %d, %zu textures, %.1f MB", screen_width_, screen_height_,
+                    frame_graph_.pool().texture_count(),
+                    static_cast<float>(frame_graph_.pool().memory_bytes()) / (1024.0f * 1024.0f));
+        if (nearest_tree_ != SpatialGrid::kInvalidHandle) {
+            ImGui::Text("Nearest tree : %u", dynamic_grid_.user_data(nearest_tree_));
+        }
         ImGui::End();
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
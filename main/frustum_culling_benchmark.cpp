@@ -0,0 +1,116 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmark_tools.h"
+#include "camera.h"
+#include "culling/frustum_batch.h"
+#include "utility_tools.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+//throughput of the frustum tests for 10k to 1M objects, no window needed
+namespace gpr {
+    static constexpr std::size_t kObjectCounts[] = {10'000, 100'000, 1'000'000};
+    static constexpr int kRepetitions = 20;
+    static constexpr float kWorldHalfSize = 200.0f;
+
+    //objects as structure of arrays, boxes are cubes so IsCubeInFrustum can be compared
+    struct BenchmarkObjects {
+        std::vector<float> x, y, z, radius, extent;
+        std::vector<Sphere> spheres;
+
+        explicit BenchmarkObjects(std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                x.push_back(tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize));
+                y.push_back(tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize));
+                z.push_back(tools::GenerateRandomNumber(-kWorldHalfSize, kWorldHalfSize));
+                radius.push_back(tools::GenerateRandomNumber(0.5f, 2.0f));
+                extent.push_back(radius.back() * 0.5f);
+                spheres.emplace_back(glm::vec3(x.back(), y.back(), z.back()), radius.back());
+            }
+        }
+
+        [[nodiscard]] SphereBatch sphere_batch() const { return {x, y, z, radius}; }
+
+        [[nodiscard]] AabbBatch aabb_batch() const { return {x, y, z, extent, extent, extent}; }
+    };
+
+    static std::size_t CountBits(const std::vector<std::uint64_t> &mask, std::size_t count) {
+        std::vector<std::uint32_t> indices;
+        return FrustumBatchCuller::CompactVisible(mask, count, indices);
+    }
+
+    static void RunBenchmark(std::size_t count, const Frustum &frustum) {
+        const BenchmarkObjects objects(count);
+        std::vector<std::uint64_t> mask;
+        std::size_t visible = 0;
+        std::cout << "\n--- " << count << " objects ---\n";
+
+        double time = tools::Measure(kRepetitions, [&] {
+            return static_cast<std::size_t>(std::count_if(objects.spheres.begin(), objects.spheres.end(),
+                                                          [&frustum](const Sphere &sphere) {
+                                                              return frustum.IsSphereInFrustum(sphere);
+                                                          }));
+        }, visible);
+        tools::PrintResult("spheres IsSphereInFrustum", time, visible, count, "visible");
+
+        time = tools::Measure(kRepetitions, [&] {
+            std::size_t inside = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                inside += frustum.IsCubeInFrustum(glm::vec3(objects.x[i], objects.y[i], objects.z[i]),
+                                                  objects.extent[i]);
+            }
+            return inside;
+        }, visible);
+        tools::PrintResult("cubes IsCubeInFrustum", time, visible, count, "visible");
+
+        for (const SimdLevel level: {SimdLevel::kScalar, SimdLevel::kSse, SimdLevel::kAvx2}) {
+            if (level > BestSimdLevel()) {
+                continue;
+            }
+            for (const bool multithreaded: {false, true}) {
+                FrustumBatchCuller culler(level);
+                culler.set_multithreaded(multithreaded);
+                const std::string suffix = std::string(SimdLevelName(level)) + (multithreaded ? " MT" : "");
+
+                time = tools::Measure(kRepetitions, [&] {
+                    culler.CullSpheres(frustum, objects.sphere_batch(), mask);
+                    return CountBits(mask, count);
+                }, visible);
+                tools::PrintResult("spheres batch " + suffix, time, visible, count, "visible");
+
+                time = tools::Measure(kRepetitions, [&] {
+                    culler.CullAabbs(frustum, objects.aabb_batch(), mask);
+                    return CountBits(mask, count);
+                }, visible);
+                tools::PrintResult("boxes batch " + suffix, time, visible, count, "visible");
+            }
+        }
+    }
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    const glm::mat4 projection = glm::perspective(std::numbers::pi_v<float> / 2, 1200.0f / 800.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum;
+    frustum.CreateFrustumFromMatrix(projection * view);
+
+    std::cout << "best instruction set : " << gpr::SimdLevelName(gpr::BestSimdLevel())
+              << ", threads : " << gpr::WorkerPool::Instance().thread_count() << "\n";
+    std::cout << "(time includes CompactVisible to count the visible objects)\n";
+    for (const std::size_t count: gpr::kObjectCounts) {
+        gpr::RunBenchmark(count, frustum);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -99,11 +99,11 @@ namespace gpr {
         floor_texture_gamma_corrected_ = TextureManager::LoadTexture("data/texture/2D/box.jpg", true); //activate gamma
 
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         GLint success;
         //Load vertex shader model 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/gamma_correction/gamma_correction.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/gamma_correction/gamma_correction.vert");
         ptr = vertexContent.data();
         gamma_correction_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(gamma_correction_vertex_shader_, 1, &ptr, nullptr);
@@ -114,9 +114,9 @@ namespace gpr {
         }
 
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
         //Load fragment shaders model 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/gamma_correction/gamma_correction.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/gamma_correction/gamma_correction.frag");
         ptr = fragmentContent.data();
         gamma_correction_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(gamma_correction_fragment_shader_, 1, &ptr, nullptr);
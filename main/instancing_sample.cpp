@@ -15,6 +15,8 @@
 #include "camera.h"
 #include "load3D/texture_loader.h"
 #include "file_utility.h"
+#include "culling/bvh.h"
+#include "culling/gpu_culling.h"
 
 #include <sstream>
 #include <iostream>
@@ -38,7 +40,7 @@ namespace gpr {
         float elapsed_time_ = 0.0f;
         bool reverse_enable_ = false;
         int amount_ = 10000;
-        glm::mat4 *model_matrices_ = nullptr;
+        std::vector<glm::mat4> model_matrices_{};
 
 
         //all vertex shaders-------------
@@ -63,9 +65,14 @@ namespace gpr {
         Camera *camera_ = nullptr;
         Model *rock_ = nullptr;
         Frustum frustum{};
+        GpuInstanceCuller rocks_culler_{};
+        Bvh rocks_bvh_{};
+        //rock under the center of the screen, picked with a ray along the camera front
+        bool rock_picked_ = false;
+        std::uint32_t picked_rock_ = 0;
+        float picked_distance_ = 0.0f;
 
         VAO quad_vao_{};
-        GLuint buffer_ = 0;
 
         void SetView(const glm::mat4 &projection, GLuint &program) const;
     };
@@ -111,8 +118,9 @@ namespace gpr {
 
         std::string path = "data/texture/3D/rock/rock.obj";
         rock_ = new Model(path);
+        rock_->CreateLods();
 
-        model_matrices_ = new glm::mat4[amount_];
+        model_matrices_.resize(amount_);
 
         srand(15678); // initialize random seed
         float radius = 150.0;
@@ -142,38 +150,23 @@ namespace gpr {
         }
 
 
-        glGenBuffers(1, &buffer_);
-        glBindBuffer(GL_ARRAY_BUFFER, buffer_);
-        glBufferData(GL_ARRAY_BUFFER, amount_ * sizeof(glm::mat4), &model_matrices_[0], GL_STATIC_DRAW);
-
-        for (auto &mesh: rock_->meshes_) {
-            VAO temp_ = mesh.vao_;
-            temp_.Bind();
-            // set attribute pointers for matrix (4 times vec4)
-            glEnableVertexAttribArray(3);
-            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) nullptr);
-            glEnableVertexAttribArray(4);
-            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (sizeof(glm::vec4)));
-            glEnableVertexAttribArray(5);
-            glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (2 * sizeof(glm::vec4)));
-            glEnableVertexAttribArray(6);
-            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *) (3 * sizeof(glm::vec4)));
-
-            glVertexAttribDivisor(3, 1);
-            glVertexAttribDivisor(4, 1);
-            glVertexAttribDivisor(5, 1);
-            glVertexAttribDivisor(6, 1);
-
-            glBindVertexArray(0);
+        //matrices live in a SSBO, only the rocks inside the frustum are drawn
+        rocks_culler_.Create(model_matrices_, *rock_, 1);
+
+        //the rocks don't move, the hierarchy is built once for picking
+        std::vector<AABB> rock_boxes(model_matrices_.size());
+        for (std::size_t i = 0; i < rock_boxes.size(); i++) {
+            rock_boxes[i] = rock_->bounds_.Transformed(model_matrices_[i]);
         }
+        rocks_bvh_.Build(rock_boxes);
 
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         GLint success;
         //Load vertex shader model 1 ---------------------------------------------------------
         //Load vertex shader screen 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/quad.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/quad.vert");
         ptr = vertexContent.data();
         screen_quad_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(screen_quad_vertex_shader_, 1, &ptr, nullptr);
@@ -183,7 +176,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader for screen\n";
         }
         //Load vertex shader rocks 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/rocks_instancing_sample/rocks.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing.vert");
         ptr = vertexContent.data();
         rocks_vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(rocks_vertex_shader_, 1, &ptr, nullptr);
@@ -194,10 +187,10 @@ namespace gpr {
         }
 
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
 
         //Load fragment shaders screen 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/quad.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/quad.frag");
         ptr = fragmentContent.data();
         screen_quad_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(screen_quad_fragment_shader_, 1, &ptr, nullptr);
@@ -208,7 +201,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader for screen\n";
         }
         //Load fragment shaders rocks 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/rocks_instancing_sample/rocks.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/culling/culled_instancing.frag");
         ptr = fragmentContent.data();
         rocks_fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(rocks_fragment_shader_, 1, &ptr, nullptr);
@@ -293,6 +286,7 @@ namespace gpr {
     //TODO update the end with screen buffer stuff + gamma correction + lights
     void Instancing::End() {
         //Unload program/pipeline
+        rocks_culler_.Delete();
 
         free(camera_);
     }
@@ -314,8 +308,12 @@ namespace gpr {
         const float zFar = 1000.0f;
         const float fovY = std::numbers::pi_v<float> / 2;
 
-        frustum.CreateFrustumFromCamera(*camera_, aspect, fovY, zNear, zFar);
         projection = glm::perspective(fovY, aspect, zNear, zFar);
+        frustum.CreateFrustumFromMatrix(projection * camera_->view());
+        rocks_culler_.SetLodCamera(camera_->position_, projection);
+        rocks_culler_.Cull(frustum, 0);
+        rock_picked_ = rocks_bvh_.Raycast({camera_->position_, camera_->camera_front_}, zFar,
+                                          picked_rock_, picked_distance_);
 
         //instacing rocks ------------------------------------------------------------------------
         //glDisable(GL_CULL_FACE);
@@ -327,12 +325,7 @@ namespace gpr {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D,
                       rock_->textures_loaded_[0].id); // note: we also made the textures_loaded vector public (instead of private) from the model class.
-        for (auto &mesh: rock_->meshes_) {
-            mesh.vao_.Bind();
-            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices_.size()),
-                                    GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(amount_));
-            glBindVertexArray(0);
-        }
+        rocks_culler_.Draw(*rock_, program_rocks_, 0);
 
 
 
@@ -360,6 +353,12 @@ namespace gpr {
         // Début ImGui
         ImGui::Begin("Controls");
         ImGui::Checkbox("Enable Reverse Post-Processing", &reverse_enable_);
+        if (rock_picked_) {
+            ImGui::Text("Rock picked : %u at %.1f", picked_rock_, picked_distance_);
+        } else {
+            ImGui::Text("Rock picked : none");
+        }
+        ImGui::Text("BVH nodes visited : %zu / %zu", rocks_bvh_.nodes_visited(), rocks_bvh_.node_count());
         ImGui::End();
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -54,8 +54,6 @@ namespace gpr {
 
         void SetAndBindTextures() const;
 
-        void SetAndDrawMultipleCubes() const;
-
         void SetTheCubes();
 
         void SetUniformsProgram(const glm::vec3 &lightPos) const;
@@ -118,7 +116,7 @@ namespace gpr {
         brickwall_normal_ = TextureManager::LoadTexture("data/texture/2D/brickwall_normal.jpg");
 
         //Load vertex shader cube 1 ---------------------------------------------------------
-        auto vertexContent = LoadFile("data/shaders/3D_scene/cube.vert");
+        auto vertexContent = LoadShader("data/shaders/3D_scene/cube.vert");
         auto *ptr = vertexContent.data();
         vertexShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexShader_, 1, &ptr, nullptr);
@@ -130,7 +128,7 @@ namespace gpr {
             std::cerr << "Error while loading vertex shader\n";
         }
         //Load vertex shader cube 1 ---------------------------------------------------------
-        vertexContent = LoadFile("data/shaders/3D_scene/normal_mapping.vert");
+        vertexContent = LoadShader("data/shaders/3D_scene/normal_mapping.vert");
         ptr = vertexContent.data();
         vertexMappingShader_ = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexMappingShader_, 1, &ptr, nullptr);
@@ -142,7 +140,7 @@ namespace gpr {
         }
 
         //Load fragment shaders cube 1 ---------------------------------------------------------
-        auto fragmentContent = LoadFile("data/shaders/3D_scene/cube.frag");
+        auto fragmentContent = LoadShader("data/shaders/3D_scene/cube.frag");
         ptr = fragmentContent.data();
         fragmentShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentShader_, 1, &ptr, nullptr);
@@ -153,7 +151,7 @@ namespace gpr {
             std::cerr << "Error while loading fragment shader\n";
         }
         //Load fragment shaders cube mapping 1 ---------------------------------------------------------
-        fragmentContent = LoadFile("data/shaders/3D_scene/normal_mapping.frag");
+        fragmentContent = LoadShader("data/shaders/3D_scene/normal_mapping.frag");
         ptr = fragmentContent.data();
         fragmentMappingShader_ = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentMappingShader_, 1, &ptr, nullptr);
@@ -255,7 +253,6 @@ namespace gpr {
 //        SetView(projection, program_);
 //        SetAndBindTextures();
 //        SetUniformsProgram(lightPos);
-//        SetAndDrawMultipleCubes();
 
         //normal mapping
         glDisable(GL_CULL_FACE);
@@ -428,29 +425,6 @@ namespace gpr {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texture_[0]);
     }
-
-    void NormalMapping::SetAndDrawMultipleCubes() const {
-        small_cube_vao_.Bind();
-        for (auto current_cube: all_cubes_) {
-            //set matrix model
-            auto model = glm::mat4(1.0f);
-            model = glm::translate(model, current_cube);
-//            float angle = 20.0f + static_cast<float>(i);
-//            model = glm::rotate(model, elapsed_time_ * glm::radians(angle) * cos(elapsed_time_),
-//                                glm::vec3(1.0f, 0.3f, 0.5f));
-//            model = glm::scale(model, glm::vec3(2.0f * cos(elapsed_time_),
-//                                                2.0f * cos(elapsed_time_), 2.0f * cos(elapsed_time_)));
-
-            //apply model matrix
-            int modelLoc = glGetUniformLocation(program_, "model");
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
-
-//            if (frustum.IsCubeInFrustum(glm::vec3(current_cube.x, current_cube.y, current_cube.z), 0.5f)) {
-//                glDrawArrays(GL_TRIANGLES, 0, 36);
-//            }
-        }
-    }
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
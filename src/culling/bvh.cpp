@@ -0,0 +1,310 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    namespace {
+        constexpr float kMiss = std::numeric_limits<float>::max();
+
+        float SurfaceArea(const AABB &box) {
+            if (box.IsEmpty()) {
+                return 0.0f;
+            }
+            const glm::vec3 size = box.max - box.min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        bool Overlaps(const AABB &a, const glm::vec3 &min, const glm::vec3 &max) {
+            return a.min.x <= max.x && a.max.x >= min.x && a.min.y <= max.y && a.max.y >= min.y &&
+                   a.min.z <= max.z && a.max.z >= min.z;
+        }
+
+        //slab test, entry distance or max float when missed
+        float IntersectRayBox(const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                              const glm::vec3 &min, const glm::vec3 &max, float max_distance) {
+            const glm::vec3 t0 = (min - origin) * inverse_direction;
+            const glm::vec3 t1 = (max - origin) * inverse_direction;
+            const glm::vec3 t_min = glm::min(t0, t1);
+            const glm::vec3 t_max = glm::max(t0, t1);
+            const float enter = std::max(std::max(t_min.x, t_min.y), std::max(t_min.z, 0.0f));
+            const float exit = std::min(std::min(t_max.x, t_max.y), std::min(t_max.z, max_distance));
+            return enter <= exit ? enter : kMiss;
+        }
+    }
+
+    void Bvh::Build(std::span<const AABB> boxes) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        boxes_.assign(boxes.begin(), boxes.end());
+        nodes_.clear();
+        indices_.resize(boxes_.size());
+        centroids_.resize(boxes_.size());
+        for (std::uint32_t i = 0; i < boxes_.size(); i++) {
+            indices_[i] = i;
+            centroids_[i] = boxes_[i].center();
+        }
+        if (boxes_.empty()) {
+            return;
+        }
+        //a binary tree with leaves of 1 or more primitives has at most 2n - 1 nodes
+        nodes_.reserve(2 * boxes_.size() - 1);
+        BuildNode(0, static_cast<std::uint32_t>(boxes_.size()), 0);
+    }
+
+    std::uint32_t Bvh::BuildNode(std::uint32_t first, std::uint32_t count, int depth) {
+        const auto node_index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+
+        AABB bounds, centroid_bounds;
+        for (std::uint32_t i = first; i < first + count; i++) {
+            bounds.Expand(boxes_[indices_[i]]);
+            centroid_bounds.Expand(centroids_[indices_[i]]);
+        }
+        nodes_[node_index].min = bounds.min;
+        nodes_[node_index].max = bounds.max;
+        nodes_[node_index].count = count;
+
+        const auto make_leaf = [&] {
+            nodes_[node_index].first_or_right = first;
+            nodes_[node_index].count = count | kLeafFlag;
+            return node_index;
+        };
+        //the traversal stack holds at most one pending node per level
+        if (count <= kMaxLeafSize || depth >= kStackSize - 2) {
+            return make_leaf();
+        }
+
+        //binned SAH : bin the centroids on each axis and sweep the 11 split planes
+        const glm::vec3 centroid_size = centroid_bounds.max - centroid_bounds.min;
+        float best_cost = std::numeric_limits<float>::max();
+        int best_axis = -1, best_split = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            if (centroid_size[axis] <= 0.0f) {
+                continue;
+            }
+            const float scale = static_cast<float>(kBinCount) / centroid_size[axis];
+            std::array<AABB, kBinCount> bin_bounds{};
+            std::array<std::uint32_t, kBinCount> bin_counts{};
+            for (std::uint32_t i = first; i < first + count; i++) {
+                const std::uint32_t index = indices_[i];
+                const int bin = std::min(kBinCount - 1, static_cast<int>(
+                        (centroids_[index][axis] - centroid_bounds.min[axis]) * scale));
+                bin_bounds[bin].Expand(boxes_[index]);
+                bin_counts[bin]++;
+            }
+
+            std::array<float, kBinCount - 1> left_cost{};
+            AABB left;
+            std::uint32_t left_count = 0;
+            for (int split = 0; split < kBinCount - 1; split++) {
+                left.Expand(bin_bounds[split]);
+                left_count += bin_counts[split];
+                left_cost[split] = SurfaceArea(left) * static_cast<float>(left_count);
+            }
+            AABB right;
+            std::uint32_t right_count = 0;
+            for (int split = kBinCount - 2; split >= 0; split--) {
+                right.Expand(bin_bounds[split + 1]);
+                right_count += bin_counts[split + 1];
+                const float cost = left_cost[split] + SurfaceArea(right) * static_cast<float>(right_count);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_split = split;
+                }
+            }
+        }
+
+        std::uint32_t middle;
+        if (best_axis >= 0) {
+            const float scale = static_cast<float>(kBinCount) / centroid_size[best_axis];
+            const float origin = centroid_bounds.min[best_axis];
+            const auto it = std::partition(indices_.begin() + first, indices_.begin() + first + count,
+                                           [&](std::uint32_t index) {
+                                               const int bin = std::min(kBinCount - 1, static_cast<int>(
+                                                       (centroids_[index][best_axis] - origin) * scale));
+                                               return bin <= best_split;
+                                           });
+            middle = static_cast<std::uint32_t>(it - indices_.begin());
+        } else {
+            //every centroid at the same place, nothing to gain from splitting
+            return make_leaf();
+        }
+        if (middle == first || middle == first + count) {
+            middle = first + count / 2;
+        }
+
+        BuildNode(first, middle - first, depth + 1);
+        nodes_[node_index].first_or_right = BuildNode(middle, first + count - middle, depth + 1);
+        return node_index;
+    }
+
+    std::uint32_t Bvh::FirstIndex(std::uint32_t node) const {
+        while (!nodes_[node].is_leaf()) {
+            node++;
+        }
+        return nodes_[node].first_or_right;
+    }
+
+    void Bvh::CullFrustum(const Frustum &frustum, std::vector<std::uint32_t> &visible) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        nodes_visited_ = 0;
+        if (nodes_.empty()) {
+            return;
+        }
+        const std::array<glm::vec4, 6> planes = frustum.PackedPlanes();
+        constexpr std::uint32_t kAllPlanes = (1u << 6) - 1;
+
+        //each entry keeps the planes the node still straddles, the children skip the others
+        std::array<std::pair<std::uint32_t, std::uint32_t>, kStackSize> stack{};
+        int stack_size = 0;
+        stack[stack_size++] = {0, kAllPlanes};
+        while (stack_size > 0) {
+            auto [node_index, plane_mask] = stack[--stack_size];
+            const Node &node = nodes_[node_index];
+            nodes_visited_++;
+
+            const glm::vec3 center = (node.min + node.max) * 0.5f;
+            const glm::vec3 extents = (node.max - node.min) * 0.5f;
+            bool outside = false;
+            for (int p = 0; p < 6; p++) {
+                if (!(plane_mask & (1u << p))) {
+                    continue;
+                }
+                const glm::vec3 normal(planes[p]);
+                const float distance = glm::dot(normal, center) - planes[p].w;
+                const float reach = glm::dot(extents, glm::abs(normal));
+                if (distance < -reach) {
+                    outside = true;
+                    break;
+                }
+                if (distance >= reach) {
+                    plane_mask &= ~(1u << p);
+                }
+            }
+            if (outside) {
+                continue;
+            }
+
+            if (plane_mask == 0) {
+                //the whole subtree is inside, its primitives are contiguous
+                const std::uint32_t first = FirstIndex(node_index);
+                visible.insert(visible.end(), indices_.begin() + first,
+                               indices_.begin() + first + node.primitive_count());
+                continue;
+            }
+            if (node.is_leaf()) {
+                for (std::uint32_t i = node.first_or_right; i < node.first_or_right + node.primitive_count(); i++) {
+                    if (frustum.IsAabbInFrustum(boxes_[indices_[i]])) {
+                        visible.push_back(indices_[i]);
+                    }
+                }
+                continue;
+            }
+            stack[stack_size++] = {node.first_or_right, plane_mask};
+            stack[stack_size++] = {node_index + 1, plane_mask};
+        }
+    }
+
+    bool Bvh::Raycast(const Ray &ray, float max_distance, std::uint32_t &hit_index, float &hit_distance) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        nodes_visited_ = 0;
+        if (nodes_.empty()) {
+            return false;
+        }
+        const glm::vec3 inverse_direction = 1.0f / ray.direction;
+        float closest = max_distance;
+        bool hit = false;
+
+        std::array<std::uint32_t, kStackSize> stack{};
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0) {
+            const Node &node = nodes_[stack[--stack_size]];
+            nodes_visited_++;
+            if (IntersectRayBox(ray.origin, inverse_direction, node.min, node.max, closest) == kMiss) {
+                continue;
+            }
+            if (node.is_leaf()) {
+                for (std::uint32_t i = node.first_or_right; i < node.first_or_right + node.primitive_count(); i++) {
+                    const AABB &box = boxes_[indices_[i]];
+                    const float distance = IntersectRayBox(ray.origin, inverse_direction, box.min, box.max, closest);
+                    if (distance != kMiss && (!hit || distance < closest)) {
+                        closest = distance;
+                        hit_index = indices_[i];
+                        hit = true;
+                    }
+                }
+                continue;
+            }
+            //near child last so it is popped first and shrinks closest before the far one is tested
+            const std::uint32_t left = static_cast<std::uint32_t>(&node - nodes_.data()) + 1;
+            const std::uint32_t right = node.first_or_right;
+            const float left_distance = IntersectRayBox(ray.origin, inverse_direction, nodes_[left].min,
+                                                        nodes_[left].max, closest);
+            const float right_distance = IntersectRayBox(ray.origin, inverse_direction, nodes_[right].min,
+                                                         nodes_[right].max, closest);
+            if (left_distance <= right_distance) {
+                stack[stack_size++] = right;
+                stack[stack_size++] = left;
+            } else {
+                stack[stack_size++] = left;
+                stack[stack_size++] = right;
+            }
+        }
+        if (hit) {
+            hit_distance = closest;
+        }
+        return hit;
+    }
+
+    void Bvh::QueryBox(const AABB &box, std::vector<std::uint32_t> &result) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        nodes_visited_ = 0;
+        if (nodes_.empty()) {
+            return;
+        }
+        std::array<std::uint32_t, kStackSize> stack{};
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0) {
+            const std::uint32_t node_index = stack[--stack_size];
+            const Node &node = nodes_[node_index];
+            nodes_visited_++;
+            if (!Overlaps(box, node.min, node.max)) {
+                continue;
+            }
+            if (node.is_leaf()) {
+                for (std::uint32_t i = node.first_or_right; i < node.first_or_right + node.primitive_count(); i++) {
+                    const AABB &candidate = boxes_[indices_[i]];
+                    if (Overlaps(box, candidate.min, candidate.max)) {
+                        result.push_back(indices_[i]);
+                    }
+                }
+                continue;
+            }
+            stack[stack_size++] = node.first_or_right;
+            stack[stack_size++] = node_index + 1;
+        }
+    }
+
+} // namespace gpr
@@ -0,0 +1,310 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/frustum_batch.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GPR_FRUSTUM_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and Clang only emit AVX2 in the functions asking for it, MSVC accepts the intrinsics everywhere
+#if defined(GPR_FRUSTUM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define GPR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define GPR_TARGET_AVX2
+#endif
+
+namespace gpr {
+
+    namespace {
+        constexpr std::size_t kBitsPerWord = 64;
+        using Planes = std::array<glm::vec4, 6>;
+
+        //plane is (normal, distance) -> signed distance = dot(normal, p) - distance
+        bool SphereInside(const Planes &planes, float x, float y, float z, float radius) {
+            for (const auto &plane: planes) {
+                if (plane.x * x + plane.y * y + plane.z * z - plane.w < -radius) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //p-vertex : the box reaches |n| . extents further along the normal than its center
+        bool AabbInside(const Planes &planes, float x, float y, float z, float ex, float ey, float ez) {
+            for (const auto &plane: planes) {
+                const float reach = std::abs(plane.x) * ex + std::abs(plane.y) * ey + std::abs(plane.z) * ez;
+                if (plane.x * x + plane.y * y + plane.z * z - plane.w < -reach) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::uint64_t SphereWordScalar(const Planes &planes, const SphereBatch &batch, std::size_t first,
+                                       std::size_t last) {
+            std::uint64_t word = 0;
+            for (std::size_t i = first; i < last; i++) {
+                if (SphereInside(planes, batch.center_x[i], batch.center_y[i], batch.center_z[i], batch.radius[i])) {
+                    word |= std::uint64_t{1} << (i - first);
+                }
+            }
+            return word;
+        }
+
+        std::uint64_t AabbWordScalar(const Planes &planes, const AabbBatch &batch, std::size_t first,
+                                     std::size_t last) {
+            std::uint64_t word = 0;
+            for (std::size_t i = first; i < last; i++) {
+                if (AabbInside(planes, batch.center_x[i], batch.center_y[i], batch.center_z[i],
+                               batch.extent_x[i], batch.extent_y[i], batch.extent_z[i])) {
+                    word |= std::uint64_t{1} << (i - first);
+                }
+            }
+            return word;
+        }
+
+#ifdef GPR_FRUSTUM_X86
+        //one full word of 64 objects, 4 at a time
+        std::uint64_t SphereWordSse(const Planes &planes, const SphereBatch &batch, std::size_t first) {
+            std::uint64_t word = 0;
+            for (std::size_t lane = 0; lane < kBitsPerWord; lane += 4) {
+                const std::size_t i = first + lane;
+                const __m128 x = _mm_loadu_ps(&batch.center_x[i]);
+                const __m128 y = _mm_loadu_ps(&batch.center_y[i]);
+                const __m128 z = _mm_loadu_ps(&batch.center_z[i]);
+                const __m128 minus_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&batch.radius[i]));
+                __m128 outside = _mm_setzero_ps();
+                for (const auto &plane: planes) {
+                    __m128 distance = _mm_mul_ps(_mm_set1_ps(plane.x), x);
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.y), y));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+                    distance = _mm_sub_ps(distance, _mm_set1_ps(plane.w));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, minus_radius));
+                }
+                const auto inside = static_cast<std::uint64_t>(~_mm_movemask_ps(outside) & 0xF);
+                word |= inside << lane;
+            }
+            return word;
+        }
+
+        std::uint64_t AabbWordSse(const Planes &planes, const AabbBatch &batch, std::size_t first) {
+            std::uint64_t word = 0;
+            for (std::size_t lane = 0; lane < kBitsPerWord; lane += 4) {
+                const std::size_t i = first + lane;
+                const __m128 x = _mm_loadu_ps(&batch.center_x[i]);
+                const __m128 y = _mm_loadu_ps(&batch.center_y[i]);
+                const __m128 z = _mm_loadu_ps(&batch.center_z[i]);
+                const __m128 ex = _mm_loadu_ps(&batch.extent_x[i]);
+                const __m128 ey = _mm_loadu_ps(&batch.extent_y[i]);
+                const __m128 ez = _mm_loadu_ps(&batch.extent_z[i]);
+                __m128 outside = _mm_setzero_ps();
+                for (const auto &plane: planes) {
+                    __m128 distance = _mm_mul_ps(_mm_set1_ps(plane.x), x);
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.y), y));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+                    distance = _mm_sub_ps(distance, _mm_set1_ps(plane.w));
+                    __m128 reach = _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex);
+                    reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey));
+                    reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+                }
+                const auto inside = static_cast<std::uint64_t>(~_mm_movemask_ps(outside) & 0xF);
+                word |= inside << lane;
+            }
+            return word;
+        }
+
+        //one full word of 64 objects, 8 at a time
+        GPR_TARGET_AVX2 std::uint64_t SphereWordAvx2(const Planes &planes, const SphereBatch &batch, std::size_t first) {
+            std::uint64_t word = 0;
+            for (std::size_t lane = 0; lane < kBitsPerWord; lane += 8) {
+                const std::size_t i = first + lane;
+                const __m256 x = _mm256_loadu_ps(&batch.center_x[i]);
+                const __m256 y = _mm256_loadu_ps(&batch.center_y[i]);
+                const __m256 z = _mm256_loadu_ps(&batch.center_z[i]);
+                const __m256 minus_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&batch.radius[i]));
+                __m256 outside = _mm256_setzero_ps();
+                for (const auto &plane: planes) {
+                    __m256 distance = _mm256_fmsub_ps(_mm256_set1_ps(plane.x), x, _mm256_set1_ps(plane.w));
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.y), y, distance);
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.z), z, distance);
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, minus_radius, _CMP_LT_OQ));
+                }
+                const auto inside = static_cast<std::uint64_t>(~_mm256_movemask_ps(outside) & 0xFF);
+                word |= inside << lane;
+            }
+            return word;
+        }
+
+        GPR_TARGET_AVX2 std::uint64_t AabbWordAvx2(const Planes &planes, const AabbBatch &batch, std::size_t first) {
+            std::uint64_t word = 0;
+            for (std::size_t lane = 0; lane < kBitsPerWord; lane += 8) {
+                const std::size_t i = first + lane;
+                const __m256 x = _mm256_loadu_ps(&batch.center_x[i]);
+                const __m256 y = _mm256_loadu_ps(&batch.center_y[i]);
+                const __m256 z = _mm256_loadu_ps(&batch.center_z[i]);
+                const __m256 ex = _mm256_loadu_ps(&batch.extent_x[i]);
+                const __m256 ey = _mm256_loadu_ps(&batch.extent_y[i]);
+                const __m256 ez = _mm256_loadu_ps(&batch.extent_z[i]);
+                __m256 outside = _mm256_setzero_ps();
+                for (const auto &plane: planes) {
+                    __m256 distance = _mm256_fmsub_ps(_mm256_set1_ps(plane.x), x, _mm256_set1_ps(plane.w));
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.y), y, distance);
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.z), z, distance);
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.x)), ex, distance);
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.y)), ey, distance);
+                    distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.z)), ez, distance);
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+                const auto inside = static_cast<std::uint64_t>(~_mm256_movemask_ps(outside) & 0xFF);
+                word |= inside << lane;
+            }
+            return word;
+        }
+
+        bool CpuHasAvx2() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            __cpuidex(info, 7, 0);
+            return os_saves_ymm && fma && (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+#endif
+
+        //fill mask[first_word, last_word) with the kernel of the level, the last word can be partial
+        template<typename Batch, typename ScalarWord, typename SseWord, typename Avx2Word>
+        void CullWords(SimdLevel level, const Planes &planes, const Batch &batch, std::size_t first_word,
+                       std::size_t last_word, std::uint64_t *mask, ScalarWord scalar_word,
+                       [[maybe_unused]] SseWord sse_word, [[maybe_unused]] Avx2Word avx2_word) {
+            const std::size_t count = batch.size();
+            for (std::size_t word = first_word; word < last_word; word++) {
+                const std::size_t first = word * kBitsPerWord;
+                const std::size_t last = std::min(count, first + kBitsPerWord);
+                if (last - first < kBitsPerWord || level == SimdLevel::kScalar) {
+                    mask[word] = scalar_word(planes, batch, first, last);
+                    continue;
+                }
+#ifdef GPR_FRUSTUM_X86
+                mask[word] = level == SimdLevel::kAvx2 ? avx2_word(planes, batch, first) : sse_word(planes, batch, first);
+#else
+                mask[word] = scalar_word(planes, batch, first, last);
+#endif
+            }
+        }
+
+        //split the words in chunks for the WorkerPool when the batch is big enough to pay for it
+        template<typename CullRange>
+        void RunWords(std::size_t word_count, bool multithreaded, CullRange cull_range) {
+            constexpr std::size_t words_per_task = FrustumBatchCuller::kParallelThreshold / kBitsPerWord;
+            if (!multithreaded || word_count <= words_per_task) {
+                cull_range(0, word_count);
+                return;
+            }
+            const std::size_t task_count = (word_count + words_per_task - 1) / words_per_task;
+            WorkerPool::Instance().ParallelFor(task_count, [&](std::size_t task) {
+                cull_range(task * words_per_task, std::min(word_count, (task + 1) * words_per_task));
+            });
+        }
+    }
+
+    SimdLevel BestSimdLevel() {
+#ifdef GPR_FRUSTUM_X86
+        static const SimdLevel level = CpuHasAvx2() ? SimdLevel::kAvx2 : SimdLevel::kSse;
+        return level;
+#else
+        return SimdLevel::kScalar;
+#endif
+    }
+
+    const char *SimdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::kScalar:
+                return "scalar";
+            case SimdLevel::kSse:
+                return "SSE";
+            case SimdLevel::kAvx2:
+                return "AVX2";
+        }
+        return "unknown";
+    }
+
+    FrustumBatchCuller::FrustumBatchCuller(SimdLevel level) : level_(std::min(level, BestSimdLevel())) {}
+
+    void FrustumBatchCuller::CullSpheres(const Frustum &frustum, const SphereBatch &spheres,
+                                         std::vector<std::uint64_t> &mask) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const Planes planes = frustum.PackedPlanes();
+        const std::size_t word_count = (spheres.size() + kBitsPerWord - 1) / kBitsPerWord;
+        mask.resize(word_count);
+        RunWords(word_count, multithreaded_, [&](std::size_t first_word, std::size_t last_word) {
+#ifdef GPR_FRUSTUM_X86
+            CullWords(level_, planes, spheres, first_word, last_word, mask.data(), SphereWordScalar, SphereWordSse,
+                      SphereWordAvx2);
+#else
+            CullWords(level_, planes, spheres, first_word, last_word, mask.data(), SphereWordScalar, nullptr, nullptr);
+#endif
+        });
+    }
+
+    void FrustumBatchCuller::CullAabbs(const Frustum &frustum, const AabbBatch &boxes,
+                                       std::vector<std::uint64_t> &mask) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const Planes planes = frustum.PackedPlanes();
+        const std::size_t word_count = (boxes.size() + kBitsPerWord - 1) / kBitsPerWord;
+        mask.resize(word_count);
+        RunWords(word_count, multithreaded_, [&](std::size_t first_word, std::size_t last_word) {
+#ifdef GPR_FRUSTUM_X86
+            CullWords(level_, planes, boxes, first_word, last_word, mask.data(), AabbWordScalar, AabbWordSse,
+                      AabbWordAvx2);
+#else
+            CullWords(level_, planes, boxes, first_word, last_word, mask.data(), AabbWordScalar, nullptr, nullptr);
+#endif
+        });
+    }
+
+    std::size_t FrustumBatchCuller::CompactVisible(std::span<const std::uint64_t> mask, std::size_t count,
+                                                   std::vector<std::uint32_t> &indices) {
+        indices.clear();
+        for (std::size_t word = 0; word < mask.size(); word++) {
+            std::uint64_t bits = mask[word];
+            while (bits != 0) {
+                const auto index = static_cast<std::uint32_t>(word * kBitsPerWord + std::countr_zero(bits));
+                if (index >= count) {
+                    break;
+                }
+                indices.push_back(index);
+                bits &= bits - 1;
+            }
+        }
+        return indices.size();
+    }
+
+} // namespace gpr
@@ -0,0 +1,297 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/gpu_culling.h"
+#include "file_utility.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr GLuint kCullGroupSize = 64; //must match local_size_x of instance_frustum_cull.comp
+
+    void GpuInstanceCuller::Create(const std::vector<glm::mat4> &instance_matrices, const Model &model,
+                                   GLuint view_count, const OctahedralImpostor *impostor) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        instance_count_ = static_cast<GLuint>(instance_matrices.size());
+        view_count_ = view_count;
+        lod_count_ = static_cast<GLuint>(std::min(model.lod_count(), kMaxLodCount));
+        commands_per_view_ = 0;
+        for (GLuint lod = 0; lod < lod_count_; lod++) {
+            //a level simplified down to nothing ends the chain, its instances would land in the next commands
+            if (model.lod_meshes(lod).empty()) {
+                lod_count_ = std::max(lod, 1u);
+                break;
+            }
+            lod_first_command_[lod] = commands_per_view_;
+            lod_mesh_count_[lod] = static_cast<GLuint>(model.lod_meshes(lod).size());
+            commands_per_view_ += lod_mesh_count_[lod];
+        }
+        lod_screen_sizes_.fill(0.0f);
+        std::copy_n(model.lod_screen_sizes_.begin(), std::min<std::size_t>(model.lod_screen_sizes_.size(), lod_count_ - 1),
+                    lod_screen_sizes_.begin());
+        mesh_lod_count_ = lod_count_;
+        has_impostor_ = impostor != nullptr;
+        if (has_impostor_) {
+            //the impostor only takes over below the last mesh threshold
+            float impostor_screen_size = kImpostorScreenSize;
+            if (lod_count_ > 1) {
+                impostor_screen_size = std::min(impostor_screen_size, lod_screen_sizes_[lod_count_ - 2]);
+            }
+            lod_screen_sizes_[lod_count_ - 1] = impostor_screen_size;
+            lod_first_command_[lod_count_] = commands_per_view_;
+            lod_mesh_count_[lod_count_] = 1;
+            commands_per_view_++;
+            lod_count_++;
+        }
+        local_sphere_ = glm::vec4(model.bounding_sphere_.center(), model.bounding_sphere_.radius());
+
+        cull_program_.Create("data/shaders/3D_scene/culling/instance_frustum_cull.comp");
+
+        //every instance starts at LOD 0, the first selection moves it straight to its level
+        std::vector<PackedInstance> instances(instance_count_);
+        std::transform(instance_matrices.begin(), instance_matrices.end(), instances.begin(),
+                       [](const glm::mat4 &matrix) { return PackInstance(matrix); });
+        glCreateBuffers(1, &instances_ssbo_);
+        glNamedBufferStorage(instances_ssbo_, static_cast<GLsizeiptr>(instance_count_ * sizeof(PackedInstance)),
+                             instances.data(), 0);
+
+        glCreateBuffers(1, &visible_ssbo_);
+        glNamedBufferStorage(visible_ssbo_,
+                             static_cast<GLsizeiptr>(view_count_ * lod_count_ * instance_count_ * sizeof(GLuint)),
+                             nullptr, 0);
+
+        //one command per mesh of each LOD per view, the instance count is written by the compute pass
+        reset_commands_.clear();
+        for (GLuint view = 0; view < view_count_; view++) {
+            for (GLuint lod = 0; lod < mesh_lod_count_; lod++) {
+                for (const auto &mesh: model.lod_meshes(lod)) {
+                    DrawElementsIndirectCommand command{};
+                    command.count = static_cast<GLuint>(mesh.indices_.size());
+                    reset_commands_.push_back(command);
+                }
+            }
+            if (has_impostor_) {
+                DrawElementsIndirectCommand command{};
+                command.count = OctahedralImpostor::kIndexCount;
+                reset_commands_.push_back(command);
+            }
+        }
+        glCreateBuffers(1, &commands_buffer_);
+        glNamedBufferStorage(commands_buffer_,
+                             static_cast<GLsizeiptr>(reset_commands_.size() * sizeof(DrawElementsIndirectCommand)),
+                             reset_commands_.data(), GL_DYNAMIC_STORAGE_BIT);
+
+        //nothing is visible before the first frame, the occlusion phase will fill it
+        const std::vector<GLuint> visibility(instance_count_, 0);
+        glCreateBuffers(1, &visibility_ssbo_);
+        glNamedBufferStorage(visibility_ssbo_, static_cast<GLsizeiptr>(instance_count_ * sizeof(GLuint)),
+                             visibility.data(), 0);
+
+        //stats are read back a few frames late so the CPU never waits for the GPU
+        stats_.Create(sizeof(CullStats));
+    }
+
+    void GpuInstanceCuller::SetLodCamera(const glm::vec3 &eye, const glm::mat4 &projection) {
+        lod_eye_ = eye;
+        lod_projection_scale_ = projection[1][1];
+    }
+
+    void GpuInstanceCuller::Cull(const Frustum &frustum, GLuint view) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        cull_program_.Use();
+        Dispatch(frustum, view, CullPhase::kFrustum);
+    }
+
+    void GpuInstanceCuller::CullPreviouslyVisible(const Frustum &frustum, GLuint view) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        cull_program_.Use();
+        Dispatch(frustum, view, CullPhase::kPreviouslyVisible);
+    }
+
+    void GpuInstanceCuller::CullOcclusion(const Frustum &frustum, const glm::mat4 &view_projection,
+                                          const HiZPyramid &hi_z, GLuint view) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //only this phase writes the counters
+        stats_.BeginFrame();
+        const auto stats = stats_.Read<CullStats>();
+        if (stats.frustum_visible > 0) {
+            occlusion_culled_percent_ = 100.0f * static_cast<float>(stats.occluded) /
+                                        static_cast<float>(stats.frustum_visible);
+        } else {
+            occlusion_culled_percent_ = 0.0f;
+        }
+#ifdef TRACY_ENABLE
+        TracyPlot("Occlusion culled %", occlusion_culled_percent_);
+#endif
+
+        cull_program_.Use();
+        glUniformMatrix4fv(cull_program_.UniformLocation("viewProjection"), 1, GL_FALSE, glm::value_ptr(view_projection));
+        glUniform2f(cull_program_.UniformLocation("hiZSize"), static_cast<float>(hi_z.width()),
+                    static_cast<float>(hi_z.height()));
+        glUniform1i(cull_program_.UniformLocation("hiZLevels"), hi_z.level_count());
+        glUniform1i(cull_program_.UniformLocation("hiZ"), 0);
+        GLStateCache::Get().BindTexture(0, hi_z.texture());
+
+        Dispatch(frustum, view, CullPhase::kOcclusion);
+        stats_.Fence();
+    }
+
+    void GpuInstanceCuller::Dispatch(const Frustum &frustum, GLuint view, CullPhase phase) {
+        const GLuint first_command = view * commands_per_view_;
+        constexpr auto command_size = static_cast<GLintptr>(sizeof(DrawElementsIndirectCommand));
+
+        //reset the counters of this view
+        glNamedBufferSubData(commands_buffer_, first_command * command_size, commands_per_view_ * command_size,
+                             &reset_commands_[first_command]);
+
+        const auto planes = frustum.PackedPlanes();
+        glUniform4fv(cull_program_.UniformLocation("planes"), 6, glm::value_ptr(planes[0]));
+        glUniform4fv(cull_program_.UniformLocation("localSphere"), 1, glm::value_ptr(local_sphere_));
+        glUniform1ui(cull_program_.UniformLocation("instanceCount"), instance_count_);
+        glUniform1ui(cull_program_.UniformLocation("visibleOffset"), view * lod_count_ * instance_count_);
+        glUniform1ui(cull_program_.UniformLocation("commandIndex"), first_command);
+        glUniform1i(cull_program_.UniformLocation("phase"), static_cast<GLint>(phase));
+        glUniform1ui(cull_program_.UniformLocation("lodCount"), lod_count_);
+        glUniform1uiv(cull_program_.UniformLocation("lodFirstCommand"), kMaxLevelCount, lod_first_command_.data());
+        glUniform1fv(cull_program_.UniformLocation("lodScreenSizes"), kMaxLevelCount - 1, lod_screen_sizes_.data());
+        glUniform3fv(cull_program_.UniformLocation("lodEye"), 1, glm::value_ptr(lod_eye_));
+        glUniform1f(cull_program_.UniformLocation("lodProjectionScale"), lod_projection_scale_);
+        glUniform1f(cull_program_.UniformLocation("lodHysteresis"), kLodHysteresis);
+        glUniform1ui(cull_program_.UniformLocation("clusterCount"), cluster_count_);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kInstancesBinding, instances_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVisibleBinding, visible_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kCommandsBinding, commands_buffer_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVisibilityBinding, visibility_ssbo_);
+        stats_.Bind(kStatsBinding);
+        if (cluster_count_ > 0) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kInstanceClustersBinding, instance_clusters_ssbo_);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kProxiedClustersBinding, proxied_clusters_ssbo_);
+        }
+
+        ComputeProgram::Dispatch((instance_count_ + kCullGroupSize - 1) / kCullGroupSize, 1, 1,
+                                 GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT |
+                                 GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        //every mesh of a LOD draws the same instances -> copy the count of its first command to the others
+        constexpr auto instance_count_offset = static_cast<GLintptr>(offsetof(DrawElementsIndirectCommand, instanceCount));
+        for (GLuint lod = 0; lod < lod_count_; lod++) {
+            const GLuint lod_command = first_command + lod_first_command_[lod];
+            for (GLuint mesh = 1; mesh < lod_mesh_count_[lod]; mesh++) {
+                glCopyNamedBufferSubData(commands_buffer_, commands_buffer_,
+                                         lod_command * command_size + instance_count_offset,
+                                         (lod_command + mesh) * command_size + instance_count_offset,
+                                         sizeof(GLuint));
+            }
+        }
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    }
+
+    void GpuInstanceCuller::SetInstanceClusters(std::span<const GLuint> instance_clusters, GLuint cluster_count) {
+        glDeleteBuffers(1, &instance_clusters_ssbo_);
+        glDeleteBuffers(1, &proxied_clusters_ssbo_);
+        cluster_count_ = cluster_count;
+        if (cluster_count_ == 0 || instance_clusters.size() < instance_count_) {
+            cluster_count_ = 0;
+            return;
+        }
+        glCreateBuffers(1, &instance_clusters_ssbo_);
+        glNamedBufferStorage(instance_clusters_ssbo_, static_cast<GLsizeiptr>(instance_count_ * sizeof(GLuint)),
+                             instance_clusters.data(), 0);
+        //every cluster starts with its instances
+        const std::vector<GLuint> proxied(cluster_count_, 0);
+        glCreateBuffers(1, &proxied_clusters_ssbo_);
+        glNamedBufferStorage(proxied_clusters_ssbo_, static_cast<GLsizeiptr>(cluster_count_ * sizeof(GLuint)),
+                             proxied.data(), GL_DYNAMIC_STORAGE_BIT);
+    }
+
+    void GpuInstanceCuller::UploadProxiedClusters(std::span<const GLuint> proxied) {
+        const auto count = std::min(static_cast<GLuint>(proxied.size()), cluster_count_);
+        glNamedBufferSubData(proxied_clusters_ssbo_, 0, static_cast<GLsizeiptr>(count * sizeof(GLuint)), proxied.data());
+    }
+
+    void GpuInstanceCuller::UploadVisibility(std::span<const GLuint> visibility, StreamingBuffer &stream) {
+        const auto count = std::min(static_cast<GLuint>(visibility.size()), instance_count_);
+        const StreamAllocation<GLuint> allocation = stream.Allocate<GLuint>(count);
+        if (allocation.empty()) {
+            return;
+        }
+        std::copy_n(visibility.begin(), count, allocation.data.begin());
+        glCopyNamedBufferSubData(stream.name(), visibility_ssbo_, allocation.offset, 0, allocation.size);
+    }
+
+    void GpuInstanceCuller::Draw(const Model &model, GLuint program, GLuint view, GLuint first_lod) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const GLint visible_offset_location = glGetUniformLocation(program, "visibleOffset");
+        //-1 for the depth programs, the color program reads the material of the mesh from the MaterialSystem table
+        const GLint material_location = glGetUniformLocation(program, "material");
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kInstancesBinding, instances_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVisibleBinding, visible_ssbo_);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer_);
+
+        for (GLuint lod = first_lod; lod < mesh_lod_count_; lod++) {
+            glUniform1ui(visible_offset_location, (view * lod_count_ + lod) * instance_count_);
+            const auto &meshes = model.lod_meshes(lod);
+            for (GLuint i = 0; i < lod_mesh_count_[lod]; i++) {
+                const auto offset = (view * commands_per_view_ + lod_first_command_[lod] + i) *
+                                    sizeof(DrawElementsIndirectCommand);
+                if (material_location >= 0) {
+                    glUniform1ui(material_location, meshes[i].material_);
+                }
+                GLStateCache::Get().BindVertexArray(meshes[i].vao_.name());
+                glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void *>(offset));
+            }
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void GpuInstanceCuller::DrawImpostors(const OctahedralImpostor &impostor, const glm::mat4 &view_matrix,
+                                          const glm::mat4 &projection, const glm::vec3 &eye, GLuint view) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        if (!has_impostor_) {
+            return;
+        }
+        const GLuint lod = lod_count_ - 1;
+        impostor.Use(view_matrix, projection, eye);
+        glUniform1ui(impostor.program().UniformLocation("visibleOffset"), (view * lod_count_ + lod) * instance_count_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kInstancesBinding, instances_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVisibleBinding, visible_ssbo_);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer_);
+        const auto offset = (view * commands_per_view_ + lod_first_command_[lod]) * sizeof(DrawElementsIndirectCommand);
+        glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void *>(offset));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void GpuInstanceCuller::Delete() {
+        cull_program_.Delete();
+        stats_.Delete();
+        glDeleteBuffers(1, &visibility_ssbo_);
+        glDeleteBuffers(1, &instance_clusters_ssbo_);
+        glDeleteBuffers(1, &proxied_clusters_ssbo_);
+        glDeleteBuffers(1, &instances_ssbo_);
+        glDeleteBuffers(1, &visible_ssbo_);
+        glDeleteBuffers(1, &commands_buffer_);
+    }
+
+} // namespace gpr
@@ -0,0 +1,72 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/hi_z_pyramid.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr GLuint kHiZGroupSize = 8; //must match local_size of hi_z_downsample.comp
+
+    void HiZPyramid::Create(GLsizei width, GLsizei height) {
+        Resize(width, height);
+        downsample_program_.Create("data/shaders/3D_scene/culling/hi_z_downsample.comp");
+    }
+
+    void HiZPyramid::Resize(GLsizei width, GLsizei height) {
+        glDeleteTextures(1, &texture_);
+        width_ = width;
+        height_ = height;
+        level_count_ = 1 + static_cast<GLint>(std::floor(std::log2(static_cast<float>(std::max(width, height)))));
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture_);
+        glTextureStorage2D(texture_, level_count_, GL_R32F, width_, height_);
+        glTextureParameteri(texture_, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTextureParameteri(texture_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(texture_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(texture_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    void HiZPyramid::Build(GLuint depth_texture) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        downsample_program_.Use();
+        glUniform1i(downsample_program_.UniformLocation("source"), 0);
+
+        GLsizei source_width = width_, source_height = height_;
+        for (GLint level = 0; level < level_count_; level++) {
+            const GLsizei width = std::max(1, width_ >> level);
+            const GLsizei height = std::max(1, height_ >> level);
+
+            //level 0 is a plain copy of the depth, the others reduce the previous level of the pyramid
+            GLStateCache::Get().BindTexture(0, level == 0 ? depth_texture : texture_);
+            glUniform1i(downsample_program_.UniformLocation("sourceLevel"), level == 0 ? 0 : level - 1);
+            glUniform1i(downsample_program_.UniformLocation("copyDepth"), level == 0);
+            glUniform2i(downsample_program_.UniformLocation("sourceSize"), source_width, source_height);
+            glUniform2i(downsample_program_.UniformLocation("destinationSize"), width, height);
+            glBindImageTexture(0, texture_, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            ComputeProgram::Dispatch((width + kHiZGroupSize - 1) / kHiZGroupSize,
+                                     (height + kHiZGroupSize - 1) / kHiZGroupSize, 1,
+                                     GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            source_width = width;
+            source_height = height;
+        }
+        glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    }
+
+    void HiZPyramid::Delete() {
+        downsample_program_.Delete();
+        glDeleteTextures(1, &texture_);
+        texture_ = 0;
+    }
+
+} // namespace gpr
@@ -0,0 +1,73 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/instance_bounds.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define GPR_BOUNDS_SSE 1
+#include <xmmintrin.h>
+#endif
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    void InstanceBounds::Refit(const AABB &local, std::span<const glm::mat4> matrices) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const std::size_t count = matrices.size();
+        for (auto *values: {&center_x_, &center_y_, &center_z_, &extent_x_, &extent_y_, &extent_z_}) {
+            values->resize(count);
+        }
+        const glm::vec3 local_center = local.center();
+        const glm::vec3 local_extents = local.extents();
+
+        std::size_t i = 0;
+#ifdef GPR_BOUNDS_SSE
+        //center = M * c, extents = |M| * e, one instance per register then transposed to write 4 of each array
+        const __m128 sign_mask = _mm_set1_ps(-0.0f);
+        const __m128 cx = _mm_set1_ps(local_center.x), cy = _mm_set1_ps(local_center.y);
+        const __m128 cz = _mm_set1_ps(local_center.z);
+        const __m128 ex = _mm_set1_ps(local_extents.x), ey = _mm_set1_ps(local_extents.y);
+        const __m128 ez = _mm_set1_ps(local_extents.z);
+        for (; i + 4 <= count; i += 4) {
+            __m128 centers[4], extents[4];
+            for (int j = 0; j < 4; j++) {
+                const float *matrix = &matrices[i + j][0][0];
+                const __m128 column_0 = _mm_loadu_ps(matrix);
+                const __m128 column_1 = _mm_loadu_ps(matrix + 4);
+                const __m128 column_2 = _mm_loadu_ps(matrix + 8);
+                const __m128 column_3 = _mm_loadu_ps(matrix + 12);
+                centers[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column_0, cx), _mm_mul_ps(column_1, cy)),
+                                        _mm_add_ps(_mm_mul_ps(column_2, cz), column_3));
+                extents[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, column_0), ex),
+                                                   _mm_mul_ps(_mm_andnot_ps(sign_mask, column_1), ey)),
+                                        _mm_mul_ps(_mm_andnot_ps(sign_mask, column_2), ez));
+            }
+            _MM_TRANSPOSE4_PS(centers[0], centers[1], centers[2], centers[3]);
+            _MM_TRANSPOSE4_PS(extents[0], extents[1], extents[2], extents[3]);
+            _mm_storeu_ps(&center_x_[i], centers[0]);
+            _mm_storeu_ps(&center_y_[i], centers[1]);
+            _mm_storeu_ps(&center_z_[i], centers[2]);
+            _mm_storeu_ps(&extent_x_[i], extents[0]);
+            _mm_storeu_ps(&extent_y_[i], extents[1]);
+            _mm_storeu_ps(&extent_z_[i], extents[2]);
+        }
+#endif
+        for (; i < count; i++) {
+            const AABB world = local.Transformed(matrices[i]);
+            const glm::vec3 center = world.center();
+            const glm::vec3 extents = world.extents();
+            center_x_[i] = center.x;
+            center_y_[i] = center.y;
+            center_z_[i] = center.z;
+            extent_x_[i] = extents.x;
+            extent_y_[i] = extents.y;
+            extent_z_[i] = extents.z;
+        }
+    }
+
+} // namespace gpr
@@ -0,0 +1,103 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/light_clusters.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr GLuint kClusterGroupSize = 64; //must match local_size_x of light_cluster_cull.comp
+
+    void LightClusters::Create(GLuint max_lights) {
+        max_lights_ = max_lights;
+        light_count_ = 0;
+        cull_program_.Create("data/shaders/3D_scene/culling/light_cluster_cull.comp");
+
+        glCreateBuffers(1, &lights_ssbo_);
+        glNamedBufferStorage(lights_ssbo_, static_cast<GLsizeiptr>(std::max(max_lights_, 1u) * sizeof(PointLight)),
+                             nullptr, GL_DYNAMIC_STORAGE_BIT);
+        //zeroed so a program bound before the first Cull sees empty clusters
+        const std::vector<GLuint> zeros(kClusterCount, 0);
+        glCreateBuffers(1, &counts_ssbo_);
+        glNamedBufferStorage(counts_ssbo_, static_cast<GLsizeiptr>(kClusterCount * sizeof(GLuint)), zeros.data(), 0);
+        glCreateBuffers(1, &cluster_lights_ssbo_);
+        glNamedBufferStorage(cluster_lights_ssbo_,
+                             static_cast<GLsizeiptr>(kClusterCount * kMaxLightsPerCluster * sizeof(GLuint)), nullptr, 0);
+
+        stats_buffer_.Create(sizeof(ClusterStats));
+    }
+
+    void LightClusters::UploadLights(std::span<const PointLight> lights) {
+        light_count_ = std::min(static_cast<GLuint>(lights.size()), max_lights_);
+        glNamedBufferSubData(lights_ssbo_, 0, static_cast<GLsizeiptr>(light_count_ * sizeof(PointLight)),
+                             lights.data());
+    }
+
+    void LightClusters::Cull(const glm::mat4 &view, const glm::mat4 &projection, float z_near, float z_far,
+                             GLsizei width, GLsizei height) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        stats_buffer_.BeginFrame();
+        stats_ = stats_buffer_.Read<ClusterStats>();
+
+        const float log_depth_range = std::log(z_far / z_near);
+        tile_size_ = glm::vec2(static_cast<float>(width) / static_cast<float>(kClustersX),
+                               static_cast<float>(height) / static_cast<float>(kClustersY));
+        slice_scale_bias_ = glm::vec2(static_cast<float>(kClustersZ) / log_depth_range,
+                                      -static_cast<float>(kClustersZ) * std::log(z_near) / log_depth_range);
+
+        cull_program_.Use();
+        glUniformMatrix4fv(cull_program_.UniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+        //view ray through an NDC point : (ndc.x / p00, ndc.y / p11, -1) * depth
+        glUniform2f(cull_program_.UniformLocation("projectionScale"), projection[0][0], projection[1][1]);
+        glUniform2f(cull_program_.UniformLocation("depthRange"), z_near, z_far);
+        glUniform3ui(cull_program_.UniformLocation("clusterGrid"), kClustersX, kClustersY, kClustersZ);
+        glUniform1ui(cull_program_.UniformLocation("maxClusterLights"), kMaxLightsPerCluster);
+        glUniform1ui(cull_program_.UniformLocation("lightCount"), light_count_);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightsBinding, lights_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kClusterCountsBinding, counts_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kClusterLightsBinding, cluster_lights_ssbo_);
+        stats_buffer_.Bind(kStatsBinding);
+        ComputeProgram::Dispatch((kClusterCount + kClusterGroupSize - 1) / kClusterGroupSize, 1, 1,
+                                 GL_SHADER_STORAGE_BARRIER_BIT);
+        stats_buffer_.Fence();
+    }
+
+    void LightClusters::Bind(GLuint program) const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightsBinding, lights_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kClusterCountsBinding, counts_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kClusterLightsBinding, cluster_lights_ssbo_);
+        glProgramUniform3ui(program, glGetUniformLocation(program, "clusterGrid"), kClustersX, kClustersY, kClustersZ);
+        glProgramUniform1ui(program, glGetUniformLocation(program, "maxClusterLights"), kMaxLightsPerCluster);
+        glProgramUniform2fv(program, glGetUniformLocation(program, "clusterTileSize"), 1, glm::value_ptr(tile_size_));
+        glProgramUniform2fv(program, glGetUniformLocation(program, "clusterSliceScaleBias"), 1,
+                            glm::value_ptr(slice_scale_bias_));
+    }
+
+    float LightClusters::average_cluster_lights() const {
+        if (stats_.lit_clusters == 0) {
+            return 0.0f;
+        }
+        return static_cast<float>(stats_.assigned) / static_cast<float>(stats_.lit_clusters);
+    }
+
+    void LightClusters::Delete() {
+        cull_program_.Delete();
+        stats_buffer_.Delete();
+        glDeleteBuffers(1, &lights_ssbo_);
+        glDeleteBuffers(1, &counts_ssbo_);
+        glDeleteBuffers(1, &cluster_lights_ssbo_);
+    }
+
+} // namespace gpr
@@ -0,0 +1,253 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/meshlet_culling.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <array>
+#include <cstddef>
+#include <map>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr GLuint kMeshletGroupSize = 64; //must match local_size_x of meshlet_cull.comp
+
+    void MeshletCuller::Create(const Model &model, const GpuInstanceCuller &instances, GLuint view_count,
+                               bool front_face_ccw) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        view_count_ = view_count;
+        instance_count_ = instances.instance_count();
+
+        //meshes sharing the same textures go in the same group, like the generated LOD
+        std::map<std::vector<unsigned int>, std::vector<const Mesh *>> groups;
+        for (const auto &mesh: model.lod_meshes(0)) {
+            std::vector<unsigned int> texture_ids;
+            for (const auto &texture: mesh.textures_) {
+                texture_ids.push_back(texture.id);
+            }
+            groups[texture_ids].push_back(&mesh);
+        }
+
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> meshlet_indices;
+        meshlets_.clear();
+        group_first_meshlet_.clear();
+        group_materials_.clear();
+        for (const auto &[texture_ids, meshes]: groups) {
+            std::vector<unsigned int> group_indices;
+            for (const Mesh *mesh: meshes) {
+                const auto base = static_cast<unsigned int>(vertices.size());
+                vertices.insert(vertices.end(), mesh->vertices_.begin(), mesh->vertices_.end());
+                for (const unsigned int index: mesh->indices_) {
+                    group_indices.push_back(base + index);
+                }
+            }
+            const auto group = static_cast<std::uint32_t>(group_first_meshlet_.size());
+            const auto first_meshlet = static_cast<std::uint32_t>(meshlets_.size());
+            BuildMeshlets(vertices, group_indices, front_face_ccw, meshlets_, meshlet_indices);
+            if (meshlets_.size() == first_meshlet) {
+                continue;
+            }
+            for (std::size_t i = first_meshlet; i < meshlets_.size(); i++) {
+                meshlets_[i].group_first_meshlet = first_meshlet;
+                meshlets_[i].group = group;
+            }
+            group_first_meshlet_.push_back(first_meshlet);
+            //same textures -> same material
+            group_materials_.push_back(meshes.front()->material_);
+        }
+
+        std::vector<MeshletVertex> gpu_vertices(vertices.size());
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            gpu_vertices[i] = {glm::vec4(vertices[i].Position, vertices[i].TexCoords.x),
+                               glm::vec4(vertices[i].Normal, vertices[i].TexCoords.y)};
+        }
+
+        cull_program_.Create("data/shaders/3D_scene/culling/meshlet_cull.comp");
+        draw_program_.Create("data/shaders/3D_scene/culling/meshlet_instancing.vert",
+                             "data/shaders/3D_scene/culling/culled_instancing_material.frag");
+        //same vertex shader (invariant gl_Position) so the color pass can test GL_EQUAL against it
+        depth_program_.Create("data/shaders/3D_scene/culling/meshlet_instancing.vert",
+                              "data/shaders/3D_scene/culling/culled_instancing_depth.frag");
+        empty_vao_.Create();
+
+        glCreateBuffers(1, &meshlets_ssbo_);
+        glNamedBufferStorage(meshlets_ssbo_, static_cast<GLsizeiptr>(meshlets_.size() * sizeof(Meshlet)),
+                             meshlets_.data(), 0);
+        glCreateBuffers(1, &indices_ssbo_);
+        glNamedBufferStorage(indices_ssbo_, static_cast<GLsizeiptr>(meshlet_indices.size() * sizeof(unsigned int)),
+                             meshlet_indices.data(), 0);
+        glCreateBuffers(1, &vertices_ssbo_);
+        glNamedBufferStorage(vertices_ssbo_, static_cast<GLsizeiptr>(gpu_vertices.size() * sizeof(MeshletVertex)),
+                             gpu_vertices.data(), 0);
+
+        //room for every meshlet of every instance in each view, the list of a group starts at its first meshlet
+        glCreateBuffers(1, &pairs_ssbo_);
+        glNamedBufferStorage(pairs_ssbo_, static_cast<GLsizeiptr>(view_count_ * meshlets_.size() * instance_count_ *
+                                                                  sizeof(glm::uvec2)), nullptr, 0);
+
+        //one draw per group per view, every meshlet is drawn with the corners of the biggest one
+        reset_commands_.assign(view_count_ * group_first_meshlet_.size(), DrawArraysIndirectCommand{});
+        for (auto &command: reset_commands_) {
+            command.count = static_cast<GLuint>(kMeshletMaxTriangles * 3);
+        }
+        glCreateBuffers(1, &commands_buffer_);
+        glNamedBufferStorage(commands_buffer_,
+                             static_cast<GLsizeiptr>(reset_commands_.size() * sizeof(DrawArraysIndirectCommand)),
+                             reset_commands_.data(), GL_DYNAMIC_STORAGE_BIT);
+
+        //x : groups over the meshlets, y : one row per LOD 0 instance, copied from the instance culling
+        const std::array<GLuint, 3> dispatch = {
+            (static_cast<GLuint>(meshlets_.size()) + kMeshletGroupSize - 1) / kMeshletGroupSize, 0, 1};
+        glCreateBuffers(1, &dispatch_buffer_);
+        glNamedBufferStorage(dispatch_buffer_, sizeof(dispatch), dispatch.data(), 0);
+
+        stats_.Create(sizeof(MeshletStats));
+    }
+
+    void MeshletCuller::Cull(const GpuInstanceCuller &instances, const Frustum &frustum, const glm::vec3 &eye,
+                             GLuint view) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //first pass of the frame : takes the next copy of the counters, CullOcclusion adds to it
+        stats_.BeginFrame();
+        const auto stats = stats_.Read<MeshletStats>();
+        tested_triangles_ = stats.tested_triangles;
+        drawn_triangles_ = stats.drawn_triangles;
+#ifdef TRACY_ENABLE
+        TracyPlot("Meshlet triangles drawn", static_cast<std::int64_t>(drawn_triangles_));
+#endif
+
+        cull_program_.Use();
+        Dispatch(instances, frustum, eye, view, false);
+        stats_.Fence();
+    }
+
+    void MeshletCuller::CullOcclusion(const GpuInstanceCuller &instances, const Frustum &frustum,
+                                      const glm::vec3 &eye, const glm::mat4 &view_projection,
+                                      const HiZPyramid &hi_z, GLuint view) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        cull_program_.Use();
+        glUniformMatrix4fv(cull_program_.UniformLocation("viewProjection"), 1, GL_FALSE, glm::value_ptr(view_projection));
+        glUniform2f(cull_program_.UniformLocation("hiZSize"), static_cast<float>(hi_z.width()),
+                    static_cast<float>(hi_z.height()));
+        glUniform1i(cull_program_.UniformLocation("hiZLevels"), hi_z.level_count());
+        glUniform1i(cull_program_.UniformLocation("hiZ"), 0);
+        GLStateCache::Get().BindTexture(0, hi_z.texture());
+
+        Dispatch(instances, frustum, eye, view, true);
+        stats_.Fence();
+    }
+
+    void MeshletCuller::Dispatch(const GpuInstanceCuller &instances, const Frustum &frustum, const glm::vec3 &eye,
+                                 GLuint view, bool occlusion) {
+        const auto group_count = static_cast<GLuint>(group_first_meshlet_.size());
+        const GLuint first_command = view * group_count;
+        constexpr auto command_size = static_cast<GLintptr>(sizeof(DrawArraysIndirectCommand));
+        glNamedBufferSubData(commands_buffer_, first_command * command_size, group_count * command_size,
+                             &reset_commands_[first_command]);
+
+        //one row of groups per visible LOD 0 instance, the count never comes back to the CPU
+        constexpr auto instance_count_offset = static_cast<GLintptr>(offsetof(DrawElementsIndirectCommand, instanceCount));
+        glCopyNamedBufferSubData(instances.commands_buffer(), dispatch_buffer_,
+                                 instances.command_index(view, 0) *
+                                 static_cast<GLintptr>(sizeof(DrawElementsIndirectCommand)) + instance_count_offset,
+                                 sizeof(GLuint), sizeof(GLuint));
+
+        const auto planes = frustum.PackedPlanes();
+        glUniform4fv(cull_program_.UniformLocation("planes"), 6, glm::value_ptr(planes[0]));
+        glUniform3fv(cull_program_.UniformLocation("eye"), 1, glm::value_ptr(eye));
+        glUniform1ui(cull_program_.UniformLocation("meshletCount"), static_cast<GLuint>(meshlets_.size()));
+        glUniform1ui(cull_program_.UniformLocation("instanceCount"), instance_count_);
+        glUniform1ui(cull_program_.UniformLocation("visibleOffset"), instances.visible_offset(view, 0));
+        glUniform1ui(cull_program_.UniformLocation("pairOffset"),
+                     view * static_cast<GLuint>(meshlets_.size()) * instance_count_);
+        glUniform1ui(cull_program_.UniformLocation("commandIndex"), first_command);
+        glUniform1i(cull_program_.UniformLocation("occlusion"), occlusion ? 1 : 0);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GpuInstanceCuller::kInstancesBinding, instances.instances_buffer());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GpuInstanceCuller::kVisibleBinding, instances.visible_buffer());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMeshletsBinding, meshlets_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMeshletIndicesBinding, indices_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPairsBinding, pairs_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kCommandsBinding, commands_buffer_);
+        stats_.Bind(kStatsBinding);
+
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, dispatch_buffer_);
+        glDispatchComputeIndirect(0);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+    }
+
+    void MeshletCuller::Draw(const GpuInstanceCuller &instances, const glm::mat4 &view_matrix,
+                             const glm::mat4 &projection, GLuint view) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        draw_program_.Use();
+        DrawGroups(draw_program_, instances, view_matrix, projection, view);
+    }
+
+    void MeshletCuller::DrawDepth(const GpuInstanceCuller &instances, const glm::mat4 &view_matrix,
+                                  const glm::mat4 &projection, GLuint view) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        depth_program_.Use();
+        DrawGroups(depth_program_, instances, view_matrix, projection, view);
+    }
+
+    void MeshletCuller::DrawGroups(const ShaderProgram &program, const GpuInstanceCuller &instances,
+                                   const glm::mat4 &view_matrix, const glm::mat4 &projection, GLuint view) const {
+        glUniformMatrix4fv(program.UniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view_matrix));
+        glUniformMatrix4fv(program.UniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        const GLint pair_offset_location = program.UniformLocation("pairOffset");
+        const GLint material_location = program.UniformLocation("material");
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GpuInstanceCuller::kInstancesBinding, instances.instances_buffer());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMeshletsBinding, meshlets_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMeshletIndicesBinding, indices_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVerticesBinding, vertices_ssbo_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPairsBinding, pairs_ssbo_);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer_);
+        GLStateCache::Get().BindVertexArray(empty_vao_.name());
+
+        const auto group_count = static_cast<GLuint>(group_first_meshlet_.size());
+        for (GLuint group = 0; group < group_count; group++) {
+            glUniform1ui(pair_offset_location, (view * static_cast<GLuint>(meshlets_.size()) +
+                                                group_first_meshlet_[group]) * instance_count_);
+            if (material_location >= 0) {
+                glUniform1ui(material_location, group_materials_[group]);
+            }
+            const auto offset = (view * group_count + group) * sizeof(DrawArraysIndirectCommand);
+            glDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<const void *>(offset));
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void MeshletCuller::Delete() {
+        cull_program_.Delete();
+        draw_program_.Delete();
+        depth_program_.Delete();
+        empty_vao_.Delete();
+        stats_.Delete();
+        glDeleteBuffers(1, &meshlets_ssbo_);
+        glDeleteBuffers(1, &indices_ssbo_);
+        glDeleteBuffers(1, &vertices_ssbo_);
+        glDeleteBuffers(1, &pairs_ssbo_);
+        glDeleteBuffers(1, &commands_buffer_);
+        glDeleteBuffers(1, &dispatch_buffer_);
+    }
+
+} // namespace gpr
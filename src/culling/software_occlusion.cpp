@@ -0,0 +1,315 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/software_occlusion.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    namespace {
+        //the same kernel is written once for 8 lanes (AVX2), 4 lanes (SSE2, always there on x64) or 1 lane (other CPUs)
+#if defined(__AVX2__)
+        using Lanes = __m256;
+        constexpr int kLaneCount = 8;
+
+        inline Lanes Broadcast(float value) { return _mm256_set1_ps(value); }
+        inline Lanes Ramp() { return _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f); }
+        inline Lanes Load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+        inline void Store(float *ptr, Lanes value) { _mm256_storeu_ps(ptr, value); }
+        inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+        inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+        inline Lanes Min(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+        inline Lanes Max(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+        inline Lanes IsPositive(Lanes a) { return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ); }
+        inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+        inline bool Any(Lanes mask) { return _mm256_movemask_ps(mask) != 0; }
+#elif defined(__SSE2__) || defined(_M_X64)
+        using Lanes = __m128;
+        constexpr int kLaneCount = 4;
+
+        inline Lanes Broadcast(float value) { return _mm_set1_ps(value); }
+        inline Lanes Ramp() { return _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f); }
+        inline Lanes Load(const float *ptr) { return _mm_loadu_ps(ptr); }
+        inline void Store(float *ptr, Lanes value) { _mm_storeu_ps(ptr, value); }
+        inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+        inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+        inline Lanes Min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+        inline Lanes Max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+        inline Lanes IsPositive(Lanes a) { return _mm_cmpge_ps(a, _mm_setzero_ps()); }
+        inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        inline bool Any(Lanes mask) { return _mm_movemask_ps(mask) != 0; }
+#else
+        using Lanes = float;
+        constexpr int kLaneCount = 1;
+
+        inline Lanes Broadcast(float value) { return value; }
+        inline Lanes Ramp() { return 0.5f; }
+        inline Lanes Load(const float *ptr) { return *ptr; }
+        inline void Store(float *ptr, Lanes value) { *ptr = value; }
+        inline Lanes Add(Lanes a, Lanes b) { return a + b; }
+        inline Lanes Mul(Lanes a, Lanes b) { return a * b; }
+        inline Lanes Min(Lanes a, Lanes b) { return std::min(a, b); }
+        inline Lanes Max(Lanes a, Lanes b) { return std::max(a, b); }
+        inline Lanes IsPositive(Lanes a) { return a >= 0.0f ? 1.0f : 0.0f; }
+        inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return mask != 0.0f ? a : b; }
+        inline bool Any(Lanes mask) { return mask != 0.0f; }
+#endif
+        static_assert(SoftwareOcclusionCuller::kWidth % kLaneCount == 0, "rows must be a multiple of the lanes");
+        static_assert(SoftwareOcclusionCuller::kTileWidth % kLaneCount == 0, "tiles must be a multiple of the lanes");
+
+        inline float HorizontalMax(Lanes value) {
+            std::array<float, kLaneCount> values{};
+            Store(values.data(), value);
+            return *std::max_element(values.begin(), values.end());
+        }
+
+        //edge function E(p) = a * p.x + b * p.y + c, positive on the inner side of a counter-clockwise triangle
+        struct Edge {
+            float a, b, c;
+
+            Edge(const glm::vec3 &from, const glm::vec3 &to)
+                    : a(-(to.y - from.y)), b(to.x - from.x), c(-(a * from.x + b * from.y)) {}
+
+            [[nodiscard]] float At(float x, float y) const { return a * x + b * y + c; }
+        };
+
+        constexpr std::size_t kTestBatchSize = 256;
+        constexpr float kNearW = 1e-4f;
+    }
+
+    SoftwareOcclusionCuller::SoftwareOcclusionCuller() {
+        depth_.resize(kWidth * kHeight, 1.0f);
+        tile_max_depth_.resize(kTilesX * kTilesY, 1.0f);
+    }
+
+    void SoftwareOcclusionCuller::BeginFrame(const glm::mat4 &view_projection) {
+        view_projection_ = view_projection;
+        triangles_.clear();
+    }
+
+    void SoftwareOcclusionCuller::AddOccluder(std::span<const glm::vec3> vertices, std::span<const std::uint32_t> indices,
+                                              const glm::mat4 &model) {
+        const glm::mat4 model_view_projection = view_projection_ * model;
+        std::vector<glm::vec4> clip(vertices.size());
+        std::transform(vertices.begin(), vertices.end(), clip.begin(), [&model_view_projection](const glm::vec3 &v) {
+            return model_view_projection * glm::vec4(v, 1.0f);
+        });
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            AddClipTriangle(clip[indices[i]], clip[indices[i + 1]], clip[indices[i + 2]]);
+        }
+    }
+
+    void SoftwareOcclusionCuller::AddBoxOccluder(const glm::vec3 &min, const glm::vec3 &max, const glm::mat4 &model) {
+        const std::array<glm::vec3, 8> corners = {
+                glm::vec3(min.x, min.y, min.z), glm::vec3(max.x, min.y, min.z),
+                glm::vec3(min.x, max.y, min.z), glm::vec3(max.x, max.y, min.z),
+                glm::vec3(min.x, min.y, max.z), glm::vec3(max.x, min.y, max.z),
+                glm::vec3(min.x, max.y, max.z), glm::vec3(max.x, max.y, max.z)
+        };
+        static constexpr std::array<std::uint32_t, 36> kBoxIndices = {
+                0, 2, 1, 1, 2, 3, //-z
+                4, 5, 6, 5, 7, 6, //+z
+                0, 1, 4, 1, 5, 4, //-y
+                2, 6, 3, 3, 6, 7, //+y
+                0, 4, 2, 2, 4, 6, //-x
+                1, 3, 5, 3, 7, 5  //+x
+        };
+        AddOccluder(corners, kBoxIndices, model);
+    }
+
+    void SoftwareOcclusionCuller::AddClipTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) {
+        //clip against the near plane (z >= -w), a triangle gives at most a quad
+        std::array<glm::vec4, 4> polygon{};
+        int count = 0;
+        const std::array<glm::vec4, 3> input = {a, b, c};
+        for (int i = 0; i < 3; i++) {
+            const glm::vec4 &current = input[i];
+            const glm::vec4 &next = input[(i + 1) % 3];
+            const float current_distance = current.z + current.w;
+            const float next_distance = next.z + next.w;
+            if (current_distance >= 0.0f) {
+                polygon[count++] = current;
+            }
+            if ((current_distance >= 0.0f) != (next_distance >= 0.0f)) {
+                const float t = current_distance / (current_distance - next_distance);
+                polygon[count++] = current + (next - current) * t;
+            }
+        }
+        if (count < 3) {
+            return;
+        }
+
+        std::array<glm::vec3, 4> screen{};
+        for (int i = 0; i < count; i++) {
+            const float inv_w = 1.0f / std::max(polygon[i].w, kNearW);
+            screen[i] = glm::vec3((polygon[i].x * inv_w * 0.5f + 0.5f) * kWidth,
+                                  (polygon[i].y * inv_w * 0.5f + 0.5f) * kHeight,
+                                  polygon[i].z * inv_w * 0.5f + 0.5f);
+        }
+
+        for (int i = 1; i + 1 < count; i++) {
+            ScreenTriangle triangle{screen[0], screen[i], screen[i + 1], 0, 0, 0, 0};
+            const float area = Edge(triangle.v0, triangle.v1).At(triangle.v2.x, triangle.v2.y);
+            if (area == 0.0f) {
+                continue;
+            }
+            //occluders are not back-face culled, a clockwise triangle is only flipped
+            if (area < 0.0f) {
+                std::swap(triangle.v1, triangle.v2);
+            }
+            const glm::vec3 min = glm::min(triangle.v0, glm::min(triangle.v1, triangle.v2));
+            const glm::vec3 max = glm::max(triangle.v0, glm::max(triangle.v1, triangle.v2));
+            if (max.x < 0.0f || max.y < 0.0f || min.x >= kWidth || min.y >= kHeight || min.z > 1.0f) {
+                continue;
+            }
+            //clamp before the conversion, vertices near the camera plane can be very far off-screen
+            triangle.min_x = static_cast<int>(std::max(min.x, 0.0f));
+            triangle.min_y = static_cast<int>(std::max(min.y, 0.0f));
+            triangle.max_x = static_cast<int>(std::min(max.x, static_cast<float>(kWidth - 1)));
+            triangle.max_y = static_cast<int>(std::min(max.y, static_cast<float>(kHeight - 1)));
+            triangles_.push_back(triangle);
+        }
+    }
+
+    void SoftwareOcclusionCuller::Rasterize() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //each band only touches its own rows -> no synchronisation between the threads
+        WorkerPool::Instance().ParallelFor(kTilesY, [this](std::size_t band) {
+            RasterizeBand(static_cast<int>(band));
+        });
+    }
+
+    void SoftwareOcclusionCuller::RasterizeBand(int band) {
+        const int band_min_y = band * kTileHeight;
+        const int band_max_y = band_min_y + kTileHeight - 1;
+        std::fill(depth_.begin() + band_min_y * kWidth, depth_.begin() + (band_max_y + 1) * kWidth, 1.0f);
+
+        const Lanes ramp = Ramp();
+        for (const auto &triangle: triangles_) {
+            if (triangle.max_y < band_min_y || triangle.min_y > band_max_y) {
+                continue;
+            }
+            const Edge e12(triangle.v1, triangle.v2), e20(triangle.v2, triangle.v0), e01(triangle.v0, triangle.v1);
+            const float inv_area = 1.0f / e01.At(triangle.v2.x, triangle.v2.y);
+            //depth is affine in screen space : z = za * x + zb * y + zc
+            const float za = (triangle.v0.z * e12.a + triangle.v1.z * e20.a + triangle.v2.z * e01.a) * inv_area;
+            const float zb = (triangle.v0.z * e12.b + triangle.v1.z * e20.b + triangle.v2.z * e01.b) * inv_area;
+            const float zc = (triangle.v0.z * e12.c + triangle.v1.z * e20.c + triangle.v2.z * e01.c) * inv_area;
+
+            const int min_y = std::max(triangle.min_y, band_min_y);
+            const int max_y = std::min(triangle.max_y, band_max_y);
+            const int min_x = triangle.min_x - triangle.min_x % kLaneCount;
+            const Lanes step_e0 = Broadcast(e12.a * kLaneCount);
+            const Lanes step_e1 = Broadcast(e20.a * kLaneCount);
+            const Lanes step_e2 = Broadcast(e01.a * kLaneCount);
+            const Lanes step_z = Broadcast(za * kLaneCount);
+
+            for (int y = min_y; y <= max_y; y++) {
+                const float py = static_cast<float>(y) + 0.5f;
+                const Lanes px = Add(Broadcast(static_cast<float>(min_x)), ramp);
+                Lanes e0 = Add(Mul(Broadcast(e12.a), px), Broadcast(e12.b * py + e12.c));
+                Lanes e1 = Add(Mul(Broadcast(e20.a), px), Broadcast(e20.b * py + e20.c));
+                Lanes e2 = Add(Mul(Broadcast(e01.a), px), Broadcast(e01.b * py + e01.c));
+                Lanes z = Add(Mul(Broadcast(za), px), Broadcast(zb * py + zc));
+
+                float *row = &depth_[y * kWidth];
+                for (int x = min_x; x <= triangle.max_x; x += kLaneCount) {
+                    const Lanes inside = IsPositive(Min(Min(e0, e1), e2));
+                    if (Any(inside)) {
+                        const Lanes current = Load(row + x);
+                        Store(row + x, Select(inside, Min(current, z), current));
+                    }
+                    e0 = Add(e0, step_e0);
+                    e1 = Add(e1, step_e1);
+                    e2 = Add(e2, step_e2);
+                    z = Add(z, step_z);
+                }
+            }
+        }
+
+        //farthest depth of each tile of the band
+        for (int tile_x = 0; tile_x < kTilesX; tile_x++) {
+            Lanes farthest = Broadcast(0.0f);
+            for (int y = band_min_y; y <= band_max_y; y++) {
+                for (int x = tile_x * kTileWidth; x < (tile_x + 1) * kTileWidth; x += kLaneCount) {
+                    farthest = Max(farthest, Load(&depth_[y * kWidth + x]));
+                }
+            }
+            tile_max_depth_[band * kTilesX + tile_x] = HorizontalMax(farthest);
+        }
+    }
+
+    bool SoftwareOcclusionCuller::IsAabbVisible(const glm::vec3 &min, const glm::vec3 &max) const {
+        glm::vec3 screen_min(std::numeric_limits<float>::max());
+        glm::vec3 screen_max(std::numeric_limits<float>::lowest());
+        for (int i = 0; i < 8; i++) {
+            const glm::vec3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+            const glm::vec4 clip = view_projection_ * glm::vec4(corner, 1.0f);
+            //crosses the camera plane -> can't be projected, keep it
+            if (clip.w <= kNearW) {
+                return true;
+            }
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            screen_min = glm::min(screen_min, ndc);
+            screen_max = glm::max(screen_max, ndc);
+        }
+
+        //outside the screen or behind the far plane
+        if (screen_max.x < -1.0f || screen_max.y < -1.0f || screen_min.x > 1.0f || screen_min.y > 1.0f ||
+            screen_min.z > 1.0f) {
+            return false;
+        }
+        const auto to_pixels = [](float ndc, int size) {
+            return std::clamp((ndc * 0.5f + 0.5f) * static_cast<float>(size), 0.0f, static_cast<float>(size - 1));
+        };
+        const int min_tile_x = static_cast<int>(to_pixels(screen_min.x, kWidth)) / kTileWidth;
+        const int min_tile_y = static_cast<int>(to_pixels(screen_min.y, kHeight)) / kTileHeight;
+        const int max_tile_x = static_cast<int>(to_pixels(screen_max.x, kWidth)) / kTileWidth;
+        const int max_tile_y = static_cast<int>(to_pixels(screen_max.y, kHeight)) / kTileHeight;
+
+        const float nearest = screen_min.z * 0.5f + 0.5f;
+        for (int tile_y = min_tile_y; tile_y <= max_tile_y; tile_y++) {
+            for (int tile_x = min_tile_x; tile_x <= max_tile_x; tile_x++) {
+                if (nearest <= tile_max_depth_[tile_y * kTilesX + tile_x]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void SoftwareOcclusionCuller::TestAabbs(const AabbBatch &boxes, std::vector<std::uint32_t> &visibility) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const std::size_t count = boxes.size();
+        visibility.resize(count);
+
+        const std::size_t batch_count = (count + kTestBatchSize - 1) / kTestBatchSize;
+        WorkerPool::Instance().ParallelFor(batch_count, [&](std::size_t batch) {
+            const std::size_t end = std::min(count, (batch + 1) * kTestBatchSize);
+            for (std::size_t i = batch * kTestBatchSize; i < end; i++) {
+                const glm::vec3 center(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+                const glm::vec3 extents(boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]);
+                visibility[i] = IsAabbVisible(center - extents, center + extents) ? 1u : 0u;
+            }
+        });
+        hidden_count_ = static_cast<std::size_t>(std::count(visibility.begin(), visibility.end(), 0u));
+    }
+
+} // namespace gpr
@@ -0,0 +1,256 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    namespace {
+        //21 bits per axis, enough for +-1M cells
+        constexpr std::int32_t kCellBias = 1 << 20;
+        constexpr std::uint64_t kCellMask = (1u << 21) - 1;
+        //cell of the objects too big for the grid, CellKey only uses 63 bits
+        constexpr std::uint64_t kLargeCell = ~std::uint64_t{0};
+
+        float SurfaceDistance(const Sphere &sphere, const glm::vec3 &point) {
+            return std::max(0.0f, glm::length(point - sphere.center()) - sphere.radius());
+        }
+    }
+
+    glm::ivec3 SpatialGrid::CellCoordinates(const glm::vec3 &point) const {
+        return glm::ivec3(glm::floor(point * inverse_cell_size_));
+    }
+
+    std::uint64_t SpatialGrid::CellKey(const glm::ivec3 &coordinates) {
+        return (static_cast<std::uint64_t>(coordinates.x + kCellBias) & kCellMask) |
+               ((static_cast<std::uint64_t>(coordinates.y + kCellBias) & kCellMask) << 21) |
+               ((static_cast<std::uint64_t>(coordinates.z + kCellBias) & kCellMask) << 42);
+    }
+
+    std::uint64_t SpatialGrid::PlacementKey(const Sphere &bounds) const {
+        return bounds.radius() > cell_size_ ? kLargeCell : CellKey(CellCoordinates(bounds.center()));
+    }
+
+    void SpatialGrid::AddToCell(Handle handle) {
+        Object &object = objects_[handle];
+        object.cell = PlacementKey(object.bounds);
+        std::vector<Handle> *handles = &large_;
+        if (object.cell != kLargeCell) {
+            Cell &cell = cells_[object.cell];
+            cell.coordinates = CellCoordinates(object.bounds.center());
+            handles = &cell.handles;
+        }
+        object.slot = static_cast<std::uint32_t>(handles->size());
+        handles->push_back(handle);
+    }
+
+    void SpatialGrid::RemoveFromCell(Handle handle) {
+        const Object &object = objects_[handle];
+        std::vector<Handle> &handles = object.cell == kLargeCell ? large_ : cells_[object.cell].handles;
+        //the last object of the cell takes the free slot
+        const Handle moved = handles.back();
+        handles[object.slot] = moved;
+        objects_[moved].slot = object.slot;
+        handles.pop_back();
+    }
+
+    SpatialGrid::Handle SpatialGrid::Insert(const Sphere &bounds, std::uint32_t user_data, std::uint32_t layer) {
+        Handle handle;
+        if (free_handles_.empty()) {
+            handle = static_cast<Handle>(objects_.size());
+            objects_.emplace_back();
+        } else {
+            handle = free_handles_.back();
+            free_handles_.pop_back();
+        }
+        objects_[handle].bounds = bounds;
+        objects_[handle].user_data = user_data;
+        objects_[handle].layer = layer;
+        AddToCell(handle);
+        return handle;
+    }
+
+    void SpatialGrid::Move(Handle handle, const glm::vec3 &center) {
+        Update(handle, Sphere(center, objects_[handle].bounds.radius()));
+    }
+
+    void SpatialGrid::Update(Handle handle, const Sphere &bounds) {
+        Object &object = objects_[handle];
+        //also leaves the large list when the object shrinks back under a cell (and the other way around)
+        if (PlacementKey(bounds) == object.cell) {
+            object.bounds = bounds;
+            return;
+        }
+        RemoveFromCell(handle);
+        object.bounds = bounds;
+        AddToCell(handle);
+    }
+
+    void SpatialGrid::Remove(Handle handle) {
+        RemoveFromCell(handle);
+        objects_[handle].layer = 0;
+        free_handles_.push_back(handle);
+    }
+
+    void SpatialGrid::Clear() {
+        objects_.clear();
+        free_handles_.clear();
+        cells_.clear();
+        large_.clear();
+    }
+
+    template<typename Visitor>
+    void SpatialGrid::ForEachInBox(const glm::vec3 &min, const glm::vec3 &max, std::uint32_t layers,
+                                   Visitor &&visit) const {
+        //the centers in the cells can be a cell outside of the box and still touch it
+        const glm::ivec3 first = CellCoordinates(min - glm::vec3(cell_size_));
+        const glm::ivec3 last = CellCoordinates(max + glm::vec3(cell_size_));
+        const glm::i64vec3 range = glm::i64vec3(last - first) + glm::i64vec3(1);
+        const auto visit_cell = [&](const std::vector<Handle> &handles) {
+            for (const Handle handle: handles) {
+                if (objects_[handle].layer & layers) {
+                    visit(handle);
+                }
+            }
+        };
+        visit_cell(large_);
+
+        if (range.x * range.y * range.z > static_cast<std::int64_t>(cells_.size())) {
+            //big query, cheaper to walk the allocated cells than every cell of the range
+            for (const auto &[key, cell]: cells_) {
+                if (glm::all(glm::greaterThanEqual(cell.coordinates, first)) &&
+                    glm::all(glm::lessThanEqual(cell.coordinates, last))) {
+                    visit_cell(cell.handles);
+                }
+            }
+            return;
+        }
+        for (int z = first.z; z <= last.z; z++) {
+            for (int y = first.y; y <= last.y; y++) {
+                for (int x = first.x; x <= last.x; x++) {
+                    const auto it = cells_.find(CellKey({x, y, z}));
+                    if (it != cells_.end()) {
+                        visit_cell(it->second.handles);
+                    }
+                }
+            }
+        }
+    }
+
+    void SpatialGrid::QuerySphere(const Sphere &sphere, std::vector<Handle> &result, std::uint32_t layers) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const glm::vec3 radius(sphere.radius());
+        ForEachInBox(sphere.center() - radius, sphere.center() + radius, layers, [&](Handle handle) {
+            const Sphere &bounds = objects_[handle].bounds;
+            const float reach = sphere.radius() + bounds.radius();
+            const glm::vec3 offset = bounds.center() - sphere.center();
+            if (glm::dot(offset, offset) <= reach * reach) {
+                result.push_back(handle);
+            }
+        });
+    }
+
+    void SpatialGrid::QueryFrustum(const Frustum &frustum, std::vector<Handle> &result, std::uint32_t layers) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        for (const Handle handle: large_) {
+            if ((objects_[handle].layer & layers) && frustum.IsSphereInFrustum(objects_[handle].bounds)) {
+                result.push_back(handle);
+            }
+        }
+        //a frustum covers too many cells to walk its range, the allocated cells are tested as loose boxes instead
+        for (const auto &[key, cell]: cells_) {
+            if (cell.handles.empty()) {
+                continue;
+            }
+            const glm::vec3 cell_min = glm::vec3(cell.coordinates - glm::ivec3(1)) * cell_size_;
+            const glm::vec3 cell_max = glm::vec3(cell.coordinates + glm::ivec3(2)) * cell_size_;
+            if (!frustum.IsAabbInFrustum(AABB(cell_min, cell_max))) {
+                continue;
+            }
+            for (const Handle handle: cell.handles) {
+                if ((objects_[handle].layer & layers) && frustum.IsSphereInFrustum(objects_[handle].bounds)) {
+                    result.push_back(handle);
+                }
+            }
+        }
+    }
+
+    SpatialGrid::Handle SpatialGrid::Nearest(const glm::vec3 &point, float max_distance, std::uint32_t layers) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        Handle best = kInvalidHandle;
+        float best_distance = max_distance;
+        const auto consider = [&](Handle handle) {
+            const float distance = SurfaceDistance(objects_[handle].bounds, point);
+            if (distance <= best_distance) {
+                best_distance = distance;
+                best = handle;
+            }
+        };
+
+        for (const Handle handle: large_) {
+            if (objects_[handle].layer & layers) {
+                consider(handle);
+            }
+        }
+
+        //the surface of an object in the cells is at most a cell closer than its center
+        const int max_ring = static_cast<int>(std::ceil(max_distance * inverse_cell_size_)) + 2;
+        const std::int64_t ring_cells = (2 * static_cast<std::int64_t>(max_ring) + 1) *
+                                        (2 * static_cast<std::int64_t>(max_ring) + 1) *
+                                        (2 * static_cast<std::int64_t>(max_ring) + 1);
+        if (ring_cells > static_cast<std::int64_t>(cells_.size())) {
+            //search radius bigger than the populated area
+            for (const auto &[key, cell]: cells_) {
+                for (const Handle handle: cell.handles) {
+                    if (objects_[handle].layer & layers) {
+                        consider(handle);
+                    }
+                }
+            }
+            return best;
+        }
+
+        //after ring r every center left is at least r cells away from the point
+        const glm::ivec3 origin = CellCoordinates(point);
+        for (int ring = 0; ring <= max_ring; ring++) {
+            if (ring > 1 && static_cast<float>(ring - 2) * cell_size_ > best_distance) {
+                break;
+            }
+            for (int z = -ring; z <= ring; z++) {
+                for (int y = -ring; y <= ring; y++) {
+                    for (int x = -ring; x <= ring; x++) {
+                        if (std::max({std::abs(x), std::abs(y), std::abs(z)}) != ring) {
+                            continue;
+                        }
+                        const auto it = cells_.find(CellKey(origin + glm::ivec3(x, y, z)));
+                        if (it == cells_.end()) {
+                            continue;
+                        }
+                        for (const Handle handle: it->second.handles) {
+                            if (objects_[handle].layer & layers) {
+                                consider(handle);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+} // namespace gpr
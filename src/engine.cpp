@@ -47,10 +47,15 @@ namespace gpr
                         break;
                     case SDL_WINDOWEVENT_RESIZED:
                     {
-                        glm::uvec2 newWindowSize;
+                        glm::ivec2 newWindowSize;
                         newWindowSize.x = event.window.data1;
                         newWindowSize.y = event.window.data2;
-                        //TODO do something with the new size
+                        //minimized
+                        if (newWindowSize.x <= 0 || newWindowSize.y <= 0)
+                        {
+                            break;
+                        }
+                        scene_->OnResize(newWindowSize.x, newWindowSize.y);
                         break;
                     }
                     default:
@@ -158,6 +163,7 @@ namespace gpr
         ImGui_ImplSDL2_InitForOpenGL(window_, glRenderContext_);
         ImGui_ImplOpenGL3_Init("#version 300 es");
 
+        scene_->OnResize(windowSize.x, windowSize.y);
         scene_->Begin();
     }
 
@@ -1,5 +1,8 @@
 #include "file_utility.h"
+#include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <sstream>
 
 namespace gpr
 {
@@ -16,4 +19,48 @@ std::string LoadFile(std::string_view path)
         std::istreambuf_iterator<char>());
     return content;
 }
+
+std::string LoadShader(std::string_view path)
+{
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    std::istringstream source(LoadFile(path));
+    std::string content;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(source, line))
+    {
+        line_number++;
+        if (line.starts_with("#extension GL_GOOGLE_include_directive"))
+        {
+            //empty line, the error messages keep the line numbers of the file
+            content += '\n';
+            continue;
+        }
+        if (!line.starts_with("#include \""))
+        {
+            content += line;
+            content += '\n';
+            continue;
+        }
+
+        const std::size_t first = line.find('"') + 1;
+        const std::size_t last = line.find('"', first);
+        const std::filesystem::path included = directory / line.substr(first, last - first);
+        if (last == std::string::npos || !std::filesystem::exists(included))
+        {
+            std::cerr << "Error while including " << included.string() << " in shader " << path << "\n";
+            content += '\n';
+            continue;
+        }
+        std::string included_content = LoadFile(included.string());
+        //the BOM is only allowed at the start of the source
+        if (included_content.starts_with("\xEF\xBB\xBF"))
+        {
+            included_content.erase(0, 3);
+        }
+        content += included_content;
+        content += "\n#line " + std::to_string(line_number + 1) + "\n";
+    }
+    return content;
+}
 } // namespace gpr
@@ -0,0 +1,230 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "load3D/hlod.h"
+#include "load3D/mesh_simplifier.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    //distance from the point to the box, 0 inside
+    static float DistanceToBox(const AABB &box, const glm::vec3 &point) {
+        return glm::length(point - glm::clamp(point, box.min, box.max));
+    }
+
+    std::vector<GLuint> HlodClusters::BuildAtlas(const std::vector<Mesh> &meshes) {
+        std::vector<GLuint> tiles;
+        for (const auto &mesh: meshes) {
+            for (const auto &texture: mesh.textures_) {
+                if (texture.type == "texture_diffuse") {
+                    if (std::find(tiles.begin(), tiles.end(), texture.id) == tiles.end()) {
+                        tiles.push_back(texture.id);
+                    }
+                    break;
+                }
+            }
+        }
+        const auto tile_count = static_cast<GLsizei>(std::max<std::size_t>(tiles.size(), 1));
+
+        //one row of tiles, every texture is scaled to the tile size
+        glCreateTextures(GL_TEXTURE_2D, 1, &atlas_);
+        glTextureStorage2D(atlas_, static_cast<GLsizei>(std::log2(kHlodTileSize)) + 1, GL_RGBA8,
+                           tile_count * kHlodTileSize, kHlodTileSize);
+        glTextureParameteri(atlas_, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(atlas_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(atlas_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(atlas_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        GLuint framebuffers[2];
+        glCreateFramebuffers(2, framebuffers);
+        glNamedFramebufferTexture(framebuffers[1], GL_COLOR_ATTACHMENT0, atlas_, 0);
+        for (GLsizei tile = 0; tile < static_cast<GLsizei>(tiles.size()); tile++) {
+            GLint width = 0, height = 0;
+            glGetTextureLevelParameteriv(tiles[tile], 0, GL_TEXTURE_WIDTH, &width);
+            glGetTextureLevelParameteriv(tiles[tile], 0, GL_TEXTURE_HEIGHT, &height);
+            glNamedFramebufferTexture(framebuffers[0], GL_COLOR_ATTACHMENT0, tiles[tile], 0);
+            glBlitNamedFramebuffer(framebuffers[0], framebuffers[1], 0, 0, width, height,
+                                   tile * kHlodTileSize, 0, (tile + 1) * kHlodTileSize, kHlodTileSize,
+                                   GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        }
+        glDeleteFramebuffers(2, framebuffers);
+        glGenerateTextureMipmap(atlas_);
+        return tiles;
+    }
+
+    void HlodClusters::Build(const Model &model, std::span<const glm::mat4> instance_matrices, float cell_size) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        program_.Create("data/shaders/3D_scene/hlod/hlod_proxy.vert", "data/shaders/3D_scene/hlod/hlod_proxy.frag");
+
+        //the proxies start from the coarsest level that still has triangles
+        std::size_t coarsest = model.lod_count() - 1;
+        while (coarsest > 0 && model.lod_meshes(coarsest).empty()) {
+            coarsest--;
+        }
+        const std::vector<Mesh> &meshes = model.lod_meshes(coarsest);
+        const std::vector<GLuint> tiles = BuildAtlas(meshes);
+        const float tile_width = 1.0f / static_cast<float>(std::max<std::size_t>(tiles.size(), 1));
+
+        //atlas tile of each mesh, kept in m_BoneIDs[0] through the simplification
+        std::vector<int> mesh_tiles(meshes.size(), 0);
+        for (std::size_t i = 0; i < meshes.size(); i++) {
+            for (const auto &texture: meshes[i].textures_) {
+                if (texture.type == "texture_diffuse") {
+                    mesh_tiles[i] = static_cast<int>(std::find(tiles.begin(), tiles.end(), texture.id) - tiles.begin());
+                    break;
+                }
+            }
+        }
+
+        //group by grid cell of the instance center
+        const glm::vec3 local_center = model.bounds_.center();
+        std::map<std::pair<int, int>, std::size_t> cells;
+        clusters_.clear();
+        instance_clusters_.resize(instance_matrices.size());
+        for (std::size_t i = 0; i < instance_matrices.size(); i++) {
+            const glm::vec3 center(instance_matrices[i] * glm::vec4(local_center, 1.0f));
+            const std::pair<int, int> cell(static_cast<int>(std::floor(center.x / cell_size)),
+                                           static_cast<int>(std::floor(center.z / cell_size)));
+            auto [it, inserted] = cells.try_emplace(cell, clusters_.size());
+            if (inserted) {
+                clusters_.emplace_back();
+            }
+            Cluster &cluster = clusters_[it->second];
+            cluster.members.push_back(static_cast<std::uint32_t>(i));
+            cluster.bounds.Expand(model.bounds_.Transformed(instance_matrices[i]));
+            instance_clusters_[i] = static_cast<GLuint>(it->second);
+        }
+
+        for (auto &cluster: clusters_) {
+            //every member in world space, one vertex list for the whole cluster
+            std::vector<Vertex> vertices;
+            std::vector<unsigned int> indices;
+            for (const std::uint32_t member: cluster.members) {
+                const glm::mat4 &matrix = instance_matrices[member];
+                const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
+                for (std::size_t m = 0; m < meshes.size(); m++) {
+                    const auto base = static_cast<unsigned int>(vertices.size());
+                    for (Vertex vertex: meshes[m].vertices_) {
+                        vertex.Position = glm::vec3(matrix * glm::vec4(vertex.Position, 1.0f));
+                        vertex.Normal = glm::normalize(normal_matrix * vertex.Normal);
+                        vertex.m_BoneIDs[0] = mesh_tiles[m];
+                        vertices.push_back(vertex);
+                    }
+                    for (const unsigned int index: meshes[m].indices_) {
+                        indices.push_back(base + index);
+                    }
+                }
+            }
+
+            const std::size_t target = std::min(static_cast<std::size_t>(static_cast<float>(indices.size()) * kLodReduction),
+                                                kHlodProxyTriangleBudget * 3) / 3 * 3;
+            std::vector<unsigned int> proxy_indices = SimplifyMesh(vertices, indices, target);
+            const std::vector<Vertex> proxy_vertices = CompactVertices(vertices, proxy_indices);
+
+            std::vector<ProxyVertex> gpu_vertices(proxy_vertices.size());
+            for (std::size_t i = 0; i < proxy_vertices.size(); i++) {
+                const Vertex &vertex = proxy_vertices[i];
+                gpu_vertices[i] = {vertex.Position, vertex.Normal, vertex.TexCoords,
+                                   glm::vec4(static_cast<float>(vertex.m_BoneIDs[0]) * tile_width, 0.0f, tile_width, 1.0f)};
+            }
+            cluster.index_count = static_cast<GLsizei>(proxy_indices.size());
+
+            cluster.vao.Create();
+            cluster.vbo.Create();
+            cluster.ebo.Create();
+            cluster.vbo.Storage(static_cast<GLsizeiptr>(gpu_vertices.size() * sizeof(ProxyVertex)), gpu_vertices.data());
+            cluster.ebo.Storage(static_cast<GLsizeiptr>(proxy_indices.size() * sizeof(unsigned int)),
+                                proxy_indices.data());
+            cluster.vao.SetVertexBuffer(0, cluster.vbo, 0, sizeof(ProxyVertex));
+            cluster.vao.SetElementBuffer(cluster.ebo);
+            cluster.vao.SetAttribute(0, 3, GL_FLOAT, offsetof(ProxyVertex, position));
+            cluster.vao.SetAttribute(1, 3, GL_FLOAT, offsetof(ProxyVertex, normal));
+            cluster.vao.SetAttribute(2, 2, GL_FLOAT, offsetof(ProxyVertex, tex_coords));
+            cluster.vao.SetAttribute(3, 4, GL_FLOAT, offsetof(ProxyVertex, atlas_rect));
+        }
+
+        proxied_.assign(clusters_.size(), 0);
+        proxied_count_ = 0;
+    }
+
+    bool HlodClusters::Select(const glm::vec3 &eye, float distance) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        bool changed = false;
+        proxied_count_ = 0;
+        for (std::size_t i = 0; i < clusters_.size(); i++) {
+            const float to_cluster = DistanceToBox(clusters_[i].bounds, eye);
+            GLuint proxied = proxied_[i];
+            if (proxied == 0 && to_cluster > distance * (1.0f + kHlodHysteresis)) {
+                proxied = 1;
+            } else if (proxied != 0 && to_cluster < distance * (1.0f - kHlodHysteresis)) {
+                proxied = 0;
+            }
+            changed |= proxied != proxied_[i];
+            proxied_[i] = proxied;
+            proxied_count_ += proxied;
+        }
+        return changed;
+    }
+
+    void HlodClusters::DrawProxies(const Frustum &frustum) const {
+        drawn_proxies_ = 0;
+        drawn_triangles_ = 0;
+        for (std::size_t i = 0; i < clusters_.size(); i++) {
+            if (proxied_[i] == 0 || !frustum.IsAabbInFrustum(clusters_[i].bounds)) {
+                continue;
+            }
+            GLStateCache::Get().BindVertexArray(clusters_[i].vao.name());
+            glDrawElements(GL_TRIANGLES, clusters_[i].index_count, GL_UNSIGNED_INT, nullptr);
+            drawn_proxies_++;
+            drawn_triangles_ += static_cast<std::size_t>(clusters_[i].index_count) / 3;
+        }
+    }
+
+    void HlodClusters::Draw(const glm::mat4 &view, const glm::mat4 &projection, const Frustum &frustum) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        program_.Use();
+        glUniformMatrix4fv(program_.UniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(program_.UniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform1i(program_.UniformLocation("atlas"), 0);
+        GLStateCache::Get().BindTexture(0, atlas_);
+        DrawProxies(frustum);
+    }
+
+    void HlodClusters::DrawDepth(GLuint program, const Frustum &frustum) const {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const glm::mat4 identity(1.0f);
+        glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(identity));
+        DrawProxies(frustum);
+    }
+
+    void HlodClusters::Delete() {
+        program_.Delete();
+        glDeleteTextures(1, &atlas_);
+        for (auto &cluster: clusters_) {
+            cluster.vao.Delete();
+            cluster.vbo.Delete();
+            cluster.ebo.Delete();
+        }
+        clusters_.clear();
+    }
+
+} // namespace gpr
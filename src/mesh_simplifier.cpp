@@ -0,0 +1,312 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "load3D/mesh_simplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    namespace {
+        //weight of the planes added along open borders, relative to the faces
+        constexpr double kBorderQuadricWeight = 10.0;
+
+        //symmetric 4x4 matrix, only the upper triangle is stored
+        struct Quadric {
+            double a00 = 0, a01 = 0, a02 = 0, a03 = 0, a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
+
+            //plane dot(normal, p) + d = 0
+            static Quadric FromPlane(const glm::dvec3 &normal, double d, double weight) {
+                Quadric q;
+                q.a00 = weight * normal.x * normal.x;
+                q.a01 = weight * normal.x * normal.y;
+                q.a02 = weight * normal.x * normal.z;
+                q.a03 = weight * normal.x * d;
+                q.a11 = weight * normal.y * normal.y;
+                q.a12 = weight * normal.y * normal.z;
+                q.a13 = weight * normal.y * d;
+                q.a22 = weight * normal.z * normal.z;
+                q.a23 = weight * normal.z * d;
+                q.a33 = weight * d * d;
+                return q;
+            }
+
+            Quadric &operator+=(const Quadric &other) {
+                a00 += other.a00, a01 += other.a01, a02 += other.a02, a03 += other.a03;
+                a11 += other.a11, a12 += other.a12, a13 += other.a13;
+                a22 += other.a22, a23 += other.a23, a33 += other.a33;
+                return *this;
+            }
+
+            //sum of the squared distances to the planes
+            [[nodiscard]] double Error(const glm::dvec3 &p) const {
+                return a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x +
+                       a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y +
+                       a22 * p.z * p.z + 2.0 * a23 * p.z + a33;
+            }
+        };
+
+        //from moves onto to, outdated when one of the two vertices changed since it was pushed
+        struct Collapse {
+            double cost = 0.0;
+            std::uint32_t from = 0, to = 0;
+            std::uint32_t from_version = 0, to_version = 0;
+
+            bool operator>(const Collapse &other) const { return cost > other.cost; }
+        };
+
+        std::uint64_t EdgeKey(std::uint32_t a, std::uint32_t b) {
+            if (a > b) {
+                std::swap(a, b);
+            }
+            return (static_cast<std::uint64_t>(a) << 32) | b;
+        }
+
+        struct PositionHash {
+            std::size_t operator()(const glm::vec3 &position) const {
+                //+ 0.0f turns -0 into +0 so equal positions hash the same
+                const glm::vec3 normalized = position + glm::vec3(0.0f);
+                std::array<std::uint32_t, 3> bits{};
+                std::memcpy(bits.data(), &normalized, sizeof(bits));
+                return std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(bits[0]) * 73856093u) ^
+                                                  (static_cast<std::uint64_t>(bits[1]) * 19349663u) ^
+                                                  (static_cast<std::uint64_t>(bits[2]) * 83492791u));
+            }
+        };
+    }
+
+    std::vector<unsigned int> SimplifyMesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices,
+                                           std::size_t target_index_count, float max_error) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        if (indices.size() <= target_index_count) {
+            return {indices.begin(), indices.end()};
+        }
+
+        //weld by position, the vertices sharing a position are the wedges of that position
+        std::unordered_map<glm::vec3, std::uint32_t, PositionHash> position_ids;
+        std::vector<std::uint32_t> position_of(vertices.size());
+        std::vector<glm::dvec3> positions;
+        std::vector<std::vector<std::uint32_t>> wedges;
+        for (std::uint32_t v = 0; v < vertices.size(); v++) {
+            const auto [it, inserted] = position_ids.try_emplace(vertices[v].Position,
+                                                                 static_cast<std::uint32_t>(positions.size()));
+            if (inserted) {
+                positions.emplace_back(vertices[v].Position);
+                wedges.emplace_back();
+            }
+            position_of[v] = it->second;
+            wedges[it->second].push_back(v);
+        }
+
+        const std::size_t triangle_count = indices.size() / 3;
+        std::vector<std::array<std::uint32_t, 3>> triangles(triangle_count);
+        std::vector<bool> triangle_alive(triangle_count, false);
+        std::vector<Quadric> quadrics(positions.size());
+        std::vector<std::vector<std::uint32_t>> position_triangles(positions.size());
+        std::unordered_map<std::uint64_t, std::uint32_t> edge_use;
+        std::size_t alive_count = 0;
+
+        const auto corner_position = [&](std::uint32_t triangle, int corner) {
+            return position_of[triangles[triangle][corner]];
+        };
+
+        for (std::uint32_t t = 0; t < triangle_count; t++) {
+            triangles[t] = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+            const std::uint32_t p0 = corner_position(t, 0), p1 = corner_position(t, 1), p2 = corner_position(t, 2);
+            if (p0 == p1 || p1 == p2 || p2 == p0) {
+                continue;
+            }
+            triangle_alive[t] = true;
+            alive_count++;
+
+            const glm::dvec3 normal = glm::cross(positions[p1] - positions[p0], positions[p2] - positions[p0]);
+            const double length = glm::length(normal);
+            if (length > 0.0) {
+                //weighted by the area so big faces count more than slivers
+                const glm::dvec3 unit = normal / length;
+                const Quadric plane = Quadric::FromPlane(unit, -glm::dot(unit, positions[p0]), length * 0.5);
+                quadrics[p0] += plane;
+                quadrics[p1] += plane;
+                quadrics[p2] += plane;
+            }
+            for (const std::uint32_t p: {p0, p1, p2}) {
+                position_triangles[p].push_back(t);
+            }
+            edge_use[EdgeKey(p0, p1)]++;
+            edge_use[EdgeKey(p1, p2)]++;
+            edge_use[EdgeKey(p2, p0)]++;
+        }
+
+        //open borders : plane through the edge, perpendicular to the face
+        for (std::uint32_t t = 0; t < triangle_count; t++) {
+            if (!triangle_alive[t]) {
+                continue;
+            }
+            const std::array<std::uint32_t, 3> p = {corner_position(t, 0), corner_position(t, 1), corner_position(t, 2)};
+            const glm::dvec3 face_normal = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+            for (int e = 0; e < 3; e++) {
+                const std::uint32_t a = p[e], b = p[(e + 1) % 3];
+                if (edge_use[EdgeKey(a, b)] != 1) {
+                    continue;
+                }
+                const glm::dvec3 edge = positions[b] - positions[a];
+                const glm::dvec3 border_normal = glm::cross(edge, face_normal);
+                const double length = glm::length(border_normal);
+                if (length <= 0.0) {
+                    continue;
+                }
+                const glm::dvec3 unit = border_normal / length;
+                const Quadric plane = Quadric::FromPlane(unit, -glm::dot(unit, positions[a]),
+                                                         glm::dot(edge, edge) * kBorderQuadricWeight);
+                quadrics[a] += plane;
+                quadrics[b] += plane;
+            }
+        }
+
+        std::vector<std::uint32_t> versions(positions.size(), 0);
+        std::vector<bool> removed(positions.size(), false);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> heap;
+        //both directions are pushed, the cheapest one may flip a face and be refused
+        const auto push_edge = [&](std::uint32_t a, std::uint32_t b) {
+            Quadric sum = quadrics[a];
+            sum += quadrics[b];
+            heap.push({sum.Error(positions[b]), a, b, versions[a], versions[b]});
+            heap.push({sum.Error(positions[a]), b, a, versions[b], versions[a]});
+        };
+        for (const auto &[key, use]: edge_use) {
+            push_edge(static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key & 0xFFFFFFFFu));
+        }
+
+        //wedge of the target position whose attributes are the closest to the wedge being moved
+        const auto closest_wedge = [&](std::uint32_t wedge, std::uint32_t position) {
+            std::uint32_t best = wedges[position].front();
+            float best_score = std::numeric_limits<float>::max();
+            for (const std::uint32_t candidate: wedges[position]) {
+                const glm::vec2 uv = vertices[candidate].TexCoords - vertices[wedge].TexCoords;
+                const float score = glm::dot(uv, uv) + (1.0f - glm::dot(vertices[candidate].Normal, vertices[wedge].Normal));
+                if (score < best_score) {
+                    best_score = score;
+                    best = candidate;
+                }
+            }
+            return best;
+        };
+
+        const double error_limit = static_cast<double>(max_error) * static_cast<double>(max_error);
+        const auto triangle_contains = [&](std::uint32_t t, std::uint32_t position) {
+            return corner_position(t, 0) == position || corner_position(t, 1) == position ||
+                   corner_position(t, 2) == position;
+        };
+        std::vector<std::uint32_t> neighbors;
+        while (alive_count * 3 > target_index_count && !heap.empty()) {
+            const Collapse collapse = heap.top();
+            heap.pop();
+            if (removed[collapse.from] || removed[collapse.to] || versions[collapse.from] != collapse.from_version ||
+                versions[collapse.to] != collapse.to_version) {
+                continue;
+            }
+            if (collapse.cost > error_limit) {
+                break;
+            }
+
+            //refuse the collapse when a remaining face around from would turn over
+            bool flips = false;
+            for (const std::uint32_t t: position_triangles[collapse.from]) {
+                if (!triangle_alive[t] || triangle_contains(t, collapse.to)) {
+                    continue;
+                }
+                std::array<glm::dvec3, 3> corners{};
+                for (int k = 0; k < 3; k++) {
+                    corners[k] = positions[corner_position(t, k)];
+                }
+                const glm::dvec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                for (int k = 0; k < 3; k++) {
+                    if (corner_position(t, k) == collapse.from) {
+                        corners[k] = positions[collapse.to];
+                    }
+                }
+                const glm::dvec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                if (glm::dot(before, after) <= 0.0) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips) {
+                continue;
+            }
+
+            quadrics[collapse.to] += quadrics[collapse.from];
+            removed[collapse.from] = true;
+            versions[collapse.to]++;
+            for (const std::uint32_t t: position_triangles[collapse.from]) {
+                if (!triangle_alive[t]) {
+                    continue;
+                }
+                if (triangle_contains(t, collapse.to)) {
+                    triangle_alive[t] = false;
+                    alive_count--;
+                    continue;
+                }
+                for (auto &corner: triangles[t]) {
+                    if (position_of[corner] == collapse.from) {
+                        corner = closest_wedge(corner, collapse.to);
+                    }
+                }
+                position_triangles[collapse.to].push_back(t);
+            }
+            position_triangles[collapse.from].clear();
+
+            auto &around = position_triangles[collapse.to];
+            around.erase(std::remove_if(around.begin(), around.end(),
+                                        [&](std::uint32_t t) { return !triangle_alive[t]; }), around.end());
+            neighbors.clear();
+            for (const std::uint32_t t: around) {
+                for (int k = 0; k < 3; k++) {
+                    const std::uint32_t p = corner_position(t, k);
+                    if (p != collapse.to && std::find(neighbors.begin(), neighbors.end(), p) == neighbors.end()) {
+                        neighbors.push_back(p);
+                    }
+                }
+            }
+            for (const std::uint32_t neighbor: neighbors) {
+                push_edge(collapse.to, neighbor);
+            }
+        }
+
+        std::vector<unsigned int> result;
+        result.reserve(alive_count * 3);
+        for (std::uint32_t t = 0; t < triangle_count; t++) {
+            if (triangle_alive[t]) {
+                result.insert(result.end(), triangles[t].begin(), triangles[t].end());
+            }
+        }
+        return result;
+    }
+
+    std::vector<Vertex> CompactVertices(std::span<const Vertex> vertices, std::vector<unsigned int> &indices) {
+        std::vector<unsigned int> remap(vertices.size(), std::numeric_limits<unsigned int>::max());
+        std::vector<Vertex> result;
+        for (auto &index: indices) {
+            if (remap[index] == std::numeric_limits<unsigned int>::max()) {
+                remap[index] = static_cast<unsigned int>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        return result;
+    }
+
+} // namespace gpr
@@ -0,0 +1,116 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "load3D/meshlet.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    //bounds and cone of the triangles [first_index, first_index + triangle_count * 3)
+    static void ComputeMeshletBounds(std::span<const Vertex> vertices, std::span<const unsigned int> meshlet_indices,
+                                     bool front_face_ccw, Meshlet &meshlet) {
+        AABB box;
+        std::array<glm::vec3, kMeshletMaxTriangles> normals{};
+        std::size_t normal_count = 0;
+        glm::vec3 axis(0.0f);
+        for (std::uint32_t t = 0; t < meshlet.triangle_count; t++) {
+            const std::size_t i = meshlet.first_index + t * 3;
+            const glm::vec3 &a = vertices[meshlet_indices[i]].Position;
+            const glm::vec3 &b = vertices[meshlet_indices[i + 1]].Position;
+            const glm::vec3 &c = vertices[meshlet_indices[i + 2]].Position;
+            box.Expand(a);
+            box.Expand(b);
+            box.Expand(c);
+            glm::vec3 normal = glm::cross(b - a, c - a);
+            const float length = glm::length(normal);
+            //degenerate triangles are never drawn, they don't widen the cone
+            if (length <= 1e-12f) {
+                continue;
+            }
+            normal /= front_face_ccw ? length : -length;
+            normals[normal_count++] = normal;
+            axis += normal;
+        }
+
+        const glm::vec3 center = box.center();
+        float radius = 0.0f;
+        for (std::uint32_t i = 0; i < meshlet.triangle_count * 3; i++) {
+            radius = std::max(radius, glm::length(vertices[meshlet_indices[meshlet.first_index + i]].Position - center));
+        }
+        meshlet.sphere = glm::vec4(center, radius);
+
+        //the cone is only usable when every normal is less than 90 degrees away from the axis
+        meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        const float axis_length = glm::length(axis);
+        if (normal_count == 0 || axis_length <= 1e-6f) {
+            return;
+        }
+        axis /= axis_length;
+        float min_dot = 1.0f;
+        for (std::size_t i = 0; i < normal_count; i++) {
+            min_dot = std::min(min_dot, glm::dot(axis, normals[i]));
+        }
+        if (min_dot <= 0.0f) {
+            meshlet.cone = glm::vec4(axis, 1.0f);
+            return;
+        }
+        meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - min_dot * min_dot));
+    }
+
+    void BuildMeshlets(std::span<const Vertex> vertices, std::span<const unsigned int> indices, bool front_face_ccw,
+                       std::vector<Meshlet> &meshlets, std::vector<unsigned int> &meshlet_indices) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //vertices already in the current meshlet, a small linear set (at most kMeshletMaxVertices)
+        std::array<unsigned int, kMeshletMaxVertices> used{};
+        std::size_t used_count = 0;
+        Meshlet current;
+        current.first_index = static_cast<std::uint32_t>(meshlet_indices.size());
+
+        const auto close_meshlet = [&]() {
+            if (current.triangle_count > 0) {
+                ComputeMeshletBounds(vertices, meshlet_indices, front_face_ccw, current);
+                meshlets.push_back(current);
+            }
+            current = Meshlet{};
+            current.first_index = static_cast<std::uint32_t>(meshlet_indices.size());
+            used_count = 0;
+        };
+
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            std::size_t new_vertices = 0;
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                const unsigned int index = indices[i + corner];
+                const bool known = std::find(used.begin(), used.begin() + static_cast<std::ptrdiff_t>(used_count), index) !=
+                                   used.begin() + static_cast<std::ptrdiff_t>(used_count);
+                //a triangle using the same vertex twice only counts it once
+                const bool repeated = (corner > 0 && indices[i] == index) || (corner > 1 && indices[i + 1] == index);
+                if (!known && !repeated) {
+                    new_vertices++;
+                }
+            }
+            if (used_count + new_vertices > kMeshletMaxVertices || current.triangle_count + 1 > kMeshletMaxTriangles) {
+                close_meshlet();
+            }
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                const unsigned int index = indices[i + corner];
+                if (std::find(used.begin(), used.begin() + static_cast<std::ptrdiff_t>(used_count), index) ==
+                    used.begin() + static_cast<std::ptrdiff_t>(used_count)) {
+                    used[used_count++] = index;
+                }
+                meshlet_indices.push_back(index);
+            }
+            current.triangle_count++;
+        }
+        close_meshlet();
+    }
+
+} // namespace gpr
@@ -0,0 +1,166 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "load3D/octahedral_impostor.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <array>
+#include <cmath>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    //point of the square [-1, 1]² -> direction, same as OctahedronDecode in impostor.vert
+    static glm::vec3 OctahedronDecode(const glm::vec2 &point) {
+        glm::vec3 direction(point.x, point.y, 1.0f - std::abs(point.x) - std::abs(point.y));
+        if (direction.z < 0.0f) {
+            const glm::vec2 folded = (1.0f - glm::abs(glm::vec2(direction.y, direction.x))) *
+                                     glm::vec2(direction.x >= 0.0f ? 1.0f : -1.0f, direction.y >= 0.0f ? 1.0f : -1.0f);
+            direction.x = folded.x;
+            direction.y = folded.y;
+        }
+        return glm::normalize(direction);
+    }
+
+    void OctahedralImpostor::Bake(Model &model) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        sphere_ = glm::vec4(model.bounding_sphere_.center(), model.bounding_sphere_.radius());
+        bake_program_.Create("data/shaders/3D_scene/impostor/impostor_bake.vert",
+                             "data/shaders/3D_scene/impostor/impostor_bake.frag");
+        render_program_.Create("data/shaders/3D_scene/impostor/impostor.vert",
+                               "data/shaders/3D_scene/impostor/impostor.frag");
+
+        //atlases : albedo with mips for the distance, normal, depth along the frame direction in radius units
+        glCreateTextures(GL_TEXTURE_2D, 1, &albedo_atlas_);
+        glTextureStorage2D(albedo_atlas_, static_cast<GLsizei>(std::log2(kFrameSize)) + 1, GL_RGBA8, kAtlasSize,
+                           kAtlasSize);
+        glTextureParameteri(albedo_atlas_, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(albedo_atlas_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glCreateTextures(GL_TEXTURE_2D, 1, &normal_atlas_);
+        glTextureStorage2D(normal_atlas_, 1, GL_RGBA8, kAtlasSize, kAtlasSize);
+        glCreateTextures(GL_TEXTURE_2D, 1, &depth_atlas_);
+        glTextureStorage2D(depth_atlas_, 1, GL_R16F, kAtlasSize, kAtlasSize);
+        for (const GLuint texture: {normal_atlas_, depth_atlas_}) {
+            glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        for (const GLuint texture: {albedo_atlas_, normal_atlas_, depth_atlas_}) {
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        GLuint depth_buffer = 0;
+        glCreateRenderbuffers(1, &depth_buffer);
+        glNamedRenderbufferStorage(depth_buffer, GL_DEPTH_COMPONENT24, kAtlasSize, kAtlasSize);
+        GLuint framebuffer = 0;
+        glCreateFramebuffers(1, &framebuffer);
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, albedo_atlas_, 0);
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT1, normal_atlas_, 0);
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT2, depth_atlas_, 0);
+        glNamedFramebufferRenderbuffer(framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
+        constexpr std::array<GLenum, 3> attachments = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+        glNamedFramebufferDrawBuffers(framebuffer, static_cast<GLsizei>(attachments.size()), attachments.data());
+        if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Error while creating the impostor framebuffer\n";
+        }
+
+        //the bake runs in the middle of the scene setup, everything it changes is put back
+        GLint previous_framebuffer = 0;
+        std::array<GLint, 4> previous_viewport{};
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+        glGetIntegerv(GL_VIEWPORT, previous_viewport.data());
+        const GLboolean cull_face = glIsEnabled(GL_CULL_FACE);
+        const GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+        constexpr std::array<float, 4> kClear = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (GLint attachment = 0; attachment < 3; attachment++) {
+            glClearNamedFramebufferfv(framebuffer, GL_COLOR, attachment, kClear.data());
+        }
+        glClearNamedFramebufferfi(framebuffer, GL_DEPTH_STENCIL, 0, 1.0f, 0);
+
+        bake_program_.Use();
+        const glm::vec3 center(sphere_);
+        const float radius = sphere_.w;
+        //orthographic so the card can be any size on screen, the depth range covers the whole sphere
+        const glm::mat4 projection = glm::ortho(-radius, radius, -radius, radius, radius, 3.0f * radius);
+        glUniformMatrix4fv(bake_program_.UniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform4fv(bake_program_.UniformLocation("sphere"), 1, glm::value_ptr(sphere_));
+        for (int y = 0; y < kFramesPerSide; y++) {
+            for (int x = 0; x < kFramesPerSide; x++) {
+                const glm::vec2 point = (glm::vec2(x, y) + 0.5f) / static_cast<float>(kFramesPerSide) * 2.0f - 1.0f;
+                const glm::vec3 direction = OctahedronDecode(point);
+                //same basis as impostor.vert, the up hint only changes at the poles
+                const glm::vec3 up_hint = std::abs(direction.z) > 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f)
+                                                                          : glm::vec3(0.0f, 0.0f, 1.0f);
+                const glm::mat4 view = glm::lookAt(center + direction * 2.0f * radius, center, up_hint);
+                glUniformMatrix4fv(bake_program_.UniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+                glUniform3fv(bake_program_.UniformLocation("frameDirection"), 1, glm::value_ptr(direction));
+                glViewport(x * kFrameSize, y * kFrameSize, kFrameSize, kFrameSize);
+                GLuint program = bake_program_.name();
+                model.Draw(program);
+            }
+        }
+        glGenerateTextureMipmap(albedo_atlas_);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+        glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+        if (cull_face) {
+            glEnable(GL_CULL_FACE);
+        }
+        if (!depth_test) {
+            glDisable(GL_DEPTH_TEST);
+        }
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &depth_buffer);
+
+        //card corners, the vertex shader orients them toward the frame of the instance
+        constexpr std::array<float, 8> kCorners = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+        constexpr std::array<GLuint, kIndexCount> kIndices = {0, 1, 2, 0, 2, 3};
+        quad_vao_.Create();
+        quad_vbo_.Create();
+        quad_ebo_.Create();
+        quad_vbo_.Storage(sizeof(kCorners), kCorners.data());
+        quad_ebo_.Storage(sizeof(kIndices), kIndices.data());
+        quad_vao_.SetVertexBuffer(0, quad_vbo_, 0, 2 * sizeof(float));
+        quad_vao_.SetElementBuffer(quad_ebo_);
+        quad_vao_.SetAttribute(0, 2, GL_FLOAT, 0);
+    }
+
+    void OctahedralImpostor::Use(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &eye) const {
+        render_program_.Use();
+        glUniformMatrix4fv(render_program_.UniformLocation("view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(render_program_.UniformLocation("projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform3fv(render_program_.UniformLocation("eye"), 1, glm::value_ptr(eye));
+        glUniform4fv(render_program_.UniformLocation("sphere"), 1, glm::value_ptr(sphere_));
+        glUniform1i(render_program_.UniformLocation("framesPerSide"), kFramesPerSide);
+        glUniform1i(render_program_.UniformLocation("albedoAtlas"), 0);
+        glUniform1i(render_program_.UniformLocation("depthAtlas"), 1);
+        GLStateCache &state = GLStateCache::Get();
+        state.BindTexture(0, albedo_atlas_);
+        state.BindTexture(1, depth_atlas_);
+        state.BindVertexArray(quad_vao_.name());
+    }
+
+    void OctahedralImpostor::Delete() {
+        bake_program_.Delete();
+        render_program_.Delete();
+        glDeleteTextures(1, &albedo_atlas_);
+        glDeleteTextures(1, &normal_atlas_);
+        glDeleteTextures(1, &depth_atlas_);
+        quad_vao_.Delete();
+        quad_vbo_.Delete();
+        quad_ebo_.Delete();
+    }
+
+} // namespace gpr
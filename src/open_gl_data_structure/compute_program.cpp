@@ -0,0 +1,49 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/compute_program.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+#include "file_utility.h"
+
+#include <iostream>
+
+void ComputeProgram::Create(const char *path) {
+    auto content = gpr::LoadShader(path);
+    auto *ptr = content.data();
+    GLint success;
+
+    const GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &ptr, nullptr);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        std::cerr << "Error while loading compute shader " << path << "\n";
+    }
+
+    name_ = glCreateProgram();
+    glAttachShader(name_, shader);
+    glLinkProgram(name_);
+    glGetProgramiv(name_, GL_LINK_STATUS, &success);
+    if (!success) {
+        std::cerr << "Error while linking compute program " << path << "\n";
+    }
+    glDeleteShader(shader);
+}
+
+void ComputeProgram::Use() const {
+    GLStateCache::Get().UseProgram(name_);
+}
+
+void ComputeProgram::Dispatch(GLuint groups_x, GLuint groups_y, GLuint groups_z, GLbitfield barriers) {
+    glDispatchCompute(groups_x, groups_y, groups_z);
+    glMemoryBarrier(barriers);
+}
+
+GLint ComputeProgram::UniformLocation(const char *uniform) const {
+    return glGetUniformLocation(name_, uniform);
+}
+
+void ComputeProgram::Delete() {
+    glDeleteProgram(name_);
+}
@@ -9,7 +9,7 @@ EBO::EBO(GLuint &name) {
 }
 
 void EBO::Create() {
-    glGenBuffers(1, &name_);
+    glCreateBuffers(1, &name_);
 }
 
 
@@ -21,6 +21,22 @@ void EBO::BindData(GLsizei size, const void *data, GLenum usage) const {
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, usage);
 }
 
+void EBO::Storage(GLsizeiptr size, const void *data, GLbitfield flags) const {
+    glNamedBufferStorage(name_, size, data, flags);
+}
+
+void EBO::SubData(GLintptr offset, GLsizeiptr size, const void *data) const {
+    glNamedBufferSubData(name_, offset, size, data);
+}
+
+void *EBO::Map(GLintptr offset, GLsizeiptr length, GLbitfield access) const {
+    return glMapNamedBufferRange(name_, offset, length, access);
+}
+
+void EBO::Unmap() const {
+    glUnmapNamedBuffer(name_);
+}
+
 void EBO::Delete() {
     glDeleteBuffers(1 , &name_);
 }
\ No newline at end of file
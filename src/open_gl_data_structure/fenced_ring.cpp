@@ -0,0 +1,62 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/fenced_ring.h"
+
+#include <iostream>
+
+//1 second, only reached if the GPU is lost
+static constexpr GLuint64 kFenceTimeout = 1'000'000'000;
+
+void FencedRing::Create(GLsizeiptr partition_size, GLintptr alignment, GLbitfield map_flags, const char* what) {
+    what_ = what;
+    partition_size_ = (partition_size + alignment - 1) / alignment * alignment;
+    glCreateBuffers(1, &name_);
+    glNamedBufferStorage(name_, size(), nullptr, map_flags);
+    mapped_ = static_cast<std::byte*>(glMapNamedBufferRange(name_, 0, size(), map_flags));
+    if (mapped_ == nullptr) {
+        std::cerr << "Error while mapping the " << what_ << "\n";
+    }
+}
+
+bool FencedRing::Advance() {
+    partition_ = (partition_ + 1) % kFramesInFlight;
+    GLsync &fence = fences_[partition_];
+    if (fence == nullptr) {
+        return true;
+    }
+    //the partition was used kFramesInFlight frames ago, it is normally done already
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        stall_count_++;
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeout);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+    if (result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED) {
+        std::cerr << "Error while waiting for the " << what_ << " fence\n";
+        return false;
+    }
+    return true;
+}
+
+void FencedRing::Fence() {
+    GLsync &fence = fences_[partition_];
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FencedRing::Delete() {
+    for (GLsync &fence: fences_) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    glUnmapNamedBuffer(name_);
+    glDeleteBuffers(1, &name_);
+    mapped_ = nullptr;
+}
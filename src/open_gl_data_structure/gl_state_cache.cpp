@@ -0,0 +1,174 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <algorithm>
+
+GLStateCache &GLStateCache::Get() {
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::BeginFrame() {
+    last_hits_ = hits_;
+    last_misses_ = misses_;
+    hits_ = 0;
+    misses_ = 0;
+    Invalidate();
+}
+
+void GLStateCache::Invalidate() {
+    capabilities_.fill(-1);
+    program_ = kUnknown;
+    vao_ = kUnknown;
+    draw_framebuffer_ = kUnknown;
+    read_framebuffer_ = kUnknown;
+    textures_.fill(kUnknown);
+    samplers_.fill(kUnknown);
+    depth_func_ = kUnknown;
+    depth_mask_ = kUnknown;
+    cull_face_ = kUnknown;
+    front_face_ = kUnknown;
+    blend_func_.fill(kUnknown);
+    viewport_known_ = false;
+}
+
+bool GLStateCache::Cached(GLuint &current, GLuint value) {
+    if (current == value) {
+        hits_++;
+        return true;
+    }
+    current = value;
+    misses_++;
+    return false;
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+    if (!Cached(program_, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLStateCache::BindVertexArray(GLuint vao) {
+    if (!Cached(vao_, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer) {
+    if (target == GL_FRAMEBUFFER) {
+        if (draw_framebuffer_ == framebuffer && read_framebuffer_ == framebuffer) {
+            hits_++;
+            return;
+        }
+        draw_framebuffer_ = framebuffer;
+        read_framebuffer_ = framebuffer;
+        misses_++;
+        glBindFramebuffer(target, framebuffer);
+        return;
+    }
+    GLuint &current = target == GL_DRAW_FRAMEBUFFER ? draw_framebuffer_ : read_framebuffer_;
+    if (!Cached(current, framebuffer)) {
+        glBindFramebuffer(target, framebuffer);
+    }
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLuint texture) {
+    if (unit >= kTextureUnits) {
+        misses_++;
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+    if (!Cached(textures_[unit], texture)) {
+        glBindTextureUnit(unit, texture);
+    }
+}
+
+void GLStateCache::BindSampler(GLuint unit, GLuint sampler) {
+    if (unit >= kTextureUnits) {
+        misses_++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+    if (!Cached(samplers_[unit], sampler)) {
+        glBindSampler(unit, sampler);
+    }
+}
+
+static constexpr std::array<GLenum, 5> kCachedCapabilities = {GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND,
+                                                               GL_SCISSOR_TEST, GL_STENCIL_TEST};
+
+void GLStateCache::SetCapability(GLenum capability, bool enabled) {
+    static_assert(kCachedCapabilities.size() == kCachedCapabilityCount);
+    const auto it = std::ranges::find(kCachedCapabilities, capability);
+    if (it != kCachedCapabilities.end()) {
+        std::int8_t &current = capabilities_[static_cast<std::size_t>(it - kCachedCapabilities.begin())];
+        if (current == static_cast<std::int8_t>(enabled)) {
+            hits_++;
+            return;
+        }
+        current = static_cast<std::int8_t>(enabled);
+    }
+    misses_++;
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GLStateCache::Enable(GLenum capability) {
+    SetCapability(capability, true);
+}
+
+void GLStateCache::Disable(GLenum capability) {
+    SetCapability(capability, false);
+}
+
+void GLStateCache::DepthFunc(GLenum func) {
+    if (!Cached(depth_func_, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLStateCache::DepthMask(GLboolean mask) {
+    if (!Cached(depth_mask_, mask)) {
+        glDepthMask(mask);
+    }
+}
+
+void GLStateCache::CullFace(GLenum mode) {
+    if (!Cached(cull_face_, mode)) {
+        glCullFace(mode);
+    }
+}
+
+void GLStateCache::FrontFace(GLenum mode) {
+    if (!Cached(front_face_, mode)) {
+        glFrontFace(mode);
+    }
+}
+
+void GLStateCache::BlendFunc(GLenum source, GLenum destination) {
+    if (blend_func_[0] == source && blend_func_[1] == destination) {
+        hits_++;
+        return;
+    }
+    blend_func_ = {source, destination};
+    misses_++;
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    const std::array<GLint, 4> viewport = {x, y, width, height};
+    if (viewport_known_ && viewport_ == viewport) {
+        hits_++;
+        return;
+    }
+    viewport_ = viewport;
+    viewport_known_ = true;
+    misses_++;
+    glViewport(x, y, width, height);
+}
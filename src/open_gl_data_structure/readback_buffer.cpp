@@ -0,0 +1,47 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/readback_buffer.h"
+
+#include <algorithm>
+
+void ReadbackBuffer::Create(GLsizeiptr size) {
+    //every copy can be bound with glBindBufferRange
+    GLint alignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    size_ = size;
+    last_.assign(static_cast<std::size_t>(size_), std::byte{0});
+    ring_.Create(size, alignment, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+                 "readback buffer");
+    if (ring_.mapped() != nullptr) {
+        std::fill_n(ring_.mapped(), ring_.size(), std::byte{0});
+    }
+}
+
+void ReadbackBuffer::BeginFrame() {
+    //the copies start zeroed, keeping the one of the first frames changes nothing
+    const bool done = ring_.Advance();
+    if (ring_.mapped() == nullptr) {
+        return;
+    }
+    std::byte* copy = ring_.mapped() + ring_.offset();
+    if (done) {
+        std::copy_n(copy, size_, last_.begin());
+    }
+    std::fill_n(copy, size_, std::byte{0});
+}
+
+void ReadbackBuffer::Bind(GLuint binding) const {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, ring_.name(), ring_.offset(), size_);
+}
+
+void ReadbackBuffer::Fence() {
+    //the shader writes must reach the mapping before the fence signals
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    ring_.Fence();
+}
+
+void ReadbackBuffer::Delete() {
+    ring_.Delete();
+}
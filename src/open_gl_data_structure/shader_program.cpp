@@ -0,0 +1,53 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/shader_program.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+#include "file_utility.h"
+
+#include <iostream>
+
+static GLuint CompileShaderStage(GLenum type, const char *path) {
+    auto content = gpr::LoadShader(path);
+    auto *ptr = content.data();
+    GLint success;
+
+    const GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &ptr, nullptr);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        std::cerr << "Error while loading shader " << path << "\n";
+    }
+    return shader;
+}
+
+void ShaderProgram::Create(const char *vertex_path, const char *fragment_path) {
+    const GLuint vertex = CompileShaderStage(GL_VERTEX_SHADER, vertex_path);
+    const GLuint fragment = CompileShaderStage(GL_FRAGMENT_SHADER, fragment_path);
+
+    name_ = glCreateProgram();
+    glAttachShader(name_, vertex);
+    glAttachShader(name_, fragment);
+    glLinkProgram(name_);
+    GLint success;
+    glGetProgramiv(name_, GL_LINK_STATUS, &success);
+    if (!success) {
+        std::cerr << "Error while linking program " << vertex_path << " + " << fragment_path << "\n";
+    }
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+}
+
+void ShaderProgram::Use() const {
+    GLStateCache::Get().UseProgram(name_);
+}
+
+GLint ShaderProgram::UniformLocation(const char *uniform) const {
+    return glGetUniformLocation(name_, uniform);
+}
+
+void ShaderProgram::Delete() {
+    glDeleteProgram(name_);
+}
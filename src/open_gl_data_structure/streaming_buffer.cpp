@@ -0,0 +1,48 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "open_gl_data_structure/streaming_buffer.h"
+
+#include <algorithm>
+#include <iostream>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+void StreamingBuffer::Create(GLsizeiptr bytes_per_frame) {
+    //every allocation can be bound as a SSBO or a UBO
+    GLint ssbo_alignment = 1, ubo_alignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssbo_alignment);
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment);
+    alignment_ = std::max({static_cast<GLintptr>(ssbo_alignment), static_cast<GLintptr>(ubo_alignment),
+                           static_cast<GLintptr>(16)});
+    ring_.Create(bytes_per_frame, alignment_, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+                 "streaming buffer");
+}
+
+void StreamingBuffer::BeginFrame() {
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    ring_.Advance();
+    head_ = 0;
+}
+
+void StreamingBuffer::EndFrame() {
+    ring_.Fence();
+}
+
+GLintptr StreamingBuffer::Reserve(GLsizeiptr size) {
+    const GLintptr offset = (head_ + alignment_ - 1) / alignment_ * alignment_;
+    if (ring_.mapped() == nullptr || offset + size > ring_.partition_size()) {
+        std::cerr << "Error while allocating " << size << " bytes in the streaming buffer\n";
+        return -1;
+    }
+    head_ = offset + size;
+    return ring_.offset() + offset;
+}
+
+void StreamingBuffer::Delete() {
+    ring_.Delete();
+}
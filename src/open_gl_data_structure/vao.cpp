@@ -9,13 +9,38 @@ VAO::VAO(GLuint &name) {
 }
 
 void VAO::Create() {
-    glGenVertexArrays(1, &name_);
+    glCreateVertexArrays(1, &name_);
 }
 
 void VAO::Bind() const {
     glBindVertexArray(name_);
 }
 
+void VAO::SetVertexBuffer(GLuint binding, const VBO &vbo, GLintptr offset, GLsizei stride) const {
+    glVertexArrayVertexBuffer(name_, binding, vbo.name(), offset, stride);
+}
+
+void VAO::SetElementBuffer(const EBO &ebo) const {
+    glVertexArrayElementBuffer(name_, ebo.name());
+}
+
+void VAO::SetAttribute(GLuint index, GLint size, GLenum type, GLuint relative_offset, GLuint binding,
+                       GLboolean normalized) const {
+    glEnableVertexArrayAttrib(name_, index);
+    glVertexArrayAttribFormat(name_, index, size, type, normalized, relative_offset);
+    glVertexArrayAttribBinding(name_, index, binding);
+}
+
+void VAO::SetIntegerAttribute(GLuint index, GLint size, GLenum type, GLuint relative_offset, GLuint binding) const {
+    glEnableVertexArrayAttrib(name_, index);
+    glVertexArrayAttribIFormat(name_, index, size, type, relative_offset);
+    glVertexArrayAttribBinding(name_, index, binding);
+}
+
+void VAO::SetBindingDivisor(GLuint binding, GLuint divisor) const {
+    glVertexArrayBindingDivisor(name_, binding, divisor);
+}
+
 void VAO::Delete() {
     glDeleteVertexArrays(1, &name_);
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ VBO::VBO(GLuint &name) {
 }
 
 void VBO::Create() {
-    glGenBuffers(1, &name_);
+    glCreateBuffers(1, &name_);
 }
 
 
@@ -21,6 +21,22 @@ void VBO::BindData(GLsizei size, const void *data, GLenum usage) const {
     glBufferData(GL_ARRAY_BUFFER, size, data, usage);
 }
 
+void VBO::Storage(GLsizeiptr size, const void *data, GLbitfield flags) const {
+    glNamedBufferStorage(name_, size, data, flags);
+}
+
+void VBO::SubData(GLintptr offset, GLsizeiptr size, const void *data) const {
+    glNamedBufferSubData(name_, offset, size, data);
+}
+
+void *VBO::Map(GLintptr offset, GLsizeiptr length, GLbitfield access) const {
+    return glMapNamedBufferRange(name_, offset, length, access);
+}
+
+void VBO::Unmap() const {
+    glUnmapNamedBuffer(name_);
+}
+
 void VBO::Delete() {
     glDeleteBuffers(1 , &name_);
 }
\ No newline at end of file
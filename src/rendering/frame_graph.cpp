@@ -0,0 +1,269 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/frame_graph.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    //GL_NONE for the color formats
+    static GLenum DepthAttachment(GLenum internal_format) {
+        switch (internal_format) {
+            case GL_DEPTH_COMPONENT:
+            case GL_DEPTH_COMPONENT16:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32:
+            case GL_DEPTH_COMPONENT32F:
+                return GL_DEPTH_ATTACHMENT;
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH32F_STENCIL8:
+                return GL_DEPTH_STENCIL_ATTACHMENT;
+            default:
+                return GL_NONE;
+        }
+    }
+
+    static void AddUnique(std::vector<FrameResource> &resources, FrameResource resource) {
+        if (std::ranges::find(resources, resource) == resources.end()) {
+            resources.push_back(resource);
+        }
+    }
+
+    FrameResource FramePassBuilder::Read(FrameResource resource) {
+        AddUnique(graph_.passes_[pass_].reads, resource);
+        return resource;
+    }
+
+    FrameResource FramePassBuilder::Write(FrameResource resource) {
+        AddUnique(graph_.passes_[pass_].writes, resource);
+        return resource;
+    }
+
+    void FrameGraph::Reset() {
+        resources_.clear();
+        passes_.clear();
+    }
+
+    FrameResource FrameGraph::Create(std::string_view name, const RenderTargetDesc &desc) {
+        Resource resource{};
+        resource.name = name;
+        resource.desc = desc;
+        resources_.push_back(std::move(resource));
+        return static_cast<FrameResource>(resources_.size() - 1);
+    }
+
+    FrameResource FrameGraph::Import(std::string_view name, GLuint texture, const RenderTargetDesc &desc) {
+        const FrameResource imported = Create(name, desc);
+        resources_[imported].imported = true;
+        resources_[imported].texture = texture;
+        return imported;
+    }
+
+    void FrameGraph::AddPass(std::string_view name, const Setup &setup, Pass execute) {
+        PassNode pass{};
+        pass.name = name;
+        pass.execute = std::move(execute);
+        passes_.push_back(std::move(pass));
+        FramePassBuilder builder(*this, static_cast<std::uint32_t>(passes_.size() - 1));
+        setup(builder);
+    }
+
+    void FrameGraph::Compile() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        //the framebuffers of the textures deleted by the pool (old size after a resize) go with them
+        for (const GLuint deleted: pool_.BeginFrame()) {
+            std::erase_if(framebuffers_, [&](const auto &cached) {
+                if (std::ranges::find(cached.first, deleted) == cached.first.end()) {
+                    return false;
+                }
+                glDeleteFramebuffers(1, &cached.second);
+                return true;
+            });
+        }
+        Cull();
+        Allocate();
+    }
+
+    void FrameGraph::Cull() {
+        for (std::uint32_t i = 0; i < passes_.size(); i++) {
+            PassNode &pass = passes_[i];
+            //a pass writing nothing the graph knows works on its own resources, it is kept
+            pass.references = pass.writes.empty() ? 1 : static_cast<std::uint32_t>(pass.writes.size());
+            //no versions : a pass reading what it writes counts as its own reader and is kept
+            for (const FrameResource read: pass.reads) {
+                resources_[read].readers++;
+            }
+            for (const FrameResource write: pass.writes) {
+                resources_[write].writers.push_back(i);
+            }
+        }
+
+        std::vector<FrameResource> unread{};
+        for (FrameResource i = 0; i < resources_.size(); i++) {
+            //the imported resources are the outputs of the frame
+            if (resources_[i].imported) {
+                resources_[i].readers++;
+            }
+            if (resources_[i].readers == 0) {
+                unread.push_back(i);
+            }
+        }
+        culled_count_ = 0;
+        while (!unread.empty()) {
+            const FrameResource resource = unread.back();
+            unread.pop_back();
+            for (const std::uint32_t writer: resources_[resource].writers) {
+                PassNode &pass = passes_[writer];
+                if (pass.culled || --pass.references > 0) {
+                    continue;
+                }
+                pass.culled = true;
+                culled_count_++;
+                for (const FrameResource read: pass.reads) {
+                    if (--resources_[read].readers == 0) {
+                        unread.push_back(read);
+                    }
+                }
+            }
+        }
+    }
+
+    void FrameGraph::Allocate() {
+        for (Resource &resource: resources_) {
+            resource.first_use = std::numeric_limits<std::uint32_t>::max();
+            resource.last_use = 0;
+        }
+        std::vector<FrameResource> used{};
+        for (std::uint32_t i = 0; i < passes_.size(); i++) {
+            if (passes_[i].culled) {
+                continue;
+            }
+            for (const FrameResource resource: passes_[i].reads) {
+                resources_[resource].first_use = std::min(resources_[resource].first_use, i);
+                resources_[resource].last_use = std::max(resources_[resource].last_use, i);
+            }
+            for (const FrameResource resource: passes_[i].writes) {
+                resources_[resource].first_use = std::min(resources_[resource].first_use, i);
+                resources_[resource].last_use = std::max(resources_[resource].last_use, i);
+            }
+        }
+
+        transient_count_ = 0;
+        for (std::uint32_t i = 0; i < passes_.size(); i++) {
+            PassNode &pass = passes_[i];
+            if (pass.culled) {
+                continue;
+            }
+            used.clear();
+            for (const FrameResource resource: pass.reads) {
+                AddUnique(used, resource);
+            }
+            for (const FrameResource resource: pass.writes) {
+                AddUnique(used, resource);
+            }
+            for (const FrameResource resource: used) {
+                if (!resources_[resource].imported && resources_[resource].first_use == i) {
+                    resources_[resource].texture = pool_.Acquire(resources_[resource].desc);
+                    transient_count_++;
+                }
+            }
+            //given back after the acquisitions, a target never shares its texture with another one of the same pass
+            for (const FrameResource resource: used) {
+                if (!resources_[resource].imported && resources_[resource].last_use == i) {
+                    pass.invalidates.push_back(resource);
+                    pool_.Release(resources_[resource].texture);
+                }
+            }
+        }
+    }
+
+    void FrameGraph::Execute() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        GLStateCache &state = GLStateCache::Get();
+        for (PassNode &pass: passes_) {
+            if (pass.culled) {
+                continue;
+            }
+#ifdef TRACY_ENABLE
+            ZoneScopedN("Frame graph pass");
+            ZoneName(pass.name.c_str(), pass.name.size());
+#endif
+            if (!pass.writes.empty()) {
+                const RenderTargetDesc &target = resources_[pass.writes.front()].desc;
+                state.BindFramebuffer(GL_FRAMEBUFFER, CachedFramebuffer(pass.writes));
+                state.Viewport(0, 0, target.width, target.height);
+            }
+            pass.execute(*this);
+            for (const FrameResource resource: pass.invalidates) {
+                glInvalidateTexImage(resources_[resource].texture, 0);
+            }
+        }
+    }
+
+    GLuint FrameGraph::Framebuffer(std::initializer_list<FrameResource> attachments) {
+        return CachedFramebuffer(std::vector<FrameResource>(attachments));
+    }
+
+    GLuint FrameGraph::CachedFramebuffer(const std::vector<FrameResource> &attachments) {
+        std::vector<GLuint> textures{};
+        textures.reserve(attachments.size());
+        for (const FrameResource attachment: attachments) {
+            //the default framebuffer can't be combined with textures
+            if (resources_[attachment].imported && resources_[attachment].texture == 0) {
+                return 0;
+            }
+            textures.push_back(resources_[attachment].texture);
+        }
+        const auto it = framebuffers_.find(textures);
+        if (it != framebuffers_.end()) {
+            return it->second;
+        }
+
+        GLuint framebuffer = 0;
+        glCreateFramebuffers(1, &framebuffer);
+        std::vector<GLenum> draw_buffers{};
+        for (const FrameResource attachment: attachments) {
+            const Resource &resource = resources_[attachment];
+            const GLenum depth = DepthAttachment(resource.desc.internal_format);
+            if (depth != GL_NONE) {
+                glNamedFramebufferTexture(framebuffer, depth, resource.texture, 0);
+            } else {
+                const auto color = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + draw_buffers.size());
+                glNamedFramebufferTexture(framebuffer, color, resource.texture, 0);
+                draw_buffers.push_back(color);
+            }
+        }
+        if (draw_buffers.empty()) {
+            glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+            glNamedFramebufferReadBuffer(framebuffer, GL_NONE);
+        } else {
+            glNamedFramebufferDrawBuffers(framebuffer, static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+        }
+        if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Error while creating the framebuffer of " << resources_[attachments.front()].name << "\n";
+        }
+        framebuffers_.emplace(std::move(textures), framebuffer);
+        return framebuffer;
+    }
+
+    void FrameGraph::Delete() {
+        for (const auto &[textures, framebuffer]: framebuffers_) {
+            glDeleteFramebuffers(1, &framebuffer);
+        }
+        framebuffers_.clear();
+        pool_.Delete();
+    }
+
+} // namespace gpr
@@ -0,0 +1,160 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/material_system.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr std::uint32_t kMaxLayers = 0xFFFF;
+
+    //TextureManager and Model create their textures with unsized formats, the storage of the arrays needs sized ones
+    static GLenum SizedFormat(GLenum internal_format) {
+        switch (internal_format) {
+            case GL_RED:
+                return GL_R8;
+            case GL_RGB:
+                return GL_RGB8;
+            case GL_RGBA:
+                return GL_RGBA8;
+            case GL_SRGB:
+                return GL_SRGB8;
+            case GL_SRGB_ALPHA:
+                return GL_SRGB8_ALPHA8;
+            default:
+                return internal_format;
+        }
+    }
+
+    std::uint32_t MaterialSystem::AddTexture(GLuint texture) {
+        const auto it = texture_refs_.find(texture);
+        if (it != texture_refs_.end()) {
+            return it->second;
+        }
+        GLint width = 0, height = 0, internal_format = 0;
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &height);
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+        const GLenum format = SizedFormat(static_cast<GLenum>(internal_format));
+        if (width <= 0 || height <= 0) {
+            std::cerr << "Error while adding texture " << texture << " to the materials, it is empty\n";
+            return kNoTexture;
+        }
+
+        auto array = std::ranges::find_if(arrays_, [&](const TextureArray &candidate) {
+            return candidate.internal_format == format && candidate.width == width &&
+                   candidate.height == height && candidate.textures.size() < kMaxLayers;
+        });
+        if (array == arrays_.end()) {
+            if (arrays_.size() == kMaxTextureArrays) {
+                std::cerr << "Error while adding texture " << texture << " to the materials, more than "
+                          << kMaxTextureArrays << " formats and sizes\n";
+                return kNoTexture;
+            }
+            TextureArray created{};
+            created.internal_format = format;
+            created.width = width;
+            created.height = height;
+            //full chain, the textures of TextureManager and Model all have their mipmaps
+            created.levels = static_cast<GLsizei>(std::bit_width(static_cast<std::uint32_t>(std::max(width, height))));
+            arrays_.push_back(created);
+            array = std::prev(arrays_.end());
+        }
+        const auto array_index = static_cast<std::uint32_t>(array - arrays_.begin());
+        const std::uint32_t ref = array_index << 16 | static_cast<std::uint32_t>(array->textures.size());
+        array->textures.push_back(texture);
+        texture_refs_.emplace(texture, ref);
+        return ref;
+    }
+
+    std::uint16_t MaterialSystem::AddMaterial(const std::vector<Texture> &textures) {
+        GpuMaterial material{};
+        for (const Texture &texture: textures) {
+            if (texture.type == "texture_diffuse" && material.diffuse == kNoTexture) {
+                material.diffuse = AddTexture(texture.id);
+            } else if (texture.type == "texture_normal" && material.normal == kNoTexture) {
+                material.normal = AddTexture(texture.id);
+            } else if (texture.type == "texture_specular" && material.specular == kNoTexture) {
+                material.specular = AddTexture(texture.id);
+            }
+        }
+        const std::array<std::uint32_t, 3> key = {material.diffuse, material.normal, material.specular};
+        const auto it = material_ids_.find(key);
+        if (it != material_ids_.end()) {
+            return it->second;
+        }
+        const std::uint16_t id = AddMaterial(material);
+        material_ids_.emplace(key, id);
+        return id;
+    }
+
+    std::uint16_t MaterialSystem::AddMaterial(const GpuMaterial &material) {
+        if (materials_.size() > 0xFFFF) {
+            std::cerr << "Error while adding a material, the table is full\n";
+            return 0;
+        }
+        materials_.push_back(material);
+        return static_cast<std::uint16_t>(materials_.size() - 1);
+    }
+
+    void MaterialSystem::AddModel(Model &model) {
+        for (std::size_t lod = 0; lod < model.lod_count(); lod++) {
+            for (Mesh &mesh: lod == 0 ? model.meshes_ : model.lods_[lod - 1]) {
+                mesh.material_ = AddMaterial(mesh.textures_);
+            }
+        }
+    }
+
+    void MaterialSystem::Build() {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        for (TextureArray &array: arrays_) {
+            glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array.name);
+            glTextureStorage3D(array.name, array.levels, array.internal_format, array.width, array.height,
+                               static_cast<GLsizei>(array.textures.size()));
+            glTextureParameteri(array.name, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTextureParameteri(array.name, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTextureParameteri(array.name, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTextureParameteri(array.name, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            //GPU to GPU copies, the images are not loaded again
+            for (std::size_t layer = 0; layer < array.textures.size(); layer++) {
+                for (GLint level = 0; level < array.levels; level++) {
+                    glCopyImageSubData(array.textures[layer], GL_TEXTURE_2D, level, 0, 0, 0,
+                                       array.name, GL_TEXTURE_2D_ARRAY, level, 0, 0, static_cast<GLint>(layer),
+                                       std::max(array.width >> level, 1), std::max(array.height >> level, 1), 1);
+                }
+            }
+        }
+
+        glCreateBuffers(1, &materials_buffer_);
+        glNamedBufferStorage(materials_buffer_, static_cast<GLsizeiptr>(materials_.size() * sizeof(GpuMaterial)),
+                             materials_.data(), 0);
+    }
+
+    void MaterialSystem::Bind() const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialsBinding, materials_buffer_);
+        GLStateCache &state = GLStateCache::Get();
+        for (std::size_t i = 0; i < arrays_.size(); i++) {
+            state.BindTexture(kFirstArrayUnit + static_cast<GLuint>(i), arrays_[i].name);
+        }
+    }
+
+    void MaterialSystem::Delete() {
+        for (TextureArray &array: arrays_) {
+            glDeleteTextures(1, &array.name);
+            array.name = 0;
+        }
+        glDeleteBuffers(1, &materials_buffer_);
+        materials_buffer_ = 0;
+    }
+
+} // namespace gpr
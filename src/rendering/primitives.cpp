@@ -0,0 +1,113 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/primitives.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <cstddef>
+
+namespace gpr {
+
+    //face of the cube, tangent x bitangent = normal so the corners below are CCW seen from outside
+    struct CubeFace {
+        std::array<float, 3> normal{};
+        std::array<float, 3> tangent{};
+        std::array<float, 3> bitangent{};
+    };
+
+    static constexpr std::array<CubeFace, 6> kCubeFaces = {{
+            {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+            {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+            {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+            {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+            {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+            {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+    }};
+
+    //two triangles in (tangent, bitangent)
+    static constexpr std::array<std::array<float, 2>, 6> kFaceCorners = {{
+            {-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f},
+            {-1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f},
+    }};
+
+    static constexpr std::size_t kCubeVertexCount = kCubeFaces.size() * kFaceCorners.size();
+
+    static constexpr PrimitiveVertex FaceVertex(const CubeFace &face, const std::array<float, 2> &corner, float offset) {
+        PrimitiveVertex vertex{};
+        for (std::size_t i = 0; i < 3; i++) {
+            vertex.position[i] = face.normal[i] * offset + face.tangent[i] * corner[0] + face.bitangent[i] * corner[1];
+        }
+        vertex.normal = face.normal;
+        vertex.uv = {(corner[0] + 1.0f) * 0.5f, (corner[1] + 1.0f) * 0.5f};
+        vertex.tangent = face.tangent;
+        vertex.bitangent = face.bitangent;
+        return vertex;
+    }
+
+    //cube, quad then skybox
+    static constexpr auto MakePrimitiveVertices() {
+        std::array<PrimitiveVertex, kCubeVertexCount * 2 + kFaceCorners.size()> vertices{};
+        std::size_t next = 0;
+        for (const CubeFace &face: kCubeFaces) {
+            for (const auto &corner: kFaceCorners) {
+                vertices[next++] = FaceVertex(face, corner, 1.0f);
+            }
+        }
+        //the +Z face without the offset
+        for (const auto &corner: kFaceCorners) {
+            vertices[next++] = FaceVertex(kCubeFaces[4], corner, 0.0f);
+        }
+        //the cube with every triangle reversed
+        for (std::size_t i = 0; i < kCubeVertexCount; i += 3) {
+            vertices[next++] = vertices[i];
+            vertices[next++] = vertices[i + 2];
+            vertices[next++] = vertices[i + 1];
+        }
+        return vertices;
+    }
+
+    static constexpr auto kPrimitiveVertices = MakePrimitiveVertices();
+
+    void PrimitiveRegistry::Create() {
+        vao_.Create();
+        vbo_.Create();
+        empty_vao_.Create();
+        vbo_.Storage(sizeof(kPrimitiveVertices), kPrimitiveVertices.data());
+        vao_.SetVertexBuffer(0, vbo_, 0, sizeof(PrimitiveVertex));
+        vao_.SetAttribute(0, 3, GL_FLOAT, offsetof(PrimitiveVertex, position));
+        vao_.SetAttribute(1, 3, GL_FLOAT, offsetof(PrimitiveVertex, normal));
+        vao_.SetAttribute(2, 2, GL_FLOAT, offsetof(PrimitiveVertex, uv));
+        vao_.SetAttribute(3, 3, GL_FLOAT, offsetof(PrimitiveVertex, tangent));
+        vao_.SetAttribute(4, 3, GL_FLOAT, offsetof(PrimitiveVertex, bitangent));
+
+        constexpr auto cube_count = static_cast<GLsizei>(kCubeVertexCount);
+        constexpr auto quad_count = static_cast<GLsizei>(kFaceCorners.size());
+        ranges_[static_cast<std::size_t>(Primitive::kCube)] = {0, cube_count};
+        ranges_[static_cast<std::size_t>(Primitive::kQuad)] = {cube_count, quad_count};
+        ranges_[static_cast<std::size_t>(Primitive::kSkybox)] = {cube_count + quad_count, cube_count};
+        ranges_[static_cast<std::size_t>(Primitive::kFullScreenTriangle)] = {0, 3};
+    }
+
+    void PrimitiveRegistry::Draw(Primitive primitive, GLsizei instance_count) const {
+        const PrimitiveRange primitive_range = range(primitive);
+        GLStateCache::Get().BindVertexArray(vao(primitive));
+        glDrawArraysInstanced(GL_TRIANGLES, primitive_range.first, primitive_range.count, instance_count);
+    }
+
+    DrawPacket PrimitiveRegistry::Packet(Primitive primitive) const {
+        const PrimitiveRange primitive_range = range(primitive);
+        DrawPacket packet{};
+        packet.vao = vao(primitive);
+        packet.first = primitive_range.first;
+        packet.count = primitive_range.count;
+        return packet;
+    }
+
+    void PrimitiveRegistry::Delete() {
+        vao_.Delete();
+        vbo_.Delete();
+        empty_vao_.Delete();
+    }
+
+} // namespace gpr
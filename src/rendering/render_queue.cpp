@@ -0,0 +1,215 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/render_queue.h"
+#include "open_gl_data_structure/gl_state_cache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace gpr {
+
+    static constexpr std::uint32_t kSortDepthBits = 24;
+    static constexpr std::uint32_t kSortDepthMax = (1u << kSortDepthBits) - 1;
+
+    std::uint64_t MakeSortKey(RenderPass pass, GLuint program, std::uint16_t material, float view_depth) {
+        const float depth01 = std::clamp(view_depth / kMaxSortDepth, 0.0f, 1.0f);
+        const auto depth = static_cast<std::uint64_t>(std::lround(depth01 * static_cast<float>(kSortDepthMax)));
+        const std::uint64_t pass_bits = static_cast<std::uint64_t>(pass) & 0xF;
+        const std::uint64_t program_bits = program & 0xFFF;
+        const std::uint64_t material_bits = material;
+        if (pass == RenderPass::kSky || pass == RenderPass::kTransparent) {
+            //far first
+            return pass_bits << 60 | (kSortDepthMax - depth) << 36 | program_bits << 24 | material_bits << 8;
+        }
+        return pass_bits << 60 | program_bits << 48 | material_bits << 32 | depth << 8;
+    }
+
+    void RadixSort(std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch) {
+        if (entries.size() < 2) {
+            return;
+        }
+        scratch.resize(entries.size());
+        for (std::uint32_t shift = 0; shift < 64; shift += 8) {
+            std::array<std::size_t, 256> offsets{};
+            for (const SortEntry &entry: entries) {
+                offsets[(entry.key >> shift) & 0xFF]++;
+            }
+            //every key has the same digit, nothing moves
+            if (offsets[(entries.front().key >> shift) & 0xFF] == entries.size()) {
+                continue;
+            }
+            std::size_t sum = 0;
+            for (std::size_t &offset: offsets) {
+                const std::size_t count = offset;
+                offset = sum;
+                sum += count;
+            }
+            for (const SortEntry &entry: entries) {
+                scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            }
+            entries.swap(scratch);
+        }
+    }
+
+    bool CanMergeDraws(const DrawPacket &first, const DrawPacket &second) {
+        return first.pass == second.pass && first.program == second.program && first.textures == second.textures &&
+               first.vao == second.vao && first.mode == second.mode && first.first == second.first &&
+               first.count == second.count && first.indexed == second.indexed &&
+               first.instance_count == 1 && second.instance_count == 1 && first.base_instance == second.base_instance &&
+               first.cull_back_faces == second.cull_back_faces && first.front_face == second.front_face &&
+               first.depth_func == second.depth_func;
+    }
+
+    void RenderQueue::Clear() {
+        packets_.clear();
+        entries_.clear();
+        batches_.clear();
+        instance_size_ = 0;
+        program_switches_ = 0;
+        material_switches_ = 0;
+        draw_calls_ = 0;
+    }
+
+    void RenderQueue::Submit(const DrawPacket &packet, float view_depth) {
+        entries_.push_back({MakeSortKey(packet.pass, packet.program, packet.material, view_depth),
+                            static_cast<std::uint32_t>(packets_.size())});
+        packets_.push_back(packet);
+    }
+
+    void RenderQueue::Sort(StreamingBuffer &instance_stream) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        RadixSort(entries_, scratch_);
+
+        std::size_t instance_count = 0;
+        for (const SortEntry &entry: entries_) {
+            const DrawPacket &packet = packets_[entry.packet];
+            if (packet.instance_count == 1 && Program(packet.program).instanced) {
+                instance_count++;
+            }
+        }
+        StreamAllocation<DrawInstance> instances{};
+        if (instance_count > 0) {
+            instances = instance_stream.Allocate<DrawInstance>(instance_count);
+        }
+        instance_buffer_ = instance_stream.name();
+        instance_offset_ = instances.offset;
+        instance_size_ = instances.size;
+
+        //the sort put the identical draws next to each other, each run becomes one batch
+        batches_.clear();
+        std::uint32_t written = 0;
+        for (std::uint32_t i = 0; i < entries_.size();) {
+            const DrawPacket &packet = packets_[entries_[i].packet];
+            Batch batch{entries_[i].key, i};
+            if (!instances.empty() && packet.instance_count == 1 && Program(packet.program).instanced) {
+                batch.instanced = true;
+                batch.first_instance = written;
+                instances.data[written++] = {packet.model, packet.instance_data, glm::uvec4(packet.material, 0, 0, 0)};
+                while (i + batch.instance_count < entries_.size()) {
+                    const DrawPacket &next = packets_[entries_[i + batch.instance_count].packet];
+                    if (!CanMergeDraws(packet, next)) {
+                        break;
+                    }
+                    instances.data[written++] = {next.model, next.instance_data, glm::uvec4(next.material, 0, 0, 0)};
+                    batch.instance_count++;
+                }
+            }
+            batches_.push_back(batch);
+            i += batch.instance_count;
+        }
+    }
+
+    const RenderQueue::ProgramInfo &RenderQueue::Program(GLuint program) {
+        const auto it = programs_.find(program);
+        if (it != programs_.end()) {
+            return it->second;
+        }
+        ProgramInfo info{};
+        info.model_location = glGetUniformLocation(program, "model");
+        info.instance_offset_location = glGetUniformLocation(program, "instanceOffset");
+        info.instanced = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, "DrawInstances") !=
+                         GL_INVALID_INDEX;
+        return programs_.emplace(program, info).first->second;
+    }
+
+    void RenderQueue::Execute(RenderPass pass) {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        const std::uint64_t pass_key = static_cast<std::uint64_t>(pass) << 60;
+        const auto begin = std::ranges::lower_bound(batches_, pass_key, {}, &Batch::key);
+        const auto end = std::ranges::lower_bound(batches_, pass_key + (std::uint64_t{1} << 60), {}, &Batch::key);
+        if (begin == end) {
+            return;
+        }
+        if (instance_size_ > 0) {
+            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, kDrawInstancesBinding, instance_buffer_, instance_offset_,
+                              instance_size_);
+        }
+
+        GLStateCache &state = GLStateCache::Get();
+        GLuint program = 0;
+        std::uint16_t material = 0;
+        bool first = true;
+        for (auto it = begin; it != end; ++it) {
+            const DrawPacket &packet = packets_[entries_[it->first_entry].packet];
+            if (first || packet.program != program) {
+                program_switches_++;
+                program = packet.program;
+            }
+            if (first || packet.material != material) {
+                material_switches_++;
+                material = packet.material;
+            }
+            first = false;
+
+            state.UseProgram(packet.program);
+            for (GLuint unit = 0; unit < kPacketTextureCount; unit++) {
+                if (packet.textures[unit] != 0) {
+                    state.BindTexture(unit, packet.textures[unit]);
+                }
+            }
+            if (packet.cull_back_faces) {
+                state.Enable(GL_CULL_FACE);
+                state.CullFace(GL_BACK);
+                state.FrontFace(packet.front_face);
+            } else {
+                state.Disable(GL_CULL_FACE);
+            }
+            state.DepthFunc(packet.depth_func);
+            const ProgramInfo &info = Program(packet.program);
+            GLsizei instance_count = packet.instance_count;
+            if (it->instanced) {
+                instance_count = static_cast<GLsizei>(it->instance_count);
+                if (info.instance_offset_location >= 0) {
+                    glProgramUniform1ui(packet.program, info.instance_offset_location, it->first_instance);
+                }
+            } else if (info.model_location >= 0) {
+                glProgramUniformMatrix4fv(packet.program, info.model_location, 1, GL_FALSE,
+                                          glm::value_ptr(packet.model));
+            }
+            state.BindVertexArray(packet.vao);
+
+            if (packet.indexed) {
+                const auto offset = static_cast<std::size_t>(packet.first) * sizeof(GLuint);
+                glDrawElementsInstancedBaseInstance(packet.mode, packet.count, GL_UNSIGNED_INT,
+                                                    reinterpret_cast<const void *>(offset), instance_count,
+                                                    packet.base_instance);
+            } else {
+                glDrawArraysInstancedBaseInstance(packet.mode, packet.first, packet.count, instance_count,
+                                                  packet.base_instance);
+            }
+            draw_calls_++;
+        }
+    }
+
+} // namespace gpr
@@ -0,0 +1,108 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/render_target_pool.h"
+
+#include <algorithm>
+#include <array>
+
+namespace gpr {
+
+    //formats used by the scenes, the others count 4 bytes
+    static std::size_t BytesPerTexel(GLenum internal_format) {
+        switch (internal_format) {
+            case GL_R8:
+                return 1;
+            case GL_R16F:
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGB16F:
+                return 6;
+            case GL_RGBA16F:
+                return 8;
+            case GL_RGBA32F:
+                return 16;
+            case GL_DEPTH32F_STENCIL8:
+                return 5;
+            default:
+                return 4;
+        }
+    }
+
+    const std::vector<GLuint> &RenderTargetPool::BeginFrame() {
+        frame_++;
+        used_count_ = 0;
+        deleted_.clear();
+        std::erase_if(textures_, [&](PooledTexture &pooled) {
+            pooled.in_use = false;
+            if (frame_ - pooled.last_used_frame <= kMaxIdleFrames) {
+                return false;
+            }
+            glDeleteTextures(1, &pooled.name);
+            deleted_.push_back(pooled.name);
+            return true;
+        });
+        return deleted_;
+    }
+
+    GLuint RenderTargetPool::Acquire(const RenderTargetDesc &desc) {
+        const auto free = std::ranges::find_if(textures_, [&](const PooledTexture &pooled) {
+            return !pooled.in_use && pooled.desc == desc;
+        });
+        if (free != textures_.end()) {
+            used_count_ += free->last_used_frame == frame_ ? 0 : 1;
+            free->in_use = true;
+            free->last_used_frame = frame_;
+            return free->name;
+        }
+
+        PooledTexture created{};
+        created.desc = desc;
+        created.in_use = true;
+        created.last_used_frame = frame_;
+        if (desc.samples > 1) {
+            glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &created.name);
+            glTextureStorage2DMultisample(created.name, desc.samples, desc.internal_format, desc.width, desc.height,
+                                          GL_TRUE);
+        } else {
+            glCreateTextures(GL_TEXTURE_2D, 1, &created.name);
+            glTextureStorage2D(created.name, 1, desc.internal_format, desc.width, desc.height);
+            glTextureParameteri(created.name, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(desc.filter));
+            glTextureParameteri(created.name, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(desc.filter));
+            glTextureParameteri(created.name, GL_TEXTURE_WRAP_S, static_cast<GLint>(desc.wrap));
+            glTextureParameteri(created.name, GL_TEXTURE_WRAP_T, static_cast<GLint>(desc.wrap));
+            if (desc.wrap == GL_CLAMP_TO_BORDER) {
+                constexpr std::array<float, 4> border = {1.0f, 1.0f, 1.0f, 1.0f};
+                glTextureParameterfv(created.name, GL_TEXTURE_BORDER_COLOR, border.data());
+            }
+        }
+        used_count_++;
+        textures_.push_back(created);
+        return created.name;
+    }
+
+    void RenderTargetPool::Release(GLuint texture) {
+        const auto pooled = std::ranges::find(textures_, texture, &PooledTexture::name);
+        if (pooled != textures_.end()) {
+            pooled->in_use = false;
+        }
+    }
+
+    std::size_t RenderTargetPool::memory_bytes() const {
+        std::size_t bytes = 0;
+        for (const PooledTexture &pooled: textures_) {
+            bytes += static_cast<std::size_t>(pooled.desc.width) * static_cast<std::size_t>(pooled.desc.height) *
+                     static_cast<std::size_t>(pooled.desc.samples) * BytesPerTexel(pooled.desc.internal_format);
+        }
+        return bytes;
+    }
+
+    void RenderTargetPool::Delete() {
+        for (const PooledTexture &pooled: textures_) {
+            glDeleteTextures(1, &pooled.name);
+        }
+        textures_.clear();
+    }
+
+} // namespace gpr
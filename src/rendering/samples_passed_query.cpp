@@ -0,0 +1,40 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/samples_passed_query.h"
+
+namespace gpr {
+
+    void SamplesPassedQuery::Create() {
+        glCreateQueries(GL_SAMPLES_PASSED, static_cast<GLsizei>(queries_.size()), queries_.data());
+        issued_.fill(false);
+        next_ = 0;
+    }
+
+    void SamplesPassedQuery::Begin() {
+        const GLuint query = queries_[next_];
+        if (issued_[next_]) {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_TRUE) {
+                GLuint64 samples = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+                samples_ = samples;
+            }
+        }
+        glBeginQuery(GL_SAMPLES_PASSED, query);
+        issued_[next_] = true;
+    }
+
+    void SamplesPassedQuery::End() {
+        glEndQuery(GL_SAMPLES_PASSED);
+        next_ = (next_ + 1) % queries_.size();
+    }
+
+    void SamplesPassedQuery::Delete() {
+        glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+        queries_.fill(0);
+    }
+
+} // namespace gpr
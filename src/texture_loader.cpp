@@ -5,8 +5,17 @@
 
 #include "stb_image.h"
 #include "load3D/texture_loader.h"
+#include "load3D/mesh_simplifier.h"
 #include <iostream>
 #include <array>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
 
 
 unsigned int TextureManager::LoadTexture(char const * path, bool gammaCorrection)
@@ -140,32 +149,141 @@ void Model::loadModel(const std::string &path) {
     }
     // retrieve the directory path of the filepath
     directory_ = path.substr(0, path.find_last_of('/'));
+    path_ = path;
 
     // process ASSIMP's root node recursively
-    ProcessNode(scene->mRootNode, scene);
+    ProcessNode(scene->mRootNode, scene, meshes_);
+
+    // bounds of the whole model
+    bounds_ = AABB{};
+    for (const auto &mesh: meshes_) {
+        bounds_.Expand(mesh.bounds_);
+    }
+    float radius = 0.0f;
+    for (const auto &mesh: meshes_) {
+        for (const auto &vertex: mesh.vertices_) {
+            radius = std::max(radius, glm::length(vertex.Position - bounds_.center()));
+        }
+    }
+    bounding_sphere_ = Sphere(bounds_.center(), radius);
 }
 
-void Model::ProcessNode(aiNode *node, const aiScene *scene) {
+void Model::ProcessNode(aiNode *node, const aiScene *scene, std::vector<Mesh> &meshes) {
     // process each mesh located at the current node
     for(unsigned int i = 0; i < node->mNumMeshes; i++)
     {
         // the node object only contains indices to index the actual objects in the scene.
         // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes_.push_back(ProcessMesh(mesh, scene));
+        meshes.push_back(ProcessMesh(mesh, scene));
     }
     // after we've processed all the meshes (if any) we then recursively process each of the children nodes
     for(unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        ProcessNode(node->mChildren[i], scene);
+        ProcessNode(node->mChildren[i], scene, meshes);
     }
 }
 
+bool Model::LoadTier(const std::string &path, std::vector<Mesh> &meshes) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+    aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    {
+        std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << "\n";
+        return false;
+    }
+    ProcessNode(scene->mRootNode, scene, meshes);
+    return true;
+}
+
+// "name_tier_2.gltf" -> "name_tier_3.gltf" for level 1, empty when the file is not a Megascans tier
+static std::string AuthoredTierPath(const std::string &path, std::size_t level) {
+    static constexpr std::string_view kTier = "_tier_";
+    const auto position = path.rfind(kTier);
+    const auto digit = position + kTier.size();
+    if (position == std::string::npos || digit >= path.size() || !std::isdigit(static_cast<unsigned char>(path[digit]))) {
+        return {};
+    }
+    std::string result = path;
+    result.replace(digit, 1, std::to_string(path[digit] - '0' + level));
+    return result;
+}
+
+static Mesh CreateLodMesh(std::span<const Vertex> vertices, std::vector<unsigned int> indices,
+                          const std::vector<Texture> &textures) {
+    std::vector<Vertex> lod_vertices = gpr::CompactVertices(vertices, indices);
+    AABB bounds;
+    for (const auto &vertex: lod_vertices) {
+        bounds.Expand(vertex.Position);
+    }
+    float radius = 0.0f;
+    for (const auto &vertex: lod_vertices) {
+        radius = std::max(radius, glm::length(vertex.Position - bounds.center()));
+    }
+    Mesh result(std::move(lod_vertices), std::move(indices), textures);
+    result.bounds_ = bounds;
+    result.bounding_sphere_ = Sphere(bounds.center(), radius);
+    return result;
+}
+
+void Model::CreateLods(std::size_t level_count) {
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    lods_.clear();
+    level_count = std::min(level_count, gpr::kMaxLodCount - 1);
+
+    // meshes sharing the same textures are merged, then each level simplifies the previous one
+    struct MergedGroup {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<Texture> textures;
+        std::size_t full_index_count = 0;
+    };
+    std::map<std::vector<unsigned int>, MergedGroup> groups;
+    for (const auto &mesh: meshes_) {
+        std::vector<unsigned int> texture_ids;
+        for (const auto &texture: mesh.textures_) {
+            texture_ids.push_back(texture.id);
+        }
+        MergedGroup &group = groups[texture_ids];
+        group.textures = mesh.textures_;
+        const auto base = static_cast<unsigned int>(group.vertices.size());
+        group.vertices.insert(group.vertices.end(), mesh.vertices_.begin(), mesh.vertices_.end());
+        for (const unsigned int index: mesh.indices_) {
+            group.indices.push_back(base + index);
+        }
+        group.full_index_count = group.indices.size();
+    }
+
+    for (std::size_t level = 1; level <= level_count; level++) {
+        std::vector<Mesh> &meshes = lods_.emplace_back();
+        const std::string authored = AuthoredTierPath(path_, level);
+        if (!authored.empty() && LoadTier(authored, meshes)) {
+            continue;
+        }
+        const float reduction = std::pow(gpr::kLodReduction, static_cast<float>(level));
+        for (auto &[texture_ids, group]: groups) {
+            const auto target = static_cast<std::size_t>(static_cast<float>(group.full_index_count) * reduction);
+            group.indices = gpr::SimplifyMesh(group.vertices, group.indices, target);
+            if (!group.indices.empty()) {
+                meshes.push_back(CreateLodMesh(group.vertices, group.indices, group.textures));
+            }
+        }
+    }
+    lod_screen_sizes_.assign(gpr::kDefaultLodScreenSizes.begin(), gpr::kDefaultLodScreenSizes.begin() + lods_.size());
+}
+
 Mesh Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
     // data to fill
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
+    AABB bounds;
 
     // walk through each of the mesh's vertices
     for(unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -177,6 +295,7 @@ Mesh Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
         vector.y = mesh->mVertices[i].y;
         vector.z = mesh->mVertices[i].z;
         vertex.Position = vector;
+        bounds.Expand(vector);
         // normals
         if (mesh->HasNormals())
         {
@@ -240,8 +359,17 @@ Mesh Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
     std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
     textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
+    // sphere around the center of the box, tighter than the sphere containing the box
+    float radius = 0.0f;
+    for (const auto &vertex: vertices) {
+        radius = std::max(radius, glm::length(vertex.Position - bounds.center()));
+    }
+
     // return a mesh object created from the extracted mesh data
-    return {vertices, indices, textures};
+    Mesh result(vertices, indices, textures);
+    result.bounds_ = bounds;
+    result.bounding_sphere_ = Sphere(bounds.center(), radius);
+    return result;
 }
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, const std::string &typeName) {
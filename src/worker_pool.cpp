@@ -0,0 +1,100 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "worker_pool.h"
+
+#include <algorithm>
+
+namespace gpr {
+
+    WorkerPool::WorkerPool(std::size_t thread_count) {
+        threads_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; i++) {
+            threads_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::scoped_lock lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &thread: threads_) {
+            thread.join();
+        }
+    }
+
+    WorkerPool &WorkerPool::Instance() {
+        static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    void WorkerPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task) {
+        if (count == 0) {
+            return;
+        }
+        if (count == 1 || threads_.empty()) {
+            for (std::size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::scoped_lock submit_lock(submit_mutex_);
+        {
+            std::scoped_lock lock(mutex_);
+            task_ = &task;
+            count_ = count;
+            next_ = 0;
+            done_ = 0;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        RunTasks(task, count);
+
+        //wait for the last tasks and for every worker to leave the job before it goes out of scope
+        std::unique_lock lock(mutex_);
+        finished_.wait(lock, [this, count] { return done_ == count && active_workers_ == 0; });
+        task_ = nullptr;
+    }
+
+    void WorkerPool::WorkerLoop() {
+        std::size_t seen_generation = 0;
+        while (true) {
+            const std::function<void(std::size_t)> *task;
+            std::size_t count;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this, seen_generation] {
+                    return stop_ || (task_ != nullptr && generation_ != seen_generation);
+                });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                task = task_;
+                count = count_;
+                active_workers_++;
+            }
+
+            RunTasks(*task, count);
+
+            {
+                std::scoped_lock lock(mutex_);
+                active_workers_--;
+            }
+            finished_.notify_one();
+        }
+    }
+
+    void WorkerPool::RunTasks(const std::function<void(std::size_t)> &task, std::size_t count) {
+        for (std::size_t i = next_.fetch_add(1); i < count; i = next_.fetch_add(1)) {
+            task(i);
+            done_.fetch_add(1);
+        }
+    }
+
+} // namespace gpr
@@ -0,0 +1,160 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "rendering/frame_graph.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//no context in the test : the pool only needs names for the textures it creates
+namespace {
+    GLuint next_texture = 1;
+    //pass being executed, and the textures invalidated with the pass that did it
+    std::string current_pass{};
+    std::vector<std::pair<GLuint, std::string>> invalidated{};
+
+    void GLAPIENTRY CreateTextures(GLenum, GLsizei count, GLuint *textures) {
+        for (GLsizei i = 0; i < count; i++) {
+            textures[i] = next_texture++;
+        }
+    }
+
+    void GLAPIENTRY TextureStorage2D(GLuint, GLsizei, GLenum, GLsizei, GLsizei) {}
+
+    void GLAPIENTRY TextureParameteri(GLuint, GLenum, GLint) {}
+
+    void GLAPIENTRY TextureParameterfv(GLuint, GLenum, const GLfloat *) {}
+
+    void GLAPIENTRY InvalidateTexImage(GLuint texture, GLint) {
+        invalidated.emplace_back(texture, current_pass);
+    }
+
+    constexpr gpr::RenderTargetDesc kColor{64, 64, GL_RGBA16F};
+    constexpr gpr::RenderTargetDesc kDepth{64, 64, GL_DEPTH_COMPONENT32F, GL_NEAREST};
+
+    const gpr::FrameGraph::Pass kNothing = [](gpr::FrameGraph &) {};
+
+    int failures = 0;
+
+    void Expect(bool condition, const char *what) {
+        if (!condition) {
+            std::cerr << "Error while testing the frame graph : " << what << "\n";
+            failures++;
+        }
+    }
+
+    //a pass whose writes nobody reads is culled, with the passes feeding only it
+    void TestUnreadWriterIsCulled() {
+        gpr::FrameGraph graph{};
+        const gpr::FrameResource backbuffer = graph.Import("Backbuffer", 0, kColor);
+        const gpr::FrameResource unused = graph.Create("Unused", kColor);
+        const gpr::FrameResource feeding = graph.Create("Feeding", kColor);
+        graph.AddPass("Feeding", [&](gpr::FramePassBuilder &builder) {
+            builder.Write(feeding);
+        }, kNothing);
+        graph.AddPass("Unused", [&](gpr::FramePassBuilder &builder) {
+            builder.Read(feeding);
+            builder.Write(unused);
+        }, kNothing);
+        graph.AddPass("Screen", [&](gpr::FramePassBuilder &builder) {
+            builder.Write(backbuffer);
+        }, kNothing);
+        graph.Compile();
+        Expect(graph.culled_count() == 2, "an unread writer and the pass feeding it are not culled");
+        Expect(graph.texture(unused) == 0 && graph.texture(feeding) == 0, "a culled target still gets a texture");
+    }
+
+    //a pass drawing over a target keeps the pass that wrote it before only if it reads it (depth pre-pass)
+    void TestReadKeepsWriter(bool read) {
+        gpr::FrameGraph graph{};
+        const gpr::FrameResource backbuffer = graph.Import("Backbuffer", 0, kColor);
+        const gpr::FrameResource depth = graph.Create("Depth", kDepth);
+        graph.AddPass("Depth prepass", [&](gpr::FramePassBuilder &builder) {
+            builder.Write(depth);
+        }, kNothing);
+        graph.AddPass("Scene", [&](gpr::FramePassBuilder &builder) {
+            if (read) {
+                builder.Read(depth);
+            }
+            builder.Write(backbuffer);
+            builder.Write(depth);
+        }, kNothing);
+        graph.Compile();
+        if (read) {
+            Expect(graph.culled_count() == 0, "a read does not keep the pass writing the target alive");
+        } else {
+            Expect(graph.culled_count() == 1, "a target written over without a read keeps its first writer alive");
+        }
+    }
+
+    //targets with the same description and lifetimes that don't overlap share one texture of the pool
+    void TestDisjointLifetimesAlias() {
+        gpr::FrameGraph graph{};
+        const gpr::FrameResource backbuffer = graph.Import("Backbuffer", 0, kColor);
+        const gpr::FrameResource first = graph.Create("First", kColor);
+        const gpr::FrameResource second = graph.Create("Second", kColor);
+        const gpr::FrameResource third = graph.Create("Third", kColor);
+        graph.AddPass("A", [&](gpr::FramePassBuilder &builder) {
+            builder.Write(first);
+        }, kNothing);
+        graph.AddPass("B", [&](gpr::FramePassBuilder &builder) {
+            builder.Read(first);
+            builder.Write(second);
+        }, kNothing);
+        graph.AddPass("C", [&](gpr::FramePassBuilder &builder) {
+            builder.Read(second);
+            builder.Write(third);
+        }, kNothing);
+        graph.AddPass("Screen", [&](gpr::FramePassBuilder &builder) {
+            builder.Read(third);
+            builder.Write(backbuffer);
+        }, kNothing);
+        graph.Compile();
+        Expect(graph.texture(first) != 0 && graph.texture(first) == graph.texture(third),
+               "disjoint lifetimes do not share a texture");
+        Expect(graph.texture(second) != graph.texture(first), "overlapping lifetimes share a texture");
+        Expect(graph.pool().texture_count() == 2, "the pool does not hold exactly two textures");
+    }
+
+    //the content of a target is invalidated once, after the last pass using it
+    void TestInvalidateAfterLastUse() {
+        invalidated.clear();
+        gpr::FrameGraph graph{};
+        const gpr::FrameResource target = graph.Create("Target", kColor);
+        //only reads : the passes are kept (they write nothing the graph knows) and bind no framebuffer
+        for (const char *name: {"First", "Last"}) {
+            graph.AddPass(name, [&](gpr::FramePassBuilder &builder) {
+                builder.Read(target);
+            }, [name](gpr::FrameGraph &) {
+                current_pass = name;
+            });
+        }
+        graph.AddPass("After", [](gpr::FramePassBuilder &) {}, [](gpr::FrameGraph &) {
+            current_pass = "After";
+        });
+        graph.Compile();
+        graph.Execute();
+        Expect(invalidated.size() == 1, "a target is not invalidated exactly once");
+        Expect(!invalidated.empty() && invalidated.front().first == graph.texture(target) &&
+               invalidated.front().second == "Last", "a target is not invalidated after its last use");
+    }
+}
+
+int main() {
+    glCreateTextures = CreateTextures;
+    glTextureStorage2D = TextureStorage2D;
+    glTextureParameteri = TextureParameteri;
+    glTextureParameterfv = TextureParameterfv;
+    glInvalidateTexImage = InvalidateTexImage;
+
+    TestUnreadWriterIsCulled();
+    TestReadKeepsWriter(true);
+    TestReadKeepsWriter(false);
+    TestDisjointLifetimesAlias();
+    TestInvalidateAfterLastUse();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+﻿//
+// Created by Mat on 10/19/2026.
+//
+
+#include "culling/spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr float kCellSize = 8.0f;
+    constexpr int kObjectCount = 2000;
+
+    float SurfaceDistance(const Sphere &sphere, const glm::vec3 &point) {
+        return std::max(0.0f, glm::length(point - sphere.center()) - sphere.radius());
+    }
+}
+
+//small objects in the cells and objects bigger than a cell growing, shrinking and moving between the two :
+//the queries must find the same objects as a brute force search
+int main() {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> small_radius(0.1f, 3.0f);
+    std::uniform_real_distribution<float> large_radius(kCellSize + 1.0f, 40.0f);
+
+    gpr::SpatialGrid grid(kCellSize);
+    std::vector<Sphere> spheres{};
+    std::vector<gpr::SpatialGrid::Handle> handles{};
+    for (int i = 0; i < kObjectCount; i++) {
+        const float radius = i % 50 == 0 ? large_radius(random) : small_radius(random);
+        spheres.emplace_back(glm::vec3(position(random), position(random), position(random)), radius);
+        handles.push_back(grid.Insert(spheres.back(), static_cast<std::uint32_t>(i)));
+    }
+
+    int failures = 0;
+    for (int step = 0; step < 50; step++) {
+        for (int i = step % 7; i < kObjectCount; i += 7) {
+            const float radius = i % 14 == 0 ? (spheres[i].radius() > kCellSize ? small_radius(random)
+                                                                                  : large_radius(random))
+                                             : spheres[i].radius();
+            spheres[i] = Sphere(glm::vec3(position(random), position(random), position(random)), radius);
+            grid.Update(handles[i], spheres[i]);
+        }
+
+        const Sphere query(glm::vec3(position(random), position(random), position(random)), 12.0f);
+        std::vector<gpr::SpatialGrid::Handle> found{};
+        grid.QuerySphere(query, found);
+        std::size_t expected = 0;
+        for (const Sphere &sphere: spheres) {
+            if (glm::length(sphere.center() - query.center()) <= query.radius() + sphere.radius()) {
+                expected++;
+            }
+        }
+        if (found.size() != expected) {
+            std::cerr << "Error while querying the grid : " << found.size() << " objects found, " << expected
+                      << " expected\n";
+            failures++;
+        }
+
+        const glm::vec3 point(position(random), position(random), position(random));
+        const gpr::SpatialGrid::Handle nearest = grid.Nearest(point, 50.0f);
+        float best = 50.0f;
+        for (const Sphere &sphere: spheres) {
+            best = std::min(best, SurfaceDistance(sphere, point));
+        }
+        float distance = 50.0f;
+        if (nearest != gpr::SpatialGrid::kInvalidHandle) {
+            distance = SurfaceDistance(grid.bounds(nearest), point);
+        }
+        if (std::abs(distance - best) > 1e-4f) {
+            std::cerr << "Error while searching the nearest object : " << distance << " instead of " << best << "\n";
+            failures++;
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}